@@ -0,0 +1,248 @@
+#version 330 core
+
+// Modulates the surface texture by the draw color, as the fixed-function
+// GL_MODULATE texture environment of the legacy renderer does. Every body's
+// surface is a layer of one texture array. Lit surfaces are shaded per pixel
+// with the Sun as a white point light: a Lambert term plus the ambient light,
+// which matches the legacy GL_LIGHT0 setup evaluated per vertex.
+//
+// The Sun's light is attenuated by the occluders the CPU listed for the
+// fragment's body: spheres hide part of the Sun's disk, computed as the
+// overlap of two disks of their apparent sizes, and a ring plane lets
+// through the light its disks do not cover. sphereSunVisibility in
+// shadows.cpp is the reference of the sphere test.
+//
+// Transparent commands are drawn with weighted blended order-independent
+// transparency when weightedBlended is set: instead of the color, the
+// fragment writes its premultiplied color and opacity scaled by a weight
+// that falls with its distance to the camera, and the weight alone to the
+// second target. Both targets are summed by additive blending, while the
+// alpha of the first one is multiplied by one minus the opacity, and
+// composite.frag divides the sums to get the average color.
+//
+// The depth is logarithmic: the base-2 logarithm of the distance along the
+// view axis, from 0 at the near plane to 1 at the far plane, so its
+// precision is the same fraction of the distance from a few metres above a
+// planet to the edge of the solar system.
+//
+// Atmospheres are shells around their bodies, drawn from the tables of
+// atmosphere.cpp: the scattering table gives the light scattered towards the
+// camera along the whole ray through the near side of the shell, and the
+// transmittance table reddens the sunlight reaching the surface of a body
+// with an atmosphere.
+
+layout(std140) uniform Frame
+{
+  mat4 view;
+  mat4 projection;
+  // World-space position of the Sun, then the ambient light.
+  vec4 sun;
+  float time;
+  // Inverse of the near plane and of the base-2 logarithm of the depth range.
+  float logDepthNear;
+  float logDepthScale;
+  // Center of every body relative to the floating origin, then its radius.
+  vec4 centers[9];
+};
+
+// Mirrors ShadowReceiver in shadows.h.
+struct ShadowReceiver
+{
+  // World-space center and radius of every occluding sphere.
+  vec4 spheres[4];
+  // Unit normal of the ring plane and its inner radius; all 0 without a ring.
+  vec4 ringPlane;
+  // World-space center of the ring and its outer radius.
+  vec4 ringCenter;
+  int sphereCount;
+};
+
+layout(std140) uniform Shadows
+{
+  ShadowReceiver receivers[9];
+};
+
+const int SUN = 0;
+const int RENDER_FLAG_LIT = 1;
+const int RENDER_FLAG_RING = 2;
+const int RENDER_FLAG_ATMOSPHERE = 4;
+const float PI = 3.14159265;
+
+uniform sampler2DArray surfaces;
+uniform bool weightedBlended;
+
+// Mirror the table sizes in atmosphere.h.
+const vec2 TRANSMITTANCE_SIZE = vec2(64.0, 32.0);
+const vec3 SCATTERING_SIZE = vec3(64.0, 32.0, 16.0);
+
+// Per-body (slot of its atmosphere tables or -1, radius of the top of the
+// atmosphere in body radii).
+uniform vec2 atmospheres[9];
+uniform int atmosphereCount;
+// One transmittance layer per slot.
+uniform sampler2DArray atmosphereTransmittance;
+// The scattering blocks of every slot, stacked along the third axis.
+uniform sampler3D atmosphereScattering;
+
+in vec2 fragTexCoord;
+flat in int fragLayer;
+in vec4 fragTint;
+in vec3 fragPosition;
+in vec3 fragNormal;
+flat in int fragBody;
+flat in int fragFlags;
+flat in vec3 fragCenter;
+in float fragDepth;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec4 fragWeight;
+
+// Fraction of the Sun, of angular radius sunAngle, left visible by a sphere.
+float sphereVisibility(vec3 toSun, float sunDistance, float sunAngle, vec4 sphere)
+{
+  vec3 toOccluder = sphere.xyz - fragPosition;
+  float distance = length(toOccluder);
+  float facing = dot(toOccluder, toSun);
+  if (facing <= 0.0 || distance >= sunDistance || distance <= sphere.w)
+    return 1.0;
+
+  float a = sunAngle;
+  float b = asin(sphere.w / distance);
+  float c = acos(min(facing / distance, 1.0));
+  if (c >= a + b)
+    return 1.0;
+  if (c <= abs(a - b))
+    return b >= a ? 0.0 : 1.0 - (b * b) / (a * a);
+
+  float alpha = acos(clamp((c * c + a * a - b * b) / (2.0 * c * a), -1.0, 1.0));
+  float beta = acos(clamp((c * c + b * b - a * a) / (2.0 * c * b), -1.0, 1.0));
+  float kite = (-c + a + b) * (c + a - b) * (c - a + b) * (c + a + b);
+  float overlap = a * a * alpha + b * b * beta - 0.5 * sqrt(max(kite, 0.0));
+  return max(1.0 - overlap / (PI * a * a), 0.0);
+}
+
+// Fraction of the light let through by a ring, whose disks grow opaque from
+// the inner to the outer edge as their alpha does.
+float ringVisibility(vec3 toSun, ShadowReceiver receiver)
+{
+  vec3 normal = receiver.ringPlane.xyz;
+  float facing = dot(toSun, normal);
+  if (abs(facing) < 1e-4)
+    return 1.0;
+  float t = dot(receiver.ringCenter.xyz - fragPosition, normal) / facing;
+  if (t <= 0.0)
+    return 1.0;
+
+  float inner = receiver.ringPlane.w;
+  float outer = receiver.ringCenter.w;
+  float radius = length(fragPosition + t * toSun - receiver.ringCenter.xyz);
+  if (radius < inner || radius > outer)
+    return 1.0;
+  return 1.0 - (radius - inner) / (outer - inner);
+}
+
+// Fraction of the Sun's light reaching the fragment.
+float sunVisibility()
+{
+  ShadowReceiver receiver = receivers[fragBody];
+  bool ring = (fragFlags & RENDER_FLAG_RING) != 0;
+  if (receiver.sphereCount == 0 && receiver.ringCenter.w == 0.0)
+    return 1.0;
+
+  vec3 toSun = sun.xyz - fragPosition;
+  float sunDistance = length(toSun);
+  toSun /= sunDistance;
+  float sunAngle = asin(min(centers[SUN].w / sunDistance, 1.0));
+
+  float visibility = 1.0;
+  for (int i = 0; i < receiver.sphereCount; ++i)
+    visibility *= sphereVisibility(toSun, sunDistance, sunAngle, receiver.spheres[i]);
+  if (ring)
+    visibility *= sphereVisibility(toSun, sunDistance, sunAngle, vec4(receiver.ringCenter.xyz, centers[fragBody].w));
+  else if (receiver.ringCenter.w > 0.0)
+    visibility *= ringVisibility(toSun, receiver);
+  return visibility;
+}
+
+// Transmittance of an atmosphere from the normalized altitude towards a
+// direction of zenith angle cosine mu.
+vec3 transmittance(int slot, float altitude, float mu)
+{
+  vec2 uv = vec2((mu + 1.0) * 0.5, sqrt(clamp(altitude, 0.0, 1.0)));
+  uv = (0.5 + uv * (TRANSMITTANCE_SIZE - 1.0)) / TRANSMITTANCE_SIZE;
+  return texture(atmosphereTransmittance, vec3(uv, float(slot))).rgb;
+}
+
+// Light scattered towards the camera by the atmosphere of the fragment's
+// body along the camera ray, as a color blended with its alpha. The ray is
+// located by its distance to the center and the direction of the Sun in a
+// frame whose X-axis is the ray and whose Y-axis points from the center to
+// the ray's closest point, as in computeScatteringRow.
+vec4 atmosphereColor()
+{
+  vec3 eye = -transpose(mat3(view)) * view[3].xyz;
+  vec3 direction = normalize(fragPosition - eye);
+  // The table covers the whole ray, so only the near side of the shell is drawn.
+  if (dot(fragPosition - fragCenter, direction) > 0.0)
+    discard;
+
+  int slot = int(atmospheres[fragBody].x);
+  float top = centers[fragBody].w * atmospheres[fragBody].y;
+  vec3 closest = eye + direction * dot(fragCenter - eye, direction) - fragCenter;
+  float distance = length(closest);
+  vec3 up = distance > 0.0 ? closest / distance : normalize(cross(direction, vec3(0.0, 1.0, 0.0)));
+  vec3 side = cross(direction, up);
+  vec3 toSun = normalize(sun.xyz - fragCenter);
+  float nu = dot(toSun, direction);
+  float phi = atan(abs(dot(toSun, side)), dot(toSun, up));
+
+  vec3 uvw = vec3((nu + 1.0) * 0.5, sqrt(max(1.0 - distance / top, 0.0)), phi / PI);
+  uvw = (0.5 + uvw * (SCATTERING_SIZE - 1.0)) / SCATTERING_SIZE;
+  uvw.z = (uvw.z + float(slot)) / float(atmosphereCount);
+  vec4 scattering = texture(atmosphereScattering, uvw);
+
+  // Blending scales the color by alpha, so the scattered light is divided
+  // by it; where the light is brighter than the ray is opaque, the coverage
+  // is raised instead, which dims the body behind slightly more.
+  float alpha = min(max(scattering.a, max(scattering.r, max(scattering.g, scattering.b))), 1.0);
+  return alpha > 0.0 ? vec4(scattering.rgb / alpha, alpha) : vec4(0.0);
+}
+
+void main()
+{
+  gl_FragDepth = log2(max(fragDepth * logDepthNear, 1.0)) * logDepthScale;
+
+  vec4 texel = fragLayer >= 0 ? texture(surfaces, vec3(fragTexCoord, float(fragLayer))) : vec4(1.0);
+  vec4 color = fragTint * texel;
+  if ((fragFlags & RENDER_FLAG_ATMOSPHERE) != 0)
+  {
+    color = atmosphereColor();
+  }
+  else if ((fragFlags & RENDER_FLAG_LIT) != 0)
+  {
+    vec3 toSun = normalize(sun.xyz - fragPosition);
+    vec3 normal = normalize(fragNormal);
+    vec3 diffuse = vec3(max(dot(normal, toSun), 0.0));
+    int slot = int(atmospheres[fragBody].x);
+    if (diffuse.r > 0.0)
+      diffuse *= sunVisibility();
+    if (diffuse.r > 0.0 && slot >= 0)
+      diffuse *= transmittance(slot, 0.0, dot(normal, toSun));
+    color.rgb *= min(sun.w + diffuse, 1.0);
+  }
+  else if ((fragFlags & RENDER_FLAG_RING) != 0)
+  {
+    color.rgb *= max(sunVisibility(), sun.w);
+  }
+
+  if (weightedBlended)
+  {
+    // McGuire and Bavoil's depth weight, with the distance in scene units.
+    float depth = -(view * vec4(fragPosition, 1.0)).z;
+    float weight = color.a * clamp(10.0 / (1e-5 + pow(depth / 5.0, 2.0) + pow(depth / 200.0, 6.0)), 1e-2, 3e3);
+    fragColor = vec4(color.rgb * weight, color.a);
+    fragWeight = vec4(weight);
+    return;
+  }
+  fragColor = color;
+}
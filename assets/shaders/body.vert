@@ -0,0 +1,90 @@
+#version 330 core
+
+// Transforms body, ring and orbit vertices. Every draw is an instance whose
+// model matrix, color, body and texture layer come from the instance buffer.
+// Instances attached to a body are placed here at its center, computed on
+// the CPU for every frame, and turned by its orbital angle, from the
+// per-body parameters in the body buffer and the time of the frame, so the
+// CPU never builds their matrices. The world-space position and normal are
+// passed on for lighting; models only scale uniformly, so the normal matrix
+// is the upper 3x3 of the world matrix. The origin of the world matrix, the
+// center of the body, is passed on for the atmosphere shells, and the
+// distance along the view axis for the logarithmic depth.
+
+layout(std140) uniform Frame
+{
+  mat4 view;
+  mat4 projection;
+  // World-space position of the Sun, then the ambient light.
+  vec4 sun;
+  float time;
+  // Inverse of the near plane and of the base-2 logarithm of the depth range.
+  float logDepthNear;
+  float logDepthScale;
+  // Center of every body relative to the floating origin, then its radius.
+  vec4 centers[9];
+};
+
+const int RENDER_FLAG_RING = 2;
+
+// Per-body (orbit radius, orbit speed, orbit phase, radius).
+uniform samplerBuffer bodies;
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+
+// Body placing the instance, or -1 for world-space geometry.
+layout(location = 3) in int body;
+// Layer of the surface texture array, or -1 for untextured geometry.
+layout(location = 4) in int layer;
+layout(location = 5) in mat4 model;
+layout(location = 9) in vec4 color;
+// Combination of the RenderFlag values.
+layout(location = 10) in int flags;
+
+out vec2 fragTexCoord;
+flat out int fragLayer;
+out vec4 fragTint;
+out vec3 fragPosition;
+out vec3 fragNormal;
+flat out int fragBody;
+flat out int fragFlags;
+flat out vec3 fragCenter;
+out float fragDepth;
+
+mat4 bodyPlacement(int index)
+{
+  vec4 params = texelFetch(bodies, index);
+  float angle = radians(time * params.y + params.z);
+  float c = cos(angle);
+  float s = sin(angle);
+  return mat4(c, 0.0, -s, 0.0,
+              0.0, 1.0, 0.0, 0.0,
+              s, 0.0, c, 0.0,
+              centers[index].xyz, 1.0);
+}
+
+void main()
+{
+  mat4 world = model;
+  if (body >= 0)
+  {
+    mat4 placement = bodyPlacement(body);
+    // Rings keep their orientation in space and only follow the body.
+    if ((flags & RENDER_FLAG_RING) != 0)
+      placement = mat4(vec4(1.0, 0.0, 0.0, 0.0), vec4(0.0, 1.0, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), placement[3]);
+    world = placement * model;
+  }
+  fragTexCoord = texCoord;
+  fragLayer = layer;
+  fragTint = color;
+  vec4 worldPosition = world * vec4(position, 1.0);
+  fragPosition = worldPosition.xyz;
+  fragNormal = mat3(world) * normal;
+  fragBody = body;
+  fragFlags = flags;
+  fragCenter = world[3].xyz;
+  gl_Position = projection * view * worldPosition;
+  fragDepth = gl_Position.w;
+}
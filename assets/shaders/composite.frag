@@ -0,0 +1,26 @@
+#version 330 core
+
+// Resolves the weighted blended transparency targets over the opaque scene.
+// The weighted average of the transparent colors covering a pixel is
+// blended over the scene by the fraction of the scene they hide, one minus
+// the revealage; the result is written with
+// glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA).
+
+// Sum of the weighted premultiplied colors, and the revealage in alpha.
+uniform sampler2D accumulation;
+// Sum of the weights.
+uniform sampler2D weights;
+
+out vec4 fragColor;
+
+void main()
+{
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  vec4 accumulated = texelFetch(accumulation, pixel, 0);
+  float revealage = accumulated.a;
+  if (revealage >= 1.0)
+    discard;
+
+  float weight = texelFetch(weights, pixel, 0).r;
+  fragColor = vec4(accumulated.rgb / max(weight, 1e-5), revealage);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+// Covers the viewport with one triangle built from gl_VertexID, so the
+// transparency resolve needs no vertex buffer.
+
+void main()
+{
+  vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+  gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
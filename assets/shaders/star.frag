@@ -0,0 +1,15 @@
+#version 330 core
+
+// Shades a star's point sprite as a round spot fading to its edge. The
+// result is added to the framebuffer.
+
+in vec3 starColor;
+
+out vec4 fragColor;
+
+void main()
+{
+  vec2 offset = gl_PointCoord * 2.0 - 1.0;
+  float falloff = max(1.0 - dot(offset, offset), 0.0);
+  fragColor = vec4(starColor * falloff, 1.0);
+}
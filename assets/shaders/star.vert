@@ -0,0 +1,38 @@
+#version 330 core
+
+// Places every star of the catalog on a sphere around the camera and sizes
+// its point sprite by magnitude. Stars only follow the rotation of the view,
+// at STARFIELD_RADIUS; the size and brightness match starPointSize and
+// starBrightness in starfield.cpp.
+
+layout(std140) uniform Frame
+{
+  mat4 view;
+  mat4 projection;
+  vec4 sun;
+  float time;
+  // Inverse of the near plane and of the base-2 logarithm of the depth range.
+  float logDepthNear;
+  float logDepthScale;
+  // Center of every body relative to the floating origin, then its radius.
+  vec4 centers[9];
+};
+
+const float STARFIELD_RADIUS = 100.0;
+const float STAR_MAGNITUDE_MIN = -2.0;
+const float STAR_MAGNITUDE_STEP = 0.1;
+
+layout(location = 0) in vec3 direction;
+layout(location = 1) in vec3 color;
+// Encoded magnitude, see encodeStarMagnitude.
+layout(location = 2) in float magnitude;
+
+out vec3 starColor;
+
+void main()
+{
+  float m = STAR_MAGNITUDE_MIN + magnitude * STAR_MAGNITUDE_STEP;
+  gl_PointSize = clamp(4.0 * pow(10.0, -0.2 * (m - 1.0)), 1.0, 6.0);
+  starColor = color * min(pow(10.0, -0.2 * (m - 3.0)), 1.0);
+  gl_Position = projection * vec4(mat3(view) * direction * STARFIELD_RADIUS, 1.0);
+}
@@ -0,0 +1,79 @@
+/**
+ * @file atmosphere_bench.cpp
+ * @brief Microbenchmarks for the atmosphere scattering tables.
+ *
+ * This file measures computing the tables of every atmosphere of the scene
+ * with a growing number of worker threads, and reading them back from a
+ * cache file, which is what every startup after the first one pays.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+#include "atmosphere.h"
+
+/**
+ * @brief Collects the atmospheres of the scene.
+ * @param params Array that receives the atmospheres.
+ * @return The number of atmospheres.
+ */
+static int sceneAtmospheres(AtmosphereParams *params)
+{
+  int count = 0;
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    if (bodyHasAtmosphere(i))
+      params[count++] = ATMOSPHERES[i];
+  }
+  return count;
+}
+
+/**
+ * @brief Measures computing the tables of every atmosphere.
+ * @param state Benchmark state; range(0) is the number of worker threads.
+ */
+static void BM_ComputeAtmosphereTables(benchmark::State &state)
+{
+  AtmosphereParams params[BODY_COUNT];
+  int count = sceneAtmospheres(params);
+  AtmosphereTables tables;
+  for (auto _ : state)
+  {
+    computeAtmosphereTables(params, count, (unsigned int)state.range(0), tables);
+    benchmark::DoNotOptimize(tables.scattering[0]);
+  }
+}
+BENCHMARK(BM_ComputeAtmosphereTables)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * @brief Measures reading the tables of every atmosphere from a cache file.
+ * @param state Benchmark state.
+ */
+static void BM_ReadAtmosphereTables(benchmark::State &state)
+{
+  AtmosphereParams params[BODY_COUNT];
+  int count = sceneAtmospheres(params);
+  uint64_t hash = hashAtmospheres(params, count);
+  const char *filename = "bench_atmosphere.lut";
+  AtmosphereTables tables;
+  computeAtmosphereTables(params, count, 0, tables);
+  if (!writeAtmosphereTables(filename, hash, tables))
+  {
+    state.SkipWithError("failed to write cache");
+    return;
+  }
+
+  for (auto _ : state)
+  {
+    if (!readAtmosphereTables(filename, hash, tables))
+    {
+      state.SkipWithError("failed to read cache");
+      break;
+    }
+    benchmark::DoNotOptimize(tables.scattering[0]);
+  }
+  state.SetBytesProcessed(state.iterations() * (int64_t)(tables.transmittance.size() + tables.scattering.size()) * sizeof(float));
+  remove(filename);
+}
+BENCHMARK(BM_ReadAtmosphereTables)->Unit(benchmark::kMillisecond);
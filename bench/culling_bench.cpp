@@ -0,0 +1,79 @@
+/**
+ * @file culling_bench.cpp
+ * @brief Microbenchmarks for view-frustum culling.
+ *
+ * This file measures testing batches of bounding spheres against the camera
+ * frustum, at sizes from the current scene up to large catalogs and belts.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <stdint.h>
+
+#include "camera.h"
+#include "frustum.h"
+
+/**
+ * @brief Fills a batch with spheres scattered over a disk like an asteroid belt.
+ * @param batch The batch to fill.
+ * @param count Number of spheres to add.
+ */
+static void fillBelt(CullingBatch &batch, int count)
+{
+  clearCullingBatch(batch);
+  uint32_t seed = 12345;
+  for (int i = 0; i < count; ++i)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    float angle = (float)(seed >> 8) * (6.2831853f / 16777216.0f);
+    float radius = 10.0f + (float)(seed % 9000) * 0.01f;
+    Vec3 center = {radius * cosf(angle), (float)((seed >> 4) % 200) * 0.01f - 1.0f, -radius * sinf(angle)};
+    addCullingSphere(batch, center, 0.1f + (float)(seed % 100) * 0.01f);
+  }
+}
+
+/**
+ * @brief Measures extracting the frustum of the default camera.
+ * @param state Benchmark state.
+ */
+static void BM_ExtractFrustum(benchmark::State &state)
+{
+  CameraState camera = initialCameraState();
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  Mat4 viewProjection = mat4Multiply(mat4Perspective(45.0f, 1.25f, 1.0f, 200.0f),
+                                     mat4LookAt(cameraEye(camera), center, up));
+  for (auto _ : state)
+  {
+    Frustum frustum = extractFrustum(viewProjection);
+    benchmark::DoNotOptimize(frustum);
+  }
+}
+BENCHMARK(BM_ExtractFrustum);
+
+/**
+ * @brief Measures culling a batch of spheres against the default camera.
+ * @param state Benchmark state; range(0) is the number of spheres.
+ */
+static void BM_CullSpheres(benchmark::State &state)
+{
+  int count = (int)state.range(0);
+  CullingBatch batch;
+  fillBelt(batch, count);
+
+  CameraState camera = initialCameraState();
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  Frustum frustum = extractFrustum(mat4Multiply(mat4Perspective(45.0f, 1.25f, 1.0f, 200.0f),
+                                                mat4LookAt(cameraEye(camera), center, up)));
+  size_t visible = 0;
+  for (auto _ : state)
+  {
+    visible = cullSpheres(frustum, batch);
+    benchmark::DoNotOptimize(visible);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.counters["visible"] = (double)visible;
+}
+BENCHMARK(BM_CullSpheres)->Arg(27)->Arg(4096)->Arg(100000)->Arg(1000000);
@@ -0,0 +1,119 @@
+/**
+ * @file ephemeris_bench.cpp
+ * @brief Microbenchmarks for the precomputed ephemeris.
+ *
+ * This file measures evaluating the positions of every body of a frame from
+ * the Chebyshev series, next to the closed-form orbits they were fitted to,
+ * and fitting and opening the series, which the first and the following
+ * startups pay.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdio>
+
+#include "bodies.h"
+#include "ephemeris.h"
+#include "simulation.h"
+
+/**
+ * @brief Measures the positions of every body of a frame from the ephemeris.
+ * @param state Benchmark state.
+ */
+static void BM_EphemerisPositions(benchmark::State &state)
+{
+  Ephemeris ephemeris;
+  computeEphemeris(SIMULATION_PERIOD, ephemeris.bodyStorage, ephemeris.coefficientStorage);
+  ephemeris.span = SIMULATION_PERIOD;
+  ephemeris.bodyCount = BODY_COUNT;
+  ephemeris.bodies = &ephemeris.bodyStorage[0];
+  ephemeris.coefficients = &ephemeris.coefficientStorage[0];
+
+  double time = 0.0;
+  for (auto _ : state)
+  {
+    double position[3];
+    for (int i = 0; i < BODY_COUNT; ++i)
+    {
+      ephemerisPosition(ephemeris, i, time, position);
+      benchmark::DoNotOptimize(position[0]);
+    }
+    time = fmod(time + 0.37, SIMULATION_PERIOD);
+  }
+  state.SetItemsProcessed(state.iterations() * BODY_COUNT);
+}
+BENCHMARK(BM_EphemerisPositions);
+
+/**
+ * @brief Measures the positions of every body of a frame from their circular orbits.
+ * @param state Benchmark state.
+ */
+static void BM_ClosedFormPositions(benchmark::State &state)
+{
+  double time = 0.0;
+  for (auto _ : state)
+  {
+    double position[3];
+    for (int i = 0; i < BODY_COUNT; ++i)
+    {
+      double angle = time * BODIES[i].orbitSpeed * 3.14159265358979 / 180.0;
+      position[0] = cos(angle);
+      position[1] = 0.0;
+      position[2] = -sin(angle);
+      benchmark::DoNotOptimize(position[0]);
+      benchmark::DoNotOptimize(position[2]);
+    }
+    time = fmod(time + 0.37, SIMULATION_PERIOD);
+  }
+  state.SetItemsProcessed(state.iterations() * BODY_COUNT);
+}
+BENCHMARK(BM_ClosedFormPositions);
+
+/**
+ * @brief Measures fitting the series of every body over the simulation period.
+ * @param state Benchmark state.
+ */
+static void BM_ComputeEphemeris(benchmark::State &state)
+{
+  std::vector<EphemerisSegments> bodies;
+  std::vector<double> coefficients;
+  for (auto _ : state)
+  {
+    computeEphemeris(SIMULATION_PERIOD, bodies, coefficients);
+    benchmark::DoNotOptimize(coefficients[0]);
+  }
+}
+BENCHMARK(BM_ComputeEphemeris)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Measures opening the ephemeris from a cache file.
+ * @param state Benchmark state.
+ */
+static void BM_OpenEphemeris(benchmark::State &state)
+{
+  const char *filename = "bench_ephemeris.eph";
+  uint64_t hash = hashEphemeris(SIMULATION_PERIOD);
+  std::vector<EphemerisSegments> bodies;
+  std::vector<double> coefficients;
+  computeEphemeris(SIMULATION_PERIOD, bodies, coefficients);
+  if (!writeEphemeris(filename, hash, SIMULATION_PERIOD, bodies, coefficients))
+  {
+    state.SkipWithError("failed to write cache");
+    return;
+  }
+
+  Ephemeris ephemeris;
+  for (auto _ : state)
+  {
+    if (!openEphemeris(filename, hash, ephemeris))
+    {
+      state.SkipWithError("failed to open cache");
+      break;
+    }
+    benchmark::DoNotOptimize(ephemeris.coefficients);
+    closeEphemeris(ephemeris);
+  }
+  remove(filename);
+}
+BENCHMARK(BM_OpenEphemeris);
@@ -0,0 +1,71 @@
+/**
+ * @file geometry_bench.cpp
+ * @brief Microbenchmarks for mesh generation.
+ *
+ * This file measures the tessellation routines used for celestial bodies,
+ * orbits and Saturn's rings at the resolutions used by the renderer.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "geometry.h"
+
+/**
+ * @brief Measures sphere tessellation.
+ * @param state Benchmark state; range(0) is the number of slices, with half
+ *              as many stacks.
+ */
+static void BM_BuildSphere(benchmark::State &state)
+{
+  int slices = (int)state.range(0);
+  Mesh mesh;
+  for (auto _ : state)
+  {
+    buildSphere(1.0f, slices, slices / 2, mesh);
+    benchmark::DoNotOptimize(mesh.vertices.data());
+  }
+  state.SetItemsProcessed(state.iterations() * (int64_t)(mesh.vertices.size() / MESH_VERTEX_FLOATS));
+}
+BENCHMARK(BM_BuildSphere)->Arg(36)->Arg(72)->Arg(256);
+
+/**
+ * @brief Measures orbit generation.
+ * @param state Benchmark state; range(0) is the number of segments.
+ */
+static void BM_BuildOrbit(benchmark::State &state)
+{
+  int segments = (int)state.range(0);
+  std::vector<float> vertices;
+  for (auto _ : state)
+  {
+    buildOrbit(40.0f, segments, vertices);
+    benchmark::DoNotOptimize(vertices.data());
+  }
+  state.SetItemsProcessed(state.iterations() * segments);
+}
+BENCHMARK(BM_BuildOrbit)->Arg(360)->Arg(4096);
+
+/**
+ * @brief Measures Saturn's ring mesh: 25 disks of 64 slices and 64 loops.
+ * @param state Benchmark state.
+ */
+static void BM_BuildSaturnRing(benchmark::State &state)
+{
+  const int numDisks = 25;
+  const float innerRadius = 0.85f * 1.2f;
+  const float outerRadius = 0.85f * 2.0f;
+  float radiusStep = (outerRadius - innerRadius) / numDisks;
+
+  Mesh mesh;
+  for (auto _ : state)
+  {
+    for (int i = 0; i < numDisks; ++i)
+    {
+      float inner = innerRadius + i * radiusStep + (i % 2 == 0 ? 0.5f : 0.0f);
+      buildDisk(inner, inner + radiusStep, 64, 64, mesh);
+      benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numDisks);
+}
+BENCHMARK(BM_BuildSaturnRing);
@@ -0,0 +1,63 @@
+/**
+ * @file picking_bench.cpp
+ * @brief Microbenchmarks for ray-cast picking.
+ *
+ * This file measures casting a ray through the center of the window against
+ * batches of bounding spheres, at sizes from the current scene up to large
+ * belts.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <stdint.h>
+
+#include "camera.h"
+#include "picking.h"
+
+/**
+ * @brief Fills a batch with spheres scattered over a disk like an asteroid belt.
+ * @param batch The batch to fill.
+ * @param count Number of spheres to add.
+ */
+static void fillBelt(CullingBatch &batch, int count)
+{
+  clearCullingBatch(batch);
+  uint32_t seed = 12345;
+  for (int i = 0; i < count; ++i)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    float angle = (float)(seed >> 8) * (6.2831853f / 16777216.0f);
+    float radius = 10.0f + (float)(seed % 9000) * 0.01f;
+    Vec3 center = {radius * cosf(angle), (float)((seed >> 4) % 200) * 0.01f - 1.0f, -radius * sinf(angle)};
+    addCullingSphere(batch, center, 0.1f + (float)(seed % 100) * 0.01f);
+  }
+}
+
+/**
+ * @brief Measures picking a batch of spheres through the center of the
+ *        default camera's view.
+ * @param state Benchmark state; range(0) is the number of spheres.
+ */
+static void BM_PickSpheres(benchmark::State &state)
+{
+  int count = (int)state.range(0);
+  CullingBatch batch;
+  fillBelt(batch, count);
+
+  CameraState camera = initialCameraState();
+  camera.angleY = 0.3f;
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  Mat4 projection = mat4Perspective(45.0f, 1.25f, 1.0f, 200.0f);
+  PickRay ray = pickRay(mat4LookAt(cameraEye(camera), center, up), projection, 0.0f, 0.0f, 0.005f);
+  size_t index = 0;
+  for (auto _ : state)
+  {
+    bool hit = pickSpheres(batch, ray, index);
+    benchmark::DoNotOptimize(hit);
+    benchmark::DoNotOptimize(index);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PickSpheres)->Arg(9)->Arg(4096)->Arg(100000)->Arg(1000000);
@@ -0,0 +1,75 @@
+/**
+ * @file render_queue_bench.cpp
+ * @brief Microbenchmarks for the render command queue.
+ *
+ * This file measures submitting and radix-sorting frames of render commands
+ * at sizes from the current scene up to large catalogs.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "render_queue.h"
+
+/**
+ * @brief Fills a queue with a deterministic mix of opaque and transparent commands.
+ * @param queue The queue to fill.
+ * @param count Number of commands to submit.
+ * @param materials Number of distinct materials among the commands.
+ */
+static void fillQueue(RenderQueue &queue, int count, int materials)
+{
+  clearRenderQueue(queue);
+  uint32_t seed = 12345;
+  RenderCommand command;
+  command.body = -1;
+  command.model = mat4Identity();
+  command.mesh = 0;
+  command.color[0] = command.color[1] = command.color[2] = command.color[3] = 1.0f;
+  command.flags = RENDER_FLAG_LIT;
+  for (int i = 0; i < count; ++i)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    RenderPass pass = (seed >> 28) < 3 ? RENDER_PASS_TRANSPARENT : RENDER_PASS_OPAQUE;
+    command.texture = 1 + (seed >> 8) % materials;
+    command.key = makeRenderKey(pass, command.texture, (float)(seed % 20000) * 0.01f);
+    submitRenderCommand(queue, command);
+  }
+}
+
+/**
+ * @brief Measures sorting a frame of commands.
+ * @param state Benchmark state; range(0) is the number of commands.
+ */
+static void BM_SortRenderQueue(benchmark::State &state)
+{
+  int count = (int)state.range(0);
+  RenderQueue queue;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    fillQueue(queue, count, 16);
+    state.ResumeTiming();
+    sortRenderQueue(queue);
+    benchmark::DoNotOptimize(queue.order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SortRenderQueue)->Arg(64)->Arg(4096)->Arg(100000);
+
+/**
+ * @brief Measures submitting and sorting a frame of commands.
+ * @param state Benchmark state; range(0) is the number of commands.
+ */
+static void BM_SubmitAndSortRenderQueue(benchmark::State &state)
+{
+  int count = (int)state.range(0);
+  RenderQueue queue;
+  for (auto _ : state)
+  {
+    fillQueue(queue, count, 16);
+    sortRenderQueue(queue);
+    benchmark::DoNotOptimize(queue.order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SubmitAndSortRenderQueue)->Arg(64)->Arg(4096)->Arg(100000);
@@ -0,0 +1,195 @@
+/**
+ * @file starfield_bench.cpp
+ * @brief Microbenchmarks for the star catalog and the starfield.
+ *
+ * This file measures opening catalogs of the size of Hipparcos and of Gaia
+ * subsets, querying their spatial index for the stars in view, and drawing
+ * them with both backends into an offscreen framebuffer of a headless
+ * context. Draws are skipped when no context can be created. Like the
+ * application, the benchmark binary expects to be run from the bin
+ * directory.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "camera.h"
+#include "headless_context.h"
+#include "renderer.h"
+#include "star_catalog.h"
+#include "star_index.h"
+
+/**
+ * @brief Writes a procedural catalog for a benchmark.
+ * @param count Number of stars.
+ * @param filename Buffer that receives the path of the catalog.
+ * @param size Size of the buffer.
+ * @return True if the catalog was written.
+ */
+static bool writeBenchCatalog(size_t count, char *filename, size_t size)
+{
+  snprintf(filename, size, "bench_stars_%lu.catalog", (unsigned long)count);
+  std::vector<Star> stars;
+  generateStarfield(count, 1, stars);
+  return writeStarCatalog(filename, stars, defaultStarCellLevel(count));
+}
+
+/**
+ * @brief Measures opening and closing a catalog.
+ * @param state Benchmark state; range(0) is the number of stars.
+ */
+static void BM_OpenStarCatalog(benchmark::State &state)
+{
+  char filename[64];
+  if (!writeBenchCatalog((size_t)state.range(0), filename, sizeof(filename)))
+  {
+    state.SkipWithError("failed to write catalog");
+    return;
+  }
+
+  StarCatalog catalog;
+  for (auto _ : state)
+  {
+    openStarCatalog(filename, catalog);
+    benchmark::DoNotOptimize(starCellEnd(catalog, 0, 6.0f));
+    closeStarCatalog(catalog);
+  }
+  remove(filename);
+}
+BENCHMARK(BM_OpenStarCatalog)->Arg(120000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Measures finding the stars in view of the default camera.
+ * @param state Benchmark state; range(0) is the number of stars.
+ *
+ * The time covers the quadtree query and the binary searches that bound
+ * every visible cell at the magnitude limit of the initial camera distance;
+ * the label gives the number of cells and stars found.
+ */
+static void BM_QueryStarIndex(benchmark::State &state)
+{
+  char filename[64];
+  StarCatalog catalog;
+  if (!writeBenchCatalog((size_t)state.range(0), filename, sizeof(filename)) || !openStarCatalog(filename, catalog))
+  {
+    state.SkipWithError("failed to write catalog");
+    return;
+  }
+
+  StarIndex index;
+  buildStarIndex(index, catalog.level);
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  Mat4 view = mat4LookAt(cameraEye(initialCameraState()), center, up);
+  view.m[12] = view.m[13] = view.m[14] = 0.0f;
+  Frustum frustum = extractFrustum(mat4Multiply(mat4Perspective(45.0f, 1.25f, 1.0f, RENDER_DEPTH_RANGE), view));
+  float limit = starMagnitudeLimit(initialCameraState().distance, CAMERA_MIN_DISTANCE);
+
+  size_t stars = 0;
+  for (auto _ : state)
+  {
+    queryStarIndex(index, frustum, STARFIELD_RADIUS);
+    stars = 0;
+    for (size_t i = 0; i < index.cells.size(); ++i)
+      stars += starCellEnd(catalog, index.cells[i], limit) - starCellBegin(catalog, index.cells[i]);
+    benchmark::DoNotOptimize(stars);
+  }
+  state.SetLabel(std::to_string(index.cells.size()) + " of " + std::to_string(catalog.cellCount) + " cells, " +
+                 std::to_string(stars) + " stars");
+  closeStarCatalog(catalog);
+  remove(filename);
+}
+BENCHMARK(BM_QueryStarIndex)->Arg(120000)->Arg(1000000)->Arg(4000000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Measures drawing a starfield into a 1280x720 framebuffer.
+ * @param state Benchmark state; range(0) is the number of stars and range(1)
+ *              the `RendererBackend`.
+ *
+ * The frame is finished before the next one starts, so the time covers the
+ * GPU work as well as the query and the calls.
+ */
+static void BM_DrawStarfield(benchmark::State &state)
+{
+  static bool hasContext = createHeadlessContext(2, 1, false);
+  if (!hasContext)
+  {
+    state.SkipWithError("no headless OpenGL context");
+    return;
+  }
+
+  char filename[64];
+  if (!writeBenchCatalog((size_t)state.range(0), filename, sizeof(filename)))
+  {
+    state.SkipWithError("failed to write catalog");
+    return;
+  }
+
+  GLuint framebuffer, colorBuffer;
+  glGenRenderbuffers(1, &colorBuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 1280, 720);
+  glGenFramebuffers(1, &framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  Renderer renderer;
+  renderer.backend = (RendererBackend)state.range(1);
+  renderer.bodyParams.assign(BODY_COUNT, BodyParams());
+  renderer.time = 0.0f;
+  renderer.lighting = false;
+  renderer.sunPosition = center;
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    renderer.centers[i] = center;
+    renderer.scales[i] = 1.0f;
+    renderer.orbitRadii[i] = 0.0f;
+    clearShadowReceiver(renderer.shadows[i]);
+  }
+  renderer.projection = mat4Perspective(45.0f, 1280.0f / 720.0f, 1.0f, RENDER_DEPTH_RANGE);
+  glViewport(0, 0, 1280, 720);
+
+  Mat4 view = mat4LookAt(cameraEye(initialCameraState()), center, up);
+
+  bool ready = renderer.backend == RENDERER_CORE ? initCoreBackend(renderer) : true;
+  if (ready && renderer.backend == RENDERER_LEGACY)
+  {
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(renderer.projection.m);
+    glMatrixMode(GL_MODELVIEW);
+  }
+  if (!ready || !initStarfield(renderer, filename))
+  {
+    state.SkipWithError("failed to set up the starfield");
+  }
+  else
+  {
+    if (renderer.backend == RENDERER_CORE)
+      updateCoreFrame(renderer, view);
+    for (auto _ : state)
+    {
+      glClear(GL_COLOR_BUFFER_BIT);
+      drawStarfield(renderer, view, starMagnitudeLimit(initialCameraState().distance, CAMERA_MIN_DISTANCE));
+      glFinish();
+    }
+    glDeleteBuffers(1, &renderer.starfield.vertexBuffer);
+    closeStarCatalog(renderer.starfield.catalog);
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteFramebuffers(1, &framebuffer);
+  glDeleteRenderbuffers(1, &colorBuffer);
+  remove(filename);
+}
+BENCHMARK(BM_DrawStarfield)
+    ->Args({120000, RENDERER_LEGACY})
+    ->Args({1000000, RENDERER_LEGACY})
+    ->Args({120000, RENDERER_CORE})
+    ->Args({1000000, RENDERER_CORE})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
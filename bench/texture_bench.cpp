@@ -0,0 +1,112 @@
+/**
+ * @file texture_bench.cpp
+ * @brief Microbenchmarks for texture decoding and upload.
+ *
+ * This file measures decoding the body textures with STB image and uploading
+ * decoded pixels to OpenGL, one texture at a time or as a whole texture
+ * pack. Uploads run in a headless context and are
+ * skipped when none can be created. Like the application, the benchmark
+ * binary expects to be run from the bin directory.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "headless_context.h"
+#include "texture_loader.h"
+#include "texture_pack.h"
+#include "textures.h"
+
+/**
+ * @var benchmarkTextures
+ * @brief Textures exercised by the decode and upload benchmarks.
+ */
+static const char *benchmarkTextures[] = {MERCURY_TEXTURE, EARTH_TEXTURE, JUPITER_TEXTURE, SATURN_RING_TEXTURE};
+
+/**
+ * @brief Measures decoding a texture file.
+ * @param state Benchmark state; range(0) indexes `benchmarkTextures`.
+ */
+static void BM_DecodeTexture(benchmark::State &state)
+{
+  const char *filename = benchmarkTextures[state.range(0)];
+  state.SetLabel(filename);
+  int64_t bytes = 0;
+  for (auto _ : state)
+  {
+    Image image;
+    if (!decodeImage(filename, image))
+    {
+      state.SkipWithError("failed to decode texture");
+      break;
+    }
+    bytes += (int64_t)image.width * image.height * image.channels;
+    freeImage(image);
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_DecodeTexture)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Measures uploading a decoded texture, mipmap generation included.
+ * @param state Benchmark state; range(0) indexes `benchmarkTextures`.
+ */
+static void BM_UploadTexture(benchmark::State &state)
+{
+  static bool hasContext = createHeadlessContext(2, 1, false);
+  if (!hasContext)
+  {
+    state.SkipWithError("no headless OpenGL context");
+    return;
+  }
+
+  const char *filename = benchmarkTextures[state.range(0)];
+  state.SetLabel(filename);
+  Image image;
+  if (!decodeImage(filename, image))
+  {
+    state.SkipWithError("failed to decode texture");
+    return;
+  }
+
+  for (auto _ : state)
+  {
+    GLuint texture = uploadTexture(image);
+    glFinish();
+    glDeleteTextures(1, &texture);
+  }
+  state.SetBytesProcessed(state.iterations() * (int64_t)image.width * image.height * image.channels);
+  freeImage(image);
+}
+BENCHMARK(BM_UploadTexture)->DenseRange(0, 3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * @brief Measures uploading a texture pack as one array texture.
+ * @param state Benchmark state; range(0) is the number of 1024x512 RGB layers.
+ */
+static void BM_UploadTexturePack(benchmark::State &state)
+{
+  static bool hasContext = createHeadlessContext(2, 1, false);
+  if (!hasContext)
+  {
+    state.SkipWithError("no headless OpenGL context");
+    return;
+  }
+
+  TexturePack pack;
+  pack.width = 1024;
+  pack.height = 512;
+  pack.layers = (int)state.range(0);
+  pack.channels = 3;
+  pack.pixels.resize((size_t)pack.width * pack.height * pack.layers * pack.channels);
+  for (size_t i = 0; i < pack.pixels.size(); ++i)
+    pack.pixels[i] = (unsigned char)(i * 2654435761u >> 24);
+
+  for (auto _ : state)
+  {
+    GLuint texture = uploadTexturePack(pack);
+    glFinish();
+    glDeleteTextures(1, &texture);
+  }
+  state.SetBytesProcessed(state.iterations() * (int64_t)pack.pixels.size());
+}
+BENCHMARK(BM_UploadTexturePack)->Arg(1)->Arg(9)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,80 @@
+/**
+ * @file transform_bench.cpp
+ * @brief Microbenchmarks for transform math.
+ *
+ * This file measures the matrix operations that make up the per-frame
+ * transform work: building the camera matrices and the model matrix of every
+ * body.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+#include "transform.h"
+
+/**
+ * @brief Measures a single 4x4 matrix multiplication.
+ * @param state Benchmark state.
+ */
+static void BM_Mat4Multiply(benchmark::State &state)
+{
+  Mat4 a = mat4Rotate(30.0f, 0.0f, 1.0f, 0.0f);
+  Mat4 b = mat4Translate(11.0f, 0.0f, 0.0f);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(b);
+    Mat4 r = mat4Multiply(a, b);
+    benchmark::DoNotOptimize(r);
+  }
+}
+BENCHMARK(BM_Mat4Multiply);
+
+/**
+ * @brief Measures building the camera matrices of one frame.
+ * @param state Benchmark state.
+ */
+static void BM_CameraMatrices(benchmark::State &state)
+{
+  float angleX = 0.3f, angleY = 0.2f, distance = 50.0f;
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(angleX);
+    Vec3 eye = {distance * cosf(angleY) * sinf(angleX), distance * sinf(angleY), distance * cosf(angleY) * cosf(angleX)};
+    Mat4 viewProjection = mat4Multiply(mat4Perspective(45.0f, 1.25f, 1.0f, 200.0f), mat4LookAt(eye, center, up));
+    benchmark::DoNotOptimize(viewProjection);
+  }
+}
+BENCHMARK(BM_CameraMatrices);
+
+/**
+ * @brief Measures building the model matrices of a number of orbiting bodies.
+ * @param state Benchmark state; range(0) is the number of bodies.
+ *
+ * Each body performs the same transform chain as `drawPlanet`: an orbital
+ * rotation, a translation to the orbit radius and the pole alignment of the
+ * sphere.
+ */
+static void BM_BodyModelMatrices(benchmark::State &state)
+{
+  int count = (int)state.range(0);
+  std::vector<Mat4> models(count);
+  Mat4 poleAlignment = mat4Rotate(90.0f, 1.0f, 0.0f, 0.0f);
+  float rotationAngle = 123.0f;
+  for (auto _ : state)
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      float orbitRadius = 5.0f + i * 0.01f;
+      float orbitSpeed = 4.0f / (1.0f + i * 0.001f);
+      Mat4 orbit = mat4Multiply(mat4Rotate(rotationAngle * orbitSpeed, 0.0f, 1.0f, 0.0f), mat4Translate(orbitRadius, 0.0f, 0.0f));
+      models[i] = mat4Multiply(orbit, poleAlignment);
+    }
+    benchmark::DoNotOptimize(models.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BodyModelMatrices)->Arg(9)->Arg(1024)->Arg(100000);
@@ -0,0 +1,430 @@
+/**
+ * @file atmosphere.cpp
+ * @brief Implements the precomputed scattering tables of planetary atmospheres.
+ *
+ * Only single scattering is computed: sunlight attenuated on its way to a
+ * point of the ray, scattered once towards the camera, and attenuated again
+ * on its way out. The integrals use the midpoint rule, with the sunlight's
+ * attenuation read back from the transmittance table as the shader would.
+ */
+
+#include "atmosphere.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "hash.h"
+
+/**
+ * @var ATMOSPHERES
+ * @brief Atmosphere of every body, indexed by `BodyIndex`.
+ *
+ * Earth's optical depths are the real ones; the shells are several times
+ * thicker than real atmospheres so that they show at the scale of the
+ * scene. Venus is wrapped in a thick yellowish haze, the gas giants in paler
+ * hazes, and methane tints Uranus and Neptune by absorbing red light.
+ */
+const AtmosphereParams ATMOSPHERES[BODY_COUNT] = {
+    {0.0f, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+    {0.0f, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+    {0.08f, {0.03f, 0.04f, 0.06f}, 0.3f, 0.15f, 0.3f, 0.7f, 12.0f},
+    {0.06f, {0.046f, 0.108f, 0.265f}, 0.2f, 0.02f, 0.05f, 0.76f, 16.0f},
+    {0.0f, {0.0f, 0.0f, 0.0f}, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+    {0.04f, {0.03f, 0.05f, 0.09f}, 0.3f, 0.1f, 0.3f, 0.6f, 12.0f},
+    {0.04f, {0.04f, 0.05f, 0.07f}, 0.3f, 0.1f, 0.3f, 0.6f, 12.0f},
+    {0.05f, {0.04f, 0.12f, 0.16f}, 0.3f, 0.02f, 0.2f, 0.6f, 14.0f},
+    {0.05f, {0.03f, 0.08f, 0.25f}, 0.3f, 0.02f, 0.2f, 0.6f, 14.0f}};
+
+/**
+ * @var ATMOSPHERE_MAGIC
+ * @brief First bytes of every cache file.
+ */
+static const char ATMOSPHERE_MAGIC[4] = {'S', 'A', 'T', 'M'};
+
+/**
+ * @def ATMOSPHERE_STEPS
+ * @brief Number of integration steps along a ray.
+ */
+#define ATMOSPHERE_STEPS 64
+
+/**
+ * @def MIE_EXTINCTION
+ * @brief Ratio of the Mie extinction to the Mie scattering; aerosols also absorb.
+ */
+#define MIE_EXTINCTION 1.11f
+
+/**
+ * @brief Returns the size of one transmittance layer.
+ * @return The number of floats of the layer.
+ */
+static size_t transmittanceFloats()
+{
+  return (size_t)ATMOSPHERE_TRANSMITTANCE_WIDTH * ATMOSPHERE_TRANSMITTANCE_HEIGHT * 3;
+};
+
+/**
+ * @brief Returns the size of one scattering block.
+ * @return The number of floats of the block.
+ */
+static size_t scatteringFloats()
+{
+  return (size_t)ATMOSPHERE_SCATTERING_WIDTH * ATMOSPHERE_SCATTERING_HEIGHT * ATMOSPHERE_SCATTERING_DEPTH * 4;
+};
+
+/**
+ * @struct Coefficients
+ * @brief Scattering coefficients of an atmosphere, per planet radius.
+ */
+struct Coefficients
+{
+  float top;            ///< Radius of the top of the atmosphere.
+  float rayleigh[3];    ///< Rayleigh scattering at the ground.
+  float rayleighHeight; ///< Rayleigh scale height.
+  float mie;            ///< Mie scattering at the ground.
+  float mieHeight;      ///< Mie scale height.
+};
+
+/**
+ * @brief Derives the scattering coefficients of an atmosphere from its
+ *        vertical optical depths.
+ * @param params The atmosphere.
+ * @return Its coefficients.
+ */
+static Coefficients atmosphereCoefficients(const AtmosphereParams &params)
+{
+  Coefficients coefficients;
+  coefficients.top = 1.0f + params.thickness;
+  coefficients.rayleighHeight = params.rayleighScaleHeight * params.thickness;
+  coefficients.mieHeight = params.mieScaleHeight * params.thickness;
+  float rayleighColumn = coefficients.rayleighHeight * (1.0f - expf(-params.thickness / coefficients.rayleighHeight));
+  float mieColumn = coefficients.mieHeight * (1.0f - expf(-params.thickness / coefficients.mieHeight));
+  for (int c = 0; c < 3; ++c)
+    coefficients.rayleigh[c] = params.rayleighDepth[c] / rayleighColumn;
+  coefficients.mie = params.mieDepth / mieColumn;
+  return coefficients;
+};
+
+/**
+ * @brief Adds the extinction of a point of an atmosphere to an optical depth.
+ * @param coefficients The atmosphere.
+ * @param radius Distance of the point from the planet's center.
+ * @param length Length of the path through the point.
+ * @param depth RGB optical depth to add to.
+ * @param rayleigh Receives the Rayleigh density of the point, or NULL.
+ * @param mie Receives the Mie density of the point, or NULL.
+ */
+static void addExtinction(const Coefficients &coefficients, float radius, float length, float depth[3], float *rayleigh, float *mie)
+{
+  float altitude = std::max(radius - 1.0f, 0.0f);
+  float rayleighDensity = expf(-altitude / coefficients.rayleighHeight);
+  float mieDensity = expf(-altitude / coefficients.mieHeight);
+  for (int c = 0; c < 3; ++c)
+    depth[c] += (coefficients.rayleigh[c] * rayleighDensity + coefficients.mie * MIE_EXTINCTION * mieDensity) * length;
+  if (rayleigh)
+    *rayleigh = rayleighDensity;
+  if (mie)
+    *mie = mieDensity;
+};
+
+/**
+ * @brief Computes the transmittance layer of an atmosphere.
+ * @param coefficients The atmosphere.
+ * @param layer The layer's texels, RGB.
+ *
+ * Texel `(x, y)` holds the transmittance from a point at altitude
+ * `(y / (height - 1))^2` times the thickness to the top of the atmosphere,
+ * towards a direction whose zenith angle cosine is `2 x / (width - 1) - 1`.
+ * Directions that hit the planet transmit nothing.
+ */
+static void computeTransmittance(const Coefficients &coefficients, float *layer)
+{
+  float thickness = coefficients.top - 1.0f;
+  for (int y = 0; y < ATMOSPHERE_TRANSMITTANCE_HEIGHT; ++y)
+  {
+    float v = (float)y / (ATMOSPHERE_TRANSMITTANCE_HEIGHT - 1);
+    float radius = 1.0f + v * v * thickness;
+    for (int x = 0; x < ATMOSPHERE_TRANSMITTANCE_WIDTH; ++x)
+    {
+      float mu = 2.0f * x / (ATMOSPHERE_TRANSMITTANCE_WIDTH - 1) - 1.0f;
+      float *texel = &layer[3 * (y * ATMOSPHERE_TRANSMITTANCE_WIDTH + x)];
+      float ground = radius * radius * (mu * mu - 1.0f) + 1.0f;
+      if (mu < 0.0f && ground >= 0.0f)
+      {
+        texel[0] = texel[1] = texel[2] = 0.0f;
+        continue;
+      }
+
+      float length = -radius * mu + sqrtf(std::max(radius * radius * (mu * mu - 1.0f) + coefficients.top * coefficients.top, 0.0f));
+      float step = length / ATMOSPHERE_STEPS;
+      float depth[3] = {0.0f, 0.0f, 0.0f};
+      for (int i = 0; i < ATMOSPHERE_STEPS; ++i)
+      {
+        float t = (i + 0.5f) * step;
+        float sampleRadius = sqrtf(radius * radius + 2.0f * radius * mu * t + t * t);
+        addExtinction(coefficients, sampleRadius, step, depth, NULL, NULL);
+      }
+      for (int c = 0; c < 3; ++c)
+        texel[c] = expf(-depth[c]);
+    }
+  }
+};
+
+/**
+ * @brief Reads a transmittance layer with bilinear filtering.
+ * @param coefficients The atmosphere.
+ * @param layer The layer's texels.
+ * @param radius Distance of the point from the planet's center.
+ * @param mu Cosine of the Sun's zenith angle at the point.
+ * @param result Receives the RGB transmittance.
+ */
+static void lookupTransmittance(const Coefficients &coefficients, const float *layer, float radius, float mu, float result[3])
+{
+  float altitude = std::min(std::max((radius - 1.0f) / (coefficients.top - 1.0f), 0.0f), 1.0f);
+  float x = (std::min(std::max(mu, -1.0f), 1.0f) + 1.0f) * 0.5f * (ATMOSPHERE_TRANSMITTANCE_WIDTH - 1);
+  float y = sqrtf(altitude) * (ATMOSPHERE_TRANSMITTANCE_HEIGHT - 1);
+  int x0 = std::min((int)x, ATMOSPHERE_TRANSMITTANCE_WIDTH - 2);
+  int y0 = std::min((int)y, ATMOSPHERE_TRANSMITTANCE_HEIGHT - 2);
+  float fx = x - x0;
+  float fy = y - y0;
+  const float *t00 = &layer[3 * (y0 * ATMOSPHERE_TRANSMITTANCE_WIDTH + x0)];
+  const float *t10 = t00 + 3;
+  const float *t01 = t00 + 3 * ATMOSPHERE_TRANSMITTANCE_WIDTH;
+  const float *t11 = t01 + 3;
+  for (int c = 0; c < 3; ++c)
+    result[c] = (t00[c] * (1.0f - fx) + t10[c] * fx) * (1.0f - fy) + (t01[c] * (1.0f - fx) + t11[c] * fx) * fy;
+};
+
+/**
+ * @brief Computes one row of the scattering block of an atmosphere.
+ * @param params The atmosphere.
+ * @param coefficients Its coefficients.
+ * @param transmittance Its transmittance layer.
+ * @param y Row of the block: the distance from the ray to the center is
+ *          `1 - (y / (height - 1))^2` times the radius of the top.
+ * @param block The block's texels, RGBA.
+ *
+ * The ray runs along the X-axis, passing closest to the center at
+ * `(0, distance, 0)`, and is cut short by the ground if it hits the planet.
+ * Since the Sun is infinitely far, the scattering angle is the same along
+ * the whole ray, and the phase functions are applied once per texel. The
+ * alpha of a texel is one minus the mean transmittance of the ray.
+ */
+static void computeScatteringRow(const AtmosphereParams &params, const Coefficients &coefficients, const float *transmittance, int y, float *block)
+{
+  const float pi = 3.14159265358979f;
+  float u = (float)y / (ATMOSPHERE_SCATTERING_HEIGHT - 1);
+  float distance = (1.0f - u * u) * coefficients.top;
+  float half = sqrtf(std::max(coefficients.top * coefficients.top - distance * distance, 0.0f));
+  float start = -half;
+  float end = distance < 1.0f ? -sqrtf(1.0f - distance * distance) : half;
+  float step = (end - start) / ATMOSPHERE_STEPS;
+  float g = params.mieAnisotropy;
+
+  for (int z = 0; z < ATMOSPHERE_SCATTERING_DEPTH; ++z)
+  {
+    float phi = pi * z / (ATMOSPHERE_SCATTERING_DEPTH - 1);
+    for (int x = 0; x < ATMOSPHERE_SCATTERING_WIDTH; ++x)
+    {
+      float nu = 2.0f * x / (ATMOSPHERE_SCATTERING_WIDTH - 1) - 1.0f;
+      float sine = sqrtf(std::max(1.0f - nu * nu, 0.0f));
+      float sun[3] = {nu, sine * cosf(phi), sine * sinf(phi)};
+      float rayleighPhase = 3.0f / (16.0f * pi) * (1.0f + nu * nu);
+      float miePhase = (1.0f - g * g) / (4.0f * pi * powf(1.0f + g * g - 2.0f * g * nu, 1.5f));
+
+      float depth[3] = {0.0f, 0.0f, 0.0f};
+      float light[3] = {0.0f, 0.0f, 0.0f};
+      for (int i = 0; i < ATMOSPHERE_STEPS; ++i)
+      {
+        float t = start + (i + 0.5f) * step;
+        float radius = sqrtf(t * t + distance * distance);
+        float rayleigh, mie;
+        float before[3] = {depth[0], depth[1], depth[2]};
+        addExtinction(coefficients, radius, 0.5f * step, before, &rayleigh, &mie);
+        addExtinction(coefficients, radius, step, depth, NULL, NULL);
+
+        float sunlight[3];
+        lookupTransmittance(coefficients, transmittance, radius, (t * sun[0] + distance * sun[1]) / radius, sunlight);
+        for (int c = 0; c < 3; ++c)
+        {
+          float scattering = coefficients.rayleigh[c] * rayleigh * rayleighPhase + coefficients.mie * mie * miePhase;
+          light[c] += expf(-before[c]) * sunlight[c] * scattering * step;
+        }
+      }
+
+      float *texel = &block[4 * ((z * ATMOSPHERE_SCATTERING_HEIGHT + y) * ATMOSPHERE_SCATTERING_WIDTH + x)];
+      for (int c = 0; c < 3; ++c)
+        texel[c] = light[c] * params.sunIntensity;
+      texel[3] = 1.0f - (expf(-depth[0]) + expf(-depth[1]) + expf(-depth[2])) / 3.0f;
+    }
+  }
+};
+
+/**
+ * @brief Tells whether a body has an atmosphere.
+ * @param index Index of the body.
+ * @return True if the body's atmosphere has a thickness.
+ */
+bool bodyHasAtmosphere(int index)
+{
+  return index >= 0 && index < BODY_COUNT && ATMOSPHERES[index].thickness > 0.0f;
+};
+
+/**
+ * @brief Hashes a set of atmospheres together with the table sizes.
+ * @param params The atmospheres.
+ * @param count Number of atmospheres.
+ * @return The 64-bit FNV-1a hash identifying their tables.
+ *
+ * The version and sizes are hashed first, so changing the integration or
+ * the resolution of the tables invalidates the cache like changing an
+ * atmosphere does.
+ */
+uint64_t hashAtmospheres(const AtmosphereParams *params, int count)
+{
+  const int sizes[7] = {ATMOSPHERE_CACHE_VERSION, ATMOSPHERE_STEPS, ATMOSPHERE_TRANSMITTANCE_WIDTH, ATMOSPHERE_TRANSMITTANCE_HEIGHT,
+                        ATMOSPHERE_SCATTERING_WIDTH, ATMOSPHERE_SCATTERING_HEIGHT, ATMOSPHERE_SCATTERING_DEPTH};
+  return fnv1a(params, count * sizeof(AtmosphereParams), fnv1a(sizes, sizeof(sizes)));
+};
+
+/**
+ * @brief Computes the tables of a set of atmospheres.
+ * @param params The atmospheres.
+ * @param count Number of atmospheres.
+ * @param threads Number of worker threads; 0 uses one per hardware thread.
+ * @param tables The tables that receive the result.
+ *
+ * Work is handed out one layer or one row at a time through an atomic
+ * counter, so the workers stay busy whatever the number of atmospheres.
+ */
+void computeAtmosphereTables(const AtmosphereParams *params, int count, unsigned int threads, AtmosphereTables &tables)
+{
+  tables.count = count;
+  tables.transmittance.assign(transmittanceFloats() * count, 0.0f);
+  tables.scattering.assign(scatteringFloats() * count, 0.0f);
+  if (count <= 0)
+    return;
+
+  std::vector<Coefficients> coefficients(count);
+  for (int i = 0; i < count; ++i)
+    coefficients[i] = atmosphereCoefficients(params[i]);
+
+  if (threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  std::atomic<int> nextLayer(0);
+  std::atomic<int> nextRow(0);
+  int rows = count * ATMOSPHERE_SCATTERING_HEIGHT;
+  std::vector<std::thread> workers;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (unsigned int w = 0; w < threads; ++w)
+    {
+      workers.push_back(std::thread([&, pass]() {
+        if (pass == 0)
+        {
+          for (int layer = nextLayer++; layer < count; layer = nextLayer++)
+            computeTransmittance(coefficients[layer], &tables.transmittance[transmittanceFloats() * layer]);
+          return;
+        }
+        for (int row = nextRow++; row < rows; row = nextRow++)
+        {
+          int layer = row / ATMOSPHERE_SCATTERING_HEIGHT;
+          computeScatteringRow(params[layer], coefficients[layer], &tables.transmittance[transmittanceFloats() * layer],
+                               row % ATMOSPHERE_SCATTERING_HEIGHT, &tables.scattering[scatteringFloats() * layer]);
+        }
+      }));
+    }
+    for (size_t w = 0; w < workers.size(); ++w)
+      workers[w].join();
+    workers.clear();
+  }
+};
+
+/**
+ * @brief Writes tables to a cache file.
+ * @param filename Path to the cache file.
+ * @param hash Hash of the atmospheres, see `hashAtmospheres`.
+ * @param tables The tables to write.
+ * @return True if the file was written successfully.
+ */
+bool writeAtmosphereTables(const char *filename, uint64_t hash, const AtmosphereTables &tables)
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  uint32_t header[2] = {ATMOSPHERE_CACHE_VERSION, (uint32_t)tables.count};
+  file.write(ATMOSPHERE_MAGIC, sizeof(ATMOSPHERE_MAGIC));
+  file.write((const char *)header, sizeof(header));
+  file.write((const char *)&hash, sizeof(hash));
+  if (!tables.transmittance.empty())
+    file.write((const char *)&tables.transmittance[0], tables.transmittance.size() * sizeof(float));
+  if (!tables.scattering.empty())
+    file.write((const char *)&tables.scattering[0], tables.scattering.size() * sizeof(float));
+  return (bool)file;
+};
+
+/**
+ * @brief Reads tables from a cache file.
+ * @param filename Path to the cache file.
+ * @param hash Hash the file must have been written with.
+ * @param tables The tables that receive the contents of the file.
+ * @return True if the file exists, matches the hash and has the expected size.
+ */
+bool readAtmosphereTables(const char *filename, uint64_t hash, AtmosphereTables &tables)
+{
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file)
+    return false;
+  std::streamoff fileSize = file.tellg();
+  file.seekg(0);
+
+  char magic[4];
+  uint32_t header[2];
+  uint64_t fileHash = 0;
+  file.read(magic, sizeof(magic));
+  file.read((char *)header, sizeof(header));
+  file.read((char *)&fileHash, sizeof(fileHash));
+  if (!file || memcmp(magic, ATMOSPHERE_MAGIC, sizeof(magic)) != 0 || header[0] != ATMOSPHERE_CACHE_VERSION || fileHash != hash)
+    return false;
+
+  size_t transmittance = transmittanceFloats() * header[1];
+  size_t scattering = scatteringFloats() * header[1];
+  if ((uint64_t)fileSize != sizeof(magic) + sizeof(header) + sizeof(fileHash) + (transmittance + scattering) * sizeof(float))
+    return false;
+
+  tables.count = (int)header[1];
+  tables.transmittance.resize(transmittance);
+  tables.scattering.resize(scattering);
+  if (transmittance)
+    file.read((char *)&tables.transmittance[0], transmittance * sizeof(float));
+  if (scattering)
+    file.read((char *)&tables.scattering[0], scattering * sizeof(float));
+  return (bool)file;
+};
+
+/**
+ * @brief Reads the tables of a set of atmospheres from the cache, or
+ *        computes and caches them.
+ * @param params The atmospheres.
+ * @param count Number of atmospheres.
+ * @param tables The tables that receive the result.
+ */
+void loadAtmosphereTables(const AtmosphereParams *params, int count, AtmosphereTables &tables)
+{
+  uint64_t hash = hashAtmospheres(params, count);
+  char filename[256];
+  snprintf(filename, sizeof(filename), "%s/atmosphere-%016llx.lut", ATMOSPHERE_CACHE_DIRECTORY, (unsigned long long)hash);
+  if (readAtmosphereTables(filename, hash, tables) && tables.count == count)
+    return;
+
+  computeAtmosphereTables(params, count, 0, tables);
+  if (!writeAtmosphereTables(filename, hash, tables))
+    std::cerr << "Failed to cache the atmosphere tables: " << filename << std::endl;
+};
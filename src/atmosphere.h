@@ -0,0 +1,182 @@
+/**
+ * @file atmosphere.h
+ * @brief Declares the precomputed scattering tables of planetary atmospheres.
+ *
+ * Atmospheres are drawn from two lookup tables per body instead of being
+ * integrated per pixel. The transmittance table stores how much sunlight
+ * reaches a point of the atmosphere, by altitude and cosine of the Sun's
+ * zenith angle; the core fragment shader also reads it to redden the light
+ * reaching the surface near the terminator. The scattering table stores the
+ * light scattered towards the camera along a whole ray crossing the
+ * atmosphere, by the ray's distance to the planet's center and the direction
+ * of the Sun relative to the ray, with the Rayleigh and Mie phase functions
+ * applied. Seen from outside the atmosphere, these three numbers determine a
+ * ray completely, so drawing an atmosphere costs one texture fetch per pixel.
+ *
+ * Lengths are measured in planet radii, and each atmosphere is described by
+ * its vertical optical depths rather than by physical coefficients, so the
+ * shells can be made thicker than they are in reality and still look right
+ * at the scale of the scene.
+ *
+ * The tables are computed once at startup on worker threads and written to
+ * a cache file named after a hash of the parameters and table sizes; later
+ * runs read the file instead. A cache file starts with the 4-byte magic
+ * `SATM`, followed by the version and the atmosphere count as 32-bit
+ * unsigned integers and the hash as a 64-bit unsigned integer, in
+ * little-endian order, then the transmittance and scattering tables as
+ * 32-bit floats.
+ */
+
+#ifndef ATMOSPHERE_H
+#define ATMOSPHERE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "bodies.h"
+
+/**
+ * @def ATMOSPHERE_CACHE_DIRECTORY
+ * @brief Directory the scattering tables are cached in.
+ *
+ * It holds the other generated assets and is not part of the sources.
+ */
+#define ATMOSPHERE_CACHE_DIRECTORY "../assets/packs"
+
+/**
+ * @def ATMOSPHERE_CACHE_VERSION
+ * @brief Version of the cache file format and of the integration, part of the hash.
+ */
+#define ATMOSPHERE_CACHE_VERSION 1
+
+/**
+ * @def ATMOSPHERE_TRANSMITTANCE_WIDTH
+ * @brief Number of Sun zenith angle cosines in the transmittance table, from -1 to 1.
+ */
+#define ATMOSPHERE_TRANSMITTANCE_WIDTH 64
+
+/**
+ * @def ATMOSPHERE_TRANSMITTANCE_HEIGHT
+ * @brief Number of altitudes in the transmittance table, denser near the ground.
+ */
+#define ATMOSPHERE_TRANSMITTANCE_HEIGHT 32
+
+/**
+ * @def ATMOSPHERE_SCATTERING_WIDTH
+ * @brief Number of cosines of the angle between the ray and the Sun in the
+ *        scattering table, from -1 to 1.
+ */
+#define ATMOSPHERE_SCATTERING_WIDTH 64
+
+/**
+ * @def ATMOSPHERE_SCATTERING_HEIGHT
+ * @brief Number of distances from the ray to the planet's center in the
+ *        scattering table, denser near the top of the atmosphere.
+ */
+#define ATMOSPHERE_SCATTERING_HEIGHT 32
+
+/**
+ * @def ATMOSPHERE_SCATTERING_DEPTH
+ * @brief Number of angles of the Sun around the ray in the scattering
+ *        table, from 0 to 180 degrees.
+ */
+#define ATMOSPHERE_SCATTERING_DEPTH 16
+
+/**
+ * @struct AtmosphereParams
+ * @brief Optical description of an atmosphere, in units of the planet's radius.
+ */
+struct AtmosphereParams
+{
+  float thickness;           ///< Height of the top of the atmosphere above the surface; 0 for bodies without one.
+  float rayleighDepth[3];    ///< Vertical optical depth of the Rayleigh scattering, for red, green and blue.
+  float rayleighScaleHeight; ///< Scale height of the Rayleigh density, as a fraction of the thickness.
+  float mieDepth;            ///< Vertical optical depth of the Mie scattering, the same for every color.
+  float mieScaleHeight;      ///< Scale height of the Mie density, as a fraction of the thickness.
+  float mieAnisotropy;       ///< Asymmetry factor of the Mie phase function.
+  float sunIntensity;        ///< Factor applied to the scattered light.
+};
+
+/**
+ * @var ATMOSPHERES
+ * @brief Atmosphere of every body, indexed by `BodyIndex`.
+ */
+extern const AtmosphereParams ATMOSPHERES[BODY_COUNT];
+
+/**
+ * @struct AtmosphereTables
+ * @brief Lookup tables of a set of atmospheres, kept in CPU memory.
+ *
+ * Every atmosphere has a transmittance layer of
+ * `ATMOSPHERE_TRANSMITTANCE_WIDTH` by `ATMOSPHERE_TRANSMITTANCE_HEIGHT` RGB
+ * texels and a scattering block of `ATMOSPHERE_SCATTERING_WIDTH` by
+ * `ATMOSPHERE_SCATTERING_HEIGHT` by `ATMOSPHERE_SCATTERING_DEPTH` RGBA
+ * texels. A scattering texel holds the light scattered towards the camera,
+ * then the fraction of the background the ray hides.
+ */
+struct AtmosphereTables
+{
+  int count;                        ///< Number of atmospheres.
+  std::vector<float> transmittance; ///< Transmittance layers, one after the other.
+  std::vector<float> scattering;    ///< Scattering blocks, one after the other.
+};
+
+/**
+ * @brief Tells whether a body has an atmosphere.
+ * @param index Index of the body.
+ * @return True if the body's atmosphere has a thickness.
+ */
+bool bodyHasAtmosphere(int index);
+
+/**
+ * @brief Hashes a set of atmospheres together with the table sizes.
+ * @param params The atmospheres.
+ * @param count Number of atmospheres.
+ * @return The 64-bit FNV-1a hash identifying their tables.
+ */
+uint64_t hashAtmospheres(const AtmosphereParams *params, int count);
+
+/**
+ * @brief Computes the tables of a set of atmospheres.
+ * @param params The atmospheres.
+ * @param count Number of atmospheres.
+ * @param threads Number of worker threads; 0 uses one per hardware thread.
+ * @param tables The tables that receive the result.
+ *
+ * The transmittance layers are computed first, since single scattering
+ * reads them, then the rows of every scattering block are handed out to
+ * the workers.
+ */
+void computeAtmosphereTables(const AtmosphereParams *params, int count, unsigned int threads, AtmosphereTables &tables);
+
+/**
+ * @brief Writes tables to a cache file.
+ * @param filename Path to the cache file.
+ * @param hash Hash of the atmospheres, see `hashAtmospheres`.
+ * @param tables The tables to write.
+ * @return True if the file was written successfully.
+ */
+bool writeAtmosphereTables(const char *filename, uint64_t hash, const AtmosphereTables &tables);
+
+/**
+ * @brief Reads tables from a cache file.
+ * @param filename Path to the cache file.
+ * @param hash Hash the file must have been written with.
+ * @param tables The tables that receive the contents of the file.
+ * @return True if the file exists, matches the hash and has the expected size.
+ */
+bool readAtmosphereTables(const char *filename, uint64_t hash, AtmosphereTables &tables);
+
+/**
+ * @brief Reads the tables of a set of atmospheres from the cache, or
+ *        computes and caches them.
+ * @param params The atmospheres.
+ * @param count Number of atmospheres.
+ * @param tables The tables that receive the result.
+ *
+ * The cache file lives in `ATMOSPHERE_CACHE_DIRECTORY`. A file that cannot
+ * be written only costs the computation again at the next startup.
+ */
+void loadAtmosphereTables(const AtmosphereParams *params, int count, AtmosphereTables &tables);
+
+#endif // ATMOSPHERE_H
@@ -0,0 +1,348 @@
+/**
+ * @file benchmark_runner.cpp
+ * @brief Implements the deterministic benchmark mode.
+ *
+ * This file provides the benchmark script, the GLUT idle driver that plays it
+ * frame by frame and the JSON report writer used to publish the measured
+ * frame times.
+ */
+
+#include "benchmark_runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+/**
+ * @var benchmarkScript
+ * @brief Scenes played by the running benchmark.
+ */
+static std::vector<BenchmarkScene> benchmarkScript;
+
+/**
+ * @var benchmarkResults
+ * @brief Frame times collected for the scenes played so far.
+ */
+static std::vector<BenchmarkResult> benchmarkResults;
+
+/**
+ * @var benchmarkScene
+ * @brief Scene driven by the running benchmark.
+ */
+static SceneState *benchmarkScene = 0;
+
+/**
+ * @var benchmarkRenderFrame
+ * @brief Function used to render and present one frame.
+ */
+static void (*benchmarkRenderFrame)() = 0;
+
+/**
+ * @var benchmarkRenderStats
+ * @brief Counters of the last rendered frame, or 0 if not available.
+ */
+static const RenderStats *benchmarkRenderStats = 0;
+
+/**
+ * @var benchmarkReportPath
+ * @brief Path of the JSON report written at the end of the run.
+ */
+static std::string benchmarkReportPath;
+
+/**
+ * @var benchmarkWarmupFrames
+ * @brief Number of unmeasured frames rendered before each scene.
+ */
+static int benchmarkWarmupFrames = 0;
+
+/**
+ * @var benchmarkMeasuredFrames
+ * @brief Number of measured frames rendered for each scene.
+ */
+static int benchmarkMeasuredFrames = 0;
+
+/**
+ * @var benchmarkSceneIndex
+ * @brief Index of the scene currently being played.
+ */
+static size_t benchmarkSceneIndex = 0;
+
+/**
+ * @var benchmarkFrameIndex
+ * @brief Index of the current frame within the scene, warm-up included.
+ */
+static int benchmarkFrameIndex = 0;
+
+/**
+ * @brief Returns the default benchmark script.
+ * @return The ordered list of scenes played by the benchmark mode.
+ *
+ * The camera values match the ones reachable interactively: the overview
+ * starts at the initial distance of 50 units, close-ups use the distance of
+ * 10 units set by the number keys and the zoom sweep covers the whole range
+ * allowed by the zoom controls.
+ */
+std::vector<BenchmarkScene> defaultBenchmarkScript()
+{
+  std::vector<BenchmarkScene> script;
+
+  BenchmarkScene overview = {"overview", -1, false, 50.0f, 50.0f, 0.0f, 0.0f, 0.3f};
+  script.push_back(overview);
+
+  BenchmarkScene overviewOrbits = {"overview_orbits", -1, true, 50.0f, 50.0f, 0.0f, 0.0f, 0.3f};
+  script.push_back(overviewOrbits);
+
+  BenchmarkScene cameraOrbit = {"camera_orbit", -1, true, 50.0f, 50.0f, 0.0f, 6.2832f, 0.3f};
+  script.push_back(cameraOrbit);
+
+  BenchmarkScene zoomIn = {"zoom_in", -1, false, 100.0f, 5.0f, 0.5f, 0.5f, 0.2f};
+  script.push_back(zoomIn);
+
+  BenchmarkScene zoomOut = {"zoom_out_orbits", -1, true, 5.0f, 100.0f, 0.5f, 0.5f, 0.2f};
+  script.push_back(zoomOut);
+
+  static const char *elementNames[] = {"sun", "mercury", "venus", "earth", "mars", "jupiter", "saturn", "uranus", "neptune"};
+  for (int i = 0; i < 9; ++i)
+  {
+    BenchmarkScene element = {elementNames[i], i, false, 10.0f, 10.0f, 0.0f, 0.0f, 0.2f};
+    script.push_back(element);
+  }
+
+  return script;
+};
+
+/**
+ * @brief Returns the statistics of a scene before any frame is measured.
+ * @param name Name of the scene.
+ * @return A result with no frame times and every counter at zero.
+ */
+BenchmarkResult makeBenchmarkResult(const std::string &name)
+{
+  BenchmarkResult result;
+  result.name = name;
+  result.commands = 0;
+  result.drawCalls = 0;
+  result.culled = 0;
+  result.stars = 0;
+  result.starfieldGpuMs = 0.0;
+  result.bodiesGpuMs = 0.0;
+  return result;
+};
+
+/**
+ * @brief Applies the scripted state of the current frame.
+ * @param scene The scene being played.
+ * @param frame Index of the frame within the scene, warm-up included.
+ *
+ * Warm-up frames hold the camera at its start values; measured frames move it
+ * linearly towards the end values. The animation angle is derived from the
+ * frame index rather than from wall-clock time so that runs are reproducible.
+ */
+static void applyBenchmarkFrame(const BenchmarkScene &scene, int frame)
+{
+  float t = 0.0f;
+  int measuredFrame = frame - benchmarkWarmupFrames;
+  if (measuredFrame > 0 && benchmarkMeasuredFrames > 1)
+    t = (float)measuredFrame / (float)(benchmarkMeasuredFrames - 1);
+
+  benchmarkScene->selectedElement = scene.selectedElement;
+  benchmarkScene->showOrbits = scene.showOrbits;
+  benchmarkScene->camera.distance = scene.startDistance + (scene.endDistance - scene.startDistance) * t;
+  benchmarkScene->camera.angleX = scene.startAngleX + (scene.endAngleX - scene.startAngleX) * t;
+  benchmarkScene->camera.angleY = scene.angleY;
+  benchmarkScene->simulation.rotationAngle = frame * SIMULATION_STEP;
+};
+
+/**
+ * @brief Renders and measures one benchmark frame.
+ *
+ * This function is registered as the GLUT idle callback while the benchmark
+ * runs. The measured time spans the whole frame, from issuing the draw calls
+ * to the GPU finishing them, so that driver and GPU costs are included.
+ */
+static void benchmarkIdle()
+{
+  const BenchmarkScene &scene = benchmarkScript[benchmarkSceneIndex];
+  applyBenchmarkFrame(scene, benchmarkFrameIndex);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  benchmarkRenderFrame();
+  glFinish();
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+  if (benchmarkFrameIndex >= benchmarkWarmupFrames)
+  {
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    BenchmarkResult &result = benchmarkResults.back();
+    result.frameMs.push_back(ms);
+    if (benchmarkRenderStats)
+    {
+      result.commands += benchmarkRenderStats->commands;
+      result.drawCalls += benchmarkRenderStats->drawCalls;
+      result.culled += benchmarkRenderStats->bodiesCulled + benchmarkRenderStats->ringsCulled + benchmarkRenderStats->orbitsCulled;
+      result.stars += benchmarkRenderStats->stars;
+      result.starfieldGpuMs += benchmarkRenderStats->starfieldGpuMs;
+      result.bodiesGpuMs += benchmarkRenderStats->bodiesGpuMs;
+    }
+  }
+
+  if (++benchmarkFrameIndex < benchmarkWarmupFrames + benchmarkMeasuredFrames)
+    return;
+
+  benchmarkFrameIndex = 0;
+  if (++benchmarkSceneIndex < benchmarkScript.size())
+  {
+    benchmarkResults.push_back(makeBenchmarkResult(benchmarkScript[benchmarkSceneIndex].name));
+    return;
+  }
+
+  bool written = writeBenchmarkReport(benchmarkReportPath.c_str(), benchmarkResults, benchmarkWarmupFrames,
+                                      glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+  exit(written ? 0 : 1);
+};
+
+/**
+ * @brief Starts the benchmark mode.
+ * @param scene The scene driven by the benchmark script.
+ * @param renderFrame Function that renders and presents one frame.
+ * @param renderStats Counters filled by the renderer for every frame, or 0.
+ * @param reportPath Path of the JSON report written when the script ends.
+ * @param warmupFrames Number of unmeasured frames rendered before each scene.
+ * @param measuredFrames Number of measured frames rendered for each scene.
+ */
+void startBenchmark(SceneState &scene, void (*renderFrame)(), const RenderStats *renderStats, const char *reportPath, int warmupFrames, int measuredFrames)
+{
+  benchmarkScript = defaultBenchmarkScript();
+  benchmarkScene = &scene;
+  benchmarkRenderFrame = renderFrame;
+  benchmarkRenderStats = renderStats;
+  benchmarkReportPath = reportPath;
+  benchmarkWarmupFrames = std::max(0, warmupFrames);
+  benchmarkMeasuredFrames = std::max(1, measuredFrames);
+  benchmarkSceneIndex = 0;
+  benchmarkFrameIndex = 0;
+  scene.simulation.paused = true;
+
+  benchmarkResults.clear();
+  benchmarkResults.push_back(makeBenchmarkResult(benchmarkScript[0].name));
+
+  std::cout << "Running benchmark: " << benchmarkScript.size() << " scenes, "
+            << benchmarkWarmupFrames << " warm-up and " << benchmarkMeasuredFrames
+            << " measured frames each\n";
+
+  glutIdleFunc(benchmarkIdle);
+};
+
+/**
+ * @brief Escapes a string for inclusion in a JSON document.
+ * @param text The text to escape.
+ * @return The escaped text, without surrounding quotes.
+ */
+static std::string jsonEscape(const char *text)
+{
+  std::string escaped;
+  for (const char *c = text ? text : ""; *c; ++c)
+  {
+    if (*c == '"' || *c == '\\')
+      escaped += '\\';
+    if ((unsigned char)*c >= 0x20)
+      escaped += *c;
+  }
+  return escaped;
+};
+
+/**
+ * @brief Returns a percentile of a sorted list of frame times.
+ * @param sorted Frame times sorted in ascending order.
+ * @param p The percentile to compute, between 0 and 100.
+ * @return The frame time at the given percentile (nearest rank).
+ */
+static double percentile(const std::vector<double> &sorted, double p)
+{
+  if (sorted.empty())
+    return 0.0;
+  size_t rank = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(rank, sorted.size() - 1)];
+};
+
+/**
+ * @brief Writes the benchmark results to a JSON report.
+ * @param reportPath Path of the report file.
+ * @param results The measured results of every scene.
+ * @param warmupFrames Number of warm-up frames rendered before each scene.
+ * @param width Width of the rendered frames, in pixels.
+ * @param height Height of the rendered frames, in pixels.
+ * @return True if the report was written successfully.
+ *
+ * Besides the per-scene statistics, the report records the OpenGL renderer
+ * and viewport size, so that numbers from different machines are not
+ * compared by mistake. The average number of executed and culled commands
+ * per frame shows how much work frustum culling saved in each scene, the
+ * average number of draw calls how well commands were batched, and the
+ * average number of stars how many the starfield query kept. The average
+ * GPU times of the starfield and of the bodies, measured with timer queries,
+ * split the frame time between the passes and show the cost of lighting; they
+ * read 0 when the context has no timer queries.
+ */
+bool writeBenchmarkReport(const char *reportPath, const std::vector<BenchmarkResult> &results, int warmupFrames,
+                          int width, int height)
+{
+  std::ofstream report(reportPath);
+  if (!report)
+  {
+    std::cerr << "Failed to write benchmark report: " << reportPath << std::endl;
+    return false;
+  }
+
+  report << "{\n";
+  report << "  \"version\": 1,\n";
+  report << "  \"renderer\": \"" << jsonEscape((const char *)glGetString(GL_RENDERER)) << "\",\n";
+  report << "  \"gl_version\": \"" << jsonEscape((const char *)glGetString(GL_VERSION)) << "\",\n";
+  report << "  \"width\": " << width << ",\n";
+  report << "  \"height\": " << height << ",\n";
+  report << "  \"warmup_frames\": " << warmupFrames << ",\n";
+  report << "  \"scenes\": [\n";
+
+  double totalMs = 0.0;
+  size_t totalFrames = 0;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    std::vector<double> sorted = results[i].frameMs;
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (size_t f = 0; f < sorted.size(); ++f)
+      sum += sorted[f];
+    double mean = sorted.empty() ? 0.0 : sum / sorted.size();
+    double frames = sorted.empty() ? 1.0 : (double)sorted.size();
+    totalMs += sum;
+    totalFrames += sorted.size();
+
+    report << "    {\"name\": \"" << jsonEscape(results[i].name.c_str()) << "\""
+           << ", \"frames\": " << sorted.size()
+           << ", \"mean_ms\": " << mean
+           << ", \"median_ms\": " << percentile(sorted, 50.0)
+           << ", \"p95_ms\": " << percentile(sorted, 95.0)
+           << ", \"p99_ms\": " << percentile(sorted, 99.0)
+           << ", \"min_ms\": " << (sorted.empty() ? 0.0 : sorted.front())
+           << ", \"max_ms\": " << (sorted.empty() ? 0.0 : sorted.back())
+           << ", \"fps\": " << (mean > 0.0 ? 1000.0 / mean : 0.0)
+           << ", \"commands\": " << results[i].commands / frames
+           << ", \"draw_calls\": " << results[i].drawCalls / frames
+           << ", \"culled\": " << results[i].culled / frames
+           << ", \"stars\": " << results[i].stars / frames
+           << ", \"gpu_starfield_ms\": " << results[i].starfieldGpuMs / frames
+           << ", \"gpu_bodies_ms\": " << results[i].bodiesGpuMs / frames << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+
+  report << "  ],\n";
+  report << "  \"total_frames\": " << totalFrames << ",\n";
+  report << "  \"mean_ms\": " << (totalFrames ? totalMs / totalFrames : 0.0) << "\n";
+  report << "}\n";
+
+  std::cout << "Benchmark report written to " << reportPath << std::endl;
+  return (bool)report;
+};
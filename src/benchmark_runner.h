@@ -0,0 +1,106 @@
+/**
+ * @file benchmark_runner.h
+ * @brief Deterministic benchmark mode for measuring rendering performance.
+ *
+ * This file declares the types and functions used to play a fixed camera and
+ * selection script, measure the frame times of each scripted scene and write
+ * the results to a JSON report.
+ */
+
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include "render_queue.h"
+#include "scene.h"
+
+/**
+ * @struct BenchmarkScene
+ * @brief A single step of the benchmark script.
+ *
+ * Each scene fixes the selection and orbit visibility and moves the camera
+ * linearly from its start to its end values over the measured frames, so
+ * that every run of the script renders exactly the same sequence of frames.
+ */
+struct BenchmarkScene
+{
+  const char *name;         ///< Name of the scene in the report.
+  int selectedElement;      ///< Selected body, or -1 for the overview.
+  bool showOrbits;          ///< Whether orbital paths are drawn.
+  float startDistance;      ///< Camera distance at the first frame.
+  float endDistance;        ///< Camera distance at the last frame.
+  float startAngleX;        ///< Camera angle around the X-axis at the first frame.
+  float endAngleX;          ///< Camera angle around the X-axis at the last frame.
+  float angleY;             ///< Camera angle around the Y-axis.
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief Frame time statistics measured for one scene.
+ */
+struct BenchmarkResult
+{
+  std::string name;            ///< Name of the measured scene.
+  std::vector<double> frameMs; ///< Individual frame times, in milliseconds.
+  unsigned long commands;      ///< Render commands executed over all measured frames.
+  unsigned long drawCalls;     ///< Draw calls issued over all measured frames.
+  unsigned long culled;        ///< Bodies, rings and orbits culled over all measured frames.
+  unsigned long stars;         ///< Background stars drawn over all measured frames.
+  double starfieldGpuMs;       ///< GPU time of the starfield summed over all measured frames, in milliseconds.
+  double bodiesGpuMs;          ///< GPU time of the render queue summed over all measured frames, in milliseconds.
+};
+
+/**
+ * @brief Returns the default benchmark script.
+ * @return The ordered list of scenes played by the benchmark mode.
+ *
+ * The script covers the overview with orbits hidden and shown, a full camera
+ * orbit, a zoom sweep and a close-up of every selectable celestial body.
+ */
+std::vector<BenchmarkScene> defaultBenchmarkScript();
+
+/**
+ * @brief Returns the statistics of a scene before any frame is measured.
+ * @param name Name of the scene.
+ * @return A result with no frame times and every counter at zero.
+ */
+BenchmarkResult makeBenchmarkResult(const std::string &name);
+
+/**
+ * @brief Starts the benchmark mode.
+ * @param scene The scene driven by the benchmark script.
+ * @param renderFrame Function that renders and presents one frame.
+ * @param renderStats Counters filled by the renderer for every frame, or 0.
+ * @param reportPath Path of the JSON report written when the script ends.
+ * @param warmupFrames Number of unmeasured frames rendered before each scene.
+ * @param measuredFrames Number of measured frames rendered for each scene.
+ *
+ * This function replaces the GLUT idle callback with the benchmark driver.
+ * Every frame applies the scripted camera and selection state to @p scene,
+ * advances the animation by a fixed step, renders through @p renderFrame
+ * and waits for the GPU to finish. Once all scenes have been measured the report is written
+ * and the application exits.
+ */
+void startBenchmark(SceneState &scene, void (*renderFrame)(), const RenderStats *renderStats, const char *reportPath, int warmupFrames = 60, int measuredFrames = 300);
+
+/**
+ * @brief Writes the benchmark results to a JSON report.
+ * @param reportPath Path of the report file.
+ * @param results The measured results of every scene.
+ * @param warmupFrames Number of warm-up frames rendered before each scene.
+ * @param width Width of the rendered frames, in pixels.
+ * @param height Height of the rendered frames, in pixels.
+ * @return True if the report was written successfully.
+ */
+bool writeBenchmarkReport(const char *reportPath, const std::vector<BenchmarkResult> &results, int warmupFrames,
+                          int width, int height);
+
+#endif // BENCHMARK_RUNNER_H
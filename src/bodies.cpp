@@ -0,0 +1,36 @@
+/**
+ * @file bodies.cpp
+ * @brief Defines the catalog of celestial bodies.
+ *
+ * This file builds the `BODIES` table from the constants in planet_radii.h,
+ * orbit_radii.h, planet_speeds.h and textures.h.
+ */
+
+#include "bodies.h"
+
+#include "orbit_radii.h"
+#include "planet_radii.h"
+#include "planet_speeds.h"
+#include "textures.h"
+
+const Body BODIES[BODY_COUNT] = {
+    {"SUN", SUN_TEXTURE, SUN_RADIUS, 0.0f, 1.0f, 0.0f, 0.0f, 695700.0, 0.0},
+    {"MERCURY", MERCURY_TEXTURE, MERCURY_RADIUS, MERCURY_ORBIT_RADIUS, MERCURY_SPEED, 0.0f, 0.0f, 2439.7, 0.387098 * ASTRONOMICAL_UNIT_KM},
+    {"VENUS", VENUS_TEXTURE, VENUS_RADIUS, VENUS_ORBIT_RADIUS, VENUS_SPEED, 0.0f, 0.0f, 6051.8, 0.723332 * ASTRONOMICAL_UNIT_KM},
+    {"EARTH", EARTH_TEXTURE, EARTH_RADIUS, EARTH_ORBIT_RADIUS, EARTH_SPEED, 0.0f, 0.0f, 6371.0, 1.000001 * ASTRONOMICAL_UNIT_KM},
+    {"MARS", MARS_TEXTURE, MARS_RADIUS, MARS_ORBIT_RADIUS, MARS_SPEED, 0.0f, 0.0f, 3389.5, 1.523679 * ASTRONOMICAL_UNIT_KM},
+    {"JUPITER", JUPITER_TEXTURE, JUPITER_RADIUS, JUPITER_ORBIT_RADIUS, JUPITER_SPEED, 0.0f, 0.0f, 69911.0, 5.2044 * ASTRONOMICAL_UNIT_KM},
+    {"SATURN", SATURN_TEXTURE, SATURN_RADIUS, SATURN_ORBIT_RADIUS, SATURN_SPEED, SATURN_RADIUS * 1.2f, SATURN_RADIUS * 2.0f, 58232.0, 9.5826 * ASTRONOMICAL_UNIT_KM},
+    {"URANUS", URANUS_TEXTURE, URANUS_RADIUS, URANUS_ORBIT_RADIUS, URANUS_SPEED, 0.0f, 0.0f, 25362.0, 19.2184 * ASTRONOMICAL_UNIT_KM},
+    {"NEPTUNE", NEPTUNE_TEXTURE, NEPTUNE_RADIUS, NEPTUNE_ORBIT_RADIUS, NEPTUNE_SPEED, 0.0f, 0.0f, 24622.0, 30.07 * ASTRONOMICAL_UNIT_KM},
+};
+
+/**
+ * @brief Tells whether a body has a ring.
+ * @param body The body to check.
+ * @return True if the body has a ring.
+ */
+bool bodyHasRing(const Body &body)
+{
+  return body.outerRingRadius > 0.0f;
+};
@@ -0,0 +1,71 @@
+/**
+ * @file bodies.h
+ * @brief Declares the catalog of celestial bodies.
+ *
+ * This file gathers the radius, orbit, speed and texture of every body into
+ * a single table, indexed the same way as the selection keys (0 for the Sun,
+ * 1 to 8 for the planets), so that simulation and rendering can iterate over
+ * the bodies instead of naming each one.
+ *
+ * Besides the sizes the scene is drawn with, every body has its real radius
+ * and orbit radius, used by the true-scale mode.
+ */
+
+#ifndef BODIES_H
+#define BODIES_H
+
+/**
+ * @def ASTRONOMICAL_UNIT_KM
+ * @brief Length of the astronomical unit, in kilometres.
+ */
+#define ASTRONOMICAL_UNIT_KM 149597870.7
+
+/**
+ * @enum BodyIndex
+ * @brief Index of each celestial body in the `BODIES` table.
+ */
+enum BodyIndex
+{
+  SUN = 0,
+  MERCURY,
+  VENUS,
+  EARTH,
+  MARS,
+  JUPITER,
+  SATURN,
+  URANUS,
+  NEPTUNE,
+  BODY_COUNT
+};
+
+/**
+ * @struct Body
+ * @brief Static description of a celestial body.
+ */
+struct Body
+{
+  const char *name;        ///< Display name of the body.
+  const char *texturePath; ///< Path to the surface texture.
+  float radius;            ///< Radius of the body.
+  float orbitRadius;       ///< Distance of the orbit from the Sun; 0 for the Sun itself.
+  float orbitSpeed;        ///< Orbital speed, as a multiplier of the simulation angle.
+  float innerRingRadius;   ///< Inner radius of the ring, or 0 if the body has none.
+  float outerRingRadius;   ///< Outer radius of the ring, or 0 if the body has none.
+  double trueRadius;       ///< Mean radius of the real body, in kilometres.
+  double trueOrbitRadius;  ///< Semi-major axis of the real orbit, in kilometres.
+};
+
+/**
+ * @var BODIES
+ * @brief Table of all celestial bodies, indexed by `BodyIndex`.
+ */
+extern const Body BODIES[BODY_COUNT];
+
+/**
+ * @brief Tells whether a body has a ring.
+ * @param body The body to check.
+ * @return True if the body has a ring.
+ */
+bool bodyHasRing(const Body &body);
+
+#endif // BODIES_H
@@ -0,0 +1,183 @@
+/**
+ * @file camera.cpp
+ * @brief Implements the orbiting camera.
+ */
+
+#include "camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Returns the initial camera state.
+ * @return A camera 50 units away, looking along the -Z axis.
+ */
+CameraState initialCameraState()
+{
+  CameraState camera;
+  camera.distance = 50.0f;
+  camera.angleX = 0.0f;
+  camera.angleY = 0.0f;
+  return camera;
+};
+
+/**
+ * @brief Computes the position of the camera.
+ * @param camera The camera.
+ * @return The eye position.
+ */
+Vec3 cameraEye(const CameraState &camera)
+{
+  Vec3 eye = {camera.distance * cosf(camera.angleY) * sinf(camera.angleX),
+              camera.distance * sinf(camera.angleY),
+              camera.distance * cosf(camera.angleY) * cosf(camera.angleX)};
+  return eye;
+};
+
+/**
+ * @brief Adjusts the camera zoom level.
+ * @param camera The camera to zoom.
+ * @param out If true, zooms out; otherwise, zooms in.
+ * @param minDistance Closest distance the camera can zoom in to.
+ */
+void zoomCamera(CameraState &camera, bool out, float minDistance)
+{
+  float minAltitude = minDistance * CAMERA_MIN_ALTITUDE_RATIO;
+  float altitude = std::max(camera.distance - minDistance, 0.0f);
+  if (!out)
+  {
+    float step = std::min(1.0f, altitude * CAMERA_ZOOM_RATIO);
+    if (altitude - step >= minAltitude)
+      altitude -= step;
+  }
+  else
+  {
+    altitude += std::min(1.0f, std::max(altitude, minAltitude) * CAMERA_ZOOM_RATIO / (1.0f - CAMERA_ZOOM_RATIO));
+  }
+
+  camera.distance = std::min(minDistance + altitude, CAMERA_MAX_DISTANCE);
+};
+
+/**
+ * @brief Orbits the camera around its target.
+ * @param camera The camera to orbit.
+ * @param dx Horizontal mouse movement, in pixels.
+ * @param dy Vertical mouse movement, in pixels.
+ */
+void orbitCamera(CameraState &camera, int dx, int dy)
+{
+  camera.angleX += dx * 0.005f;
+  camera.angleY += dy * 0.005f;
+
+  // Clamp angleY to prevent excessive vertical rotation
+  if (camera.angleY > CAMERA_MAX_ANGLE_Y)
+    camera.angleY = CAMERA_MAX_ANGLE_Y;
+  if (camera.angleY < -CAMERA_MAX_ANGLE_Y)
+    camera.angleY = -CAMERA_MAX_ANGLE_Y;
+};
+
+/**
+ * @brief Plans the path of a camera flight and starts it.
+ * @param flight The flight.
+ * @param from The camera where the flight starts.
+ * @param to The camera where the flight ends.
+ * @param fromWidth Camera distance at the start, in world units.
+ * @param toWidth Camera distance at the end, in world units.
+ * @param separation Distance from the start point to the target, in world units.
+ *
+ * The path is the optimal one of "Smooth and efficient zooming and panning"
+ * (van Wijk and Nuij, 2003), where the camera distance plays the part of the
+ * view width. It is parameterized by its length, from `pathStart`; a flight
+ * that does not move the target, or barely, only zooms, exponentially.
+ */
+void startCameraFlight(CameraFlight &flight, const CameraState &from, const CameraState &to, double fromWidth,
+                       double toWidth, double separation)
+{
+  const double rho = CAMERA_FLIGHT_RHO;
+  const double pi = 3.14159265358979;
+
+  flight.startWidth = fromWidth;
+  flight.endWidth = toWidth;
+  if (separation < 1e-9 * std::max(fromWidth, toWidth))
+  {
+    flight.separation = 0.0;
+    flight.pathStart = 0.0;
+    flight.pathLength = fabs(log(toWidth / fromWidth)) / rho;
+  }
+  else
+  {
+    double rho2 = rho * rho;
+    double pan = rho2 * rho2 * separation * separation;
+    double zoom = toWidth * toWidth - fromWidth * fromWidth;
+    // ln(-b + sqrt(b^2 + 1)) = -asinh(b), which stays exact for large b.
+    double r0 = -asinh((zoom + pan) / (2.0 * fromWidth * rho2 * separation));
+    double r1 = -asinh((zoom - pan) / (2.0 * toWidth * rho2 * separation));
+    flight.separation = separation;
+    flight.pathStart = r0;
+    flight.pathLength = (r1 - r0) / rho;
+  }
+
+  flight.fromDistance = from.distance;
+  flight.toDistance = to.distance;
+  flight.angleX = (float)remainder((double)from.angleX - to.angleX, 2.0 * pi);
+  flight.angleY = from.angleY - to.angleY;
+  flight.duration = std::min(std::max(CAMERA_FLIGHT_SECONDS_PER_LENGTH * (float)flight.pathLength, CAMERA_FLIGHT_MIN_SECONDS),
+                             CAMERA_FLIGHT_MAX_SECONDS);
+  flight.elapsed = 0.0f;
+  flight.active = true;
+};
+
+/**
+ * @brief Advances a camera flight by some real time.
+ * @param flight The flight.
+ * @param seconds The real time elapsed, in seconds.
+ */
+void advanceCameraFlight(CameraFlight &flight, double seconds)
+{
+  if (!flight.active)
+    return;
+
+  flight.elapsed += (float)seconds;
+  if (flight.elapsed >= flight.duration)
+    flight.active = false;
+};
+
+/**
+ * @brief Returns how far a camera flight has progressed.
+ * @param flight The flight.
+ * @return The smoothstep of the fraction of its duration elapsed, so the
+ *         camera starts and stops without a jolt.
+ */
+double cameraFlightProgress(const CameraFlight &flight)
+{
+  if (!flight.active)
+    return 1.0;
+
+  double t = std::min(std::max((double)flight.elapsed / flight.duration, 0.0), 1.0);
+  return t * t * (3.0 - 2.0 * t);
+};
+
+/**
+ * @brief Evaluates the path of a camera flight.
+ * @param flight The flight.
+ * @param progress Progress along the flight.
+ * @param fraction Receives the fraction of the way to the target.
+ * @param width Receives the camera distance, in world units.
+ */
+void cameraFlightPath(const CameraFlight &flight, double progress, double &fraction, double &width)
+{
+  const double rho = CAMERA_FLIGHT_RHO;
+
+  if (flight.separation == 0.0)
+  {
+    fraction = progress;
+    width = flight.startWidth * pow(flight.endWidth / flight.startWidth, progress);
+    return;
+  }
+
+  double r0 = flight.pathStart;
+  double r = r0 + rho * flight.pathLength * progress;
+  double w0 = flight.startWidth;
+  fraction = w0 / (rho * rho) * (cosh(r0) * tanh(r) - sinh(r0)) / flight.separation;
+  width = w0 * cosh(r0) / cosh(r);
+};
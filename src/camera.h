@@ -0,0 +1,204 @@
+/**
+ * @file camera.h
+ * @brief Declares the orbiting camera.
+ *
+ * This file declares the camera state and the operations applied to it by
+ * the input handlers: orbiting around the target and zooming in or out.
+ *
+ * Selecting another body starts a flight of the camera towards it. The path
+ * is planned once, when the flight starts, and only evaluated for every
+ * frame: it follows the zoom-and-pan trajectory of van Wijk and Nuij, which
+ * pulls back to keep both ends in view and moves at a constant perceived
+ * speed even when the camera distance changes by orders of magnitude, as it
+ * does in the true-scale mode. The path is expressed as a fraction of the way
+ * from the start point to the target and a camera distance, so the renderer
+ * can apply it to bodies that keep moving during the flight.
+ */
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "transform.h"
+
+/**
+ * @def CAMERA_MIN_DISTANCE
+ * @brief Closest distance the camera can zoom in to when the renderer's
+ *        near plane is 1 unit away.
+ */
+#define CAMERA_MIN_DISTANCE 5.0f
+
+/**
+ * @def CAMERA_MAX_DISTANCE
+ * @brief Farthest distance the camera can zoom out to.
+ */
+#define CAMERA_MAX_DISTANCE 100.0f
+
+/**
+ * @def CAMERA_ZOOM_RATIO
+ * @brief Largest fraction of the altitude above the closest distance that
+ *        one zoom step removes.
+ */
+#define CAMERA_ZOOM_RATIO 0.2f
+
+/**
+ * @def CAMERA_MIN_ALTITUDE_RATIO
+ * @brief Smallest altitude above the closest distance that zooming in
+ *        reaches, as a fraction of the closest distance.
+ *
+ * Zoom steps are proportional to the altitude, so without this floor a
+ * camera at the closest distance could not zoom out again.
+ */
+#define CAMERA_MIN_ALTITUDE_RATIO 1e-5f
+
+/**
+ * @def CAMERA_MAX_ANGLE_Y
+ * @brief Largest vertical camera angle, in radians, in either direction.
+ */
+#define CAMERA_MAX_ANGLE_Y 1.5f
+
+/**
+ * @def CAMERA_FLIGHT_RHO
+ * @brief Trade-off between zooming and panning along a flight path; larger
+ *        values pull the camera further back.
+ */
+#define CAMERA_FLIGHT_RHO 1.4
+
+/**
+ * @def CAMERA_FLIGHT_SECONDS_PER_LENGTH
+ * @brief Duration of a flight per unit of the length of its path.
+ */
+#define CAMERA_FLIGHT_SECONDS_PER_LENGTH 0.3f
+
+/**
+ * @def CAMERA_FLIGHT_MIN_SECONDS
+ * @brief Duration of the shortest flights, in seconds.
+ */
+#define CAMERA_FLIGHT_MIN_SECONDS 1.0f
+
+/**
+ * @def CAMERA_FLIGHT_MAX_SECONDS
+ * @brief Duration of the longest flights, in seconds.
+ */
+#define CAMERA_FLIGHT_MAX_SECONDS 4.0f
+
+/**
+ * @struct CameraState
+ * @brief Camera orbiting around the origin.
+ */
+struct CameraState
+{
+  float distance; ///< Distance of the camera from the target.
+  float angleX;   ///< Horizontal angle around the target, in radians.
+  float angleY;   ///< Vertical angle above the orbital plane, in radians.
+};
+
+/**
+ * @struct CameraFlight
+ * @brief Flight of the camera from where it was towards a new target.
+ *
+ * World units are scene units, or kilometres in the true-scale mode. The
+ * camera state of the scene holds the end of the flight, so inputs during
+ * the flight act on where it arrives.
+ */
+struct CameraFlight
+{
+  bool active;         ///< Whether the camera is flying.
+  float elapsed;       ///< Real time since the flight started, in seconds.
+  float duration;      ///< Real time the flight lasts, in seconds.
+  int fromBody;        ///< Body the start point moves with.
+  DVec3 fromOffset;    ///< Start point relative to that body, in world units.
+  float fromDistance;  ///< Camera distance at the start, in render units.
+  float toDistance;    ///< Camera distance the flight was planned to end at, in render units.
+  float angleX;        ///< Horizontal angle at the start minus the one at the end, within [-pi, pi].
+  float angleY;        ///< Vertical angle at the start minus the one at the end.
+  double separation;   ///< Distance from the start point to the target when the flight started, in world units.
+  double startWidth;   ///< Camera distance at the start, in world units.
+  double endWidth;     ///< Camera distance at the end, in world units.
+  double pathStart;    ///< Parameter of the path at its start.
+  double pathLength;   ///< Length of the path, the zoom and the pan together.
+};
+
+/**
+ * @brief Returns the initial camera state.
+ * @return A camera looking at the whole solar system.
+ */
+CameraState initialCameraState();
+
+/**
+ * @brief Computes the position of the camera.
+ * @param camera The camera.
+ * @return The eye position passed to `gluLookAt`.
+ */
+Vec3 cameraEye(const CameraState &camera);
+
+/**
+ * @brief Adjusts the camera zoom level.
+ * @param camera The camera to zoom.
+ * @param out If true, zooms out; otherwise, zooms in.
+ * @param minDistance Closest distance the camera can zoom in to.
+ *
+ * The distance changes by one unit, or by `CAMERA_ZOOM_RATIO` of the
+ * altitude above @p minDistance when that is less, so zooming in slows down
+ * near the target. A step that would leave less than
+ * `CAMERA_MIN_ALTITUDE_RATIO` of @p minDistance is not taken, so zooming out
+ * retraces the same steps, and zooming out from a lower altitude steps as
+ * if from that floor. The distance is clamped to `CAMERA_MAX_DISTANCE`.
+ */
+void zoomCamera(CameraState &camera, bool out, float minDistance);
+
+/**
+ * @brief Orbits the camera around its target.
+ * @param camera The camera to orbit.
+ * @param dx Horizontal mouse movement, in pixels.
+ * @param dy Vertical mouse movement, in pixels.
+ *
+ * The vertical angle is clamped to `CAMERA_MAX_ANGLE_Y` to prevent the
+ * camera from flipping over the poles.
+ */
+void orbitCamera(CameraState &camera, int dx, int dy);
+
+/**
+ * @brief Plans the path of a camera flight and starts it.
+ * @param flight The flight; its start point, `fromBody` and `fromOffset`,
+ *               is left to the caller.
+ * @param from The camera where the flight starts.
+ * @param to The camera where the flight ends.
+ * @param fromWidth Camera distance at the start, in world units.
+ * @param toWidth Camera distance at the end, in world units.
+ * @param separation Distance from the start point to the target, in world units.
+ *
+ * The duration grows with the length of the path, between
+ * `CAMERA_FLIGHT_MIN_SECONDS` and `CAMERA_FLIGHT_MAX_SECONDS`. The camera
+ * turns around the target the short way.
+ */
+void startCameraFlight(CameraFlight &flight, const CameraState &from, const CameraState &to, double fromWidth,
+                       double toWidth, double separation);
+
+/**
+ * @brief Advances a camera flight by some real time.
+ * @param flight The flight, which ends once its duration has elapsed.
+ * @param seconds The real time elapsed, in seconds.
+ */
+void advanceCameraFlight(CameraFlight &flight, double seconds);
+
+/**
+ * @brief Returns how far a camera flight has progressed.
+ * @param flight The flight.
+ * @return 0 at the start and 1 at the end, easing in and out.
+ */
+double cameraFlightProgress(const CameraFlight &flight);
+
+/**
+ * @brief Evaluates the path of a camera flight.
+ * @param flight The flight.
+ * @param progress Progress along the flight, see `cameraFlightProgress`.
+ * @param fraction Receives the fraction of the way from the start point to
+ *                 the target the camera looks at.
+ * @param width Receives the camera distance, in world units.
+ *
+ * Only a hyperbolic tangent and cosine are computed; everything else was
+ * computed by `startCameraFlight`.
+ */
+void cameraFlightPath(const CameraFlight &flight, double progress, double &fraction, double &width);
+
+#endif // CAMERA_H
@@ -0,0 +1,329 @@
+/**
+ * @file ephemeris.cpp
+ * @brief Implements the precomputed ephemeris of the celestial bodies.
+ */
+
+#include "ephemeris.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "bodies.h"
+#include "hash.h"
+#include "simulation.h"
+
+/**
+ * @var EPHEMERIS_MAGIC
+ * @brief First bytes of every ephemeris file.
+ */
+static const char EPHEMERIS_MAGIC[4] = {'S', 'E', 'P', 'H'};
+
+/**
+ * @var EPHEMERIS_HEADER_SIZE
+ * @brief Size of the magic and header words, which keeps the tables 8-byte aligned.
+ */
+static const size_t EPHEMERIS_HEADER_SIZE = 32;
+
+/**
+ * @var EPHEMERIS_SEGMENT_DOUBLES
+ * @brief Number of coefficients in a segment, for the three coordinates.
+ */
+static const size_t EPHEMERIS_SEGMENT_DOUBLES = 3 * EPHEMERIS_COEFFICIENTS;
+
+/**
+ * @brief Computes the position of a body from its orbital model.
+ * @param body The body.
+ * @param time The simulation angle, in degrees.
+ * @param position Receives the position, in orbit radii.
+ *
+ * Orbits are circles in the XZ plane, traversed at the body's speed from
+ * the +X axis, as `glRotatef` followed by `glTranslatef` would place them.
+ */
+static void orbitModelPosition(const Body &body, double time, double position[3])
+{
+  double angle = time * body.orbitSpeed * 3.14159265358979 / 180.0;
+  position[0] = cos(angle);
+  position[1] = 0.0;
+  position[2] = -sin(angle);
+};
+
+/**
+ * @brief Hashes the orbital model together with the fit parameters.
+ * @param span Simulation time the ephemeris covers.
+ * @return The 64-bit FNV-1a hash identifying the series.
+ *
+ * The version is hashed first, so changing the model's code invalidates the
+ * cache once its version is raised, like changing a body's orbit does.
+ */
+uint64_t hashEphemeris(double span)
+{
+  double values[4 + 2 * BODY_COUNT] = {EPHEMERIS_VERSION, EPHEMERIS_COEFFICIENTS, EPHEMERIS_SEGMENT_ANGLE, span};
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    values[4 + 2 * i] = BODIES[i].orbitSpeed;
+    values[5 + 2 * i] = BODIES[i].orbitRadius > 0.0f ? 1.0 : 0.0;
+  }
+  return fnv1a(values, sizeof(values));
+};
+
+/**
+ * @brief Fits the Chebyshev series of every body.
+ * @param span Simulation time to cover, in degrees of simulation angle.
+ * @param bodies Receives the segment table of every body.
+ * @param coefficients Receives the coefficients of all segments.
+ *
+ * The span is cut into equal segments short enough for the body to move
+ * less than `EPHEMERIS_SEGMENT_ANGLE` within one. On each segment, the
+ * coefficients are the discrete Chebyshev transform of the model sampled at
+ * the `EPHEMERIS_COEFFICIENTS` Chebyshev nodes, the interpolant closest to
+ * the best uniform approximation.
+ */
+void computeEphemeris(double span, std::vector<EphemerisSegments> &bodies, std::vector<double> &coefficients)
+{
+  const int n = EPHEMERIS_COEFFICIENTS;
+  const double pi = 3.14159265358979323846;
+  bodies.resize(BODY_COUNT);
+  coefficients.clear();
+
+  uint32_t first = 0;
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    const Body &body = BODIES[i];
+    double turn = span * fabs(body.orbitSpeed);
+    uint32_t count = body.orbitRadius > 0.0f ? (uint32_t)std::max(1.0, ceil(turn / EPHEMERIS_SEGMENT_ANGLE)) : 0;
+    bodies[i].length = count ? span / count : span;
+    bodies[i].count = count;
+    bodies[i].first = first;
+    first += count;
+
+    for (uint32_t s = 0; s < count; ++s)
+    {
+      double start = s * bodies[i].length;
+      double samples[EPHEMERIS_COEFFICIENTS][3];
+      for (int k = 0; k < n; ++k)
+      {
+        double node = cos(pi * (k + 0.5) / n);
+        orbitModelPosition(body, start + (node + 1.0) * 0.5 * bodies[i].length, samples[k]);
+      }
+
+      for (int axis = 0; axis < 3; ++axis)
+      {
+        for (int j = 0; j < n; ++j)
+        {
+          double sum = 0.0;
+          for (int k = 0; k < n; ++k)
+            sum += samples[k][axis] * cos(pi * j * (k + 0.5) / n);
+          coefficients.push_back((j == 0 ? 1.0 : 2.0) * sum / n);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief Writes series to an ephemeris file.
+ * @param filename Path to the file.
+ * @param hash Hash of the model, see `hashEphemeris`.
+ * @param span Simulation time the series cover.
+ * @param bodies The segment table of every body.
+ * @param coefficients The coefficients of all segments.
+ * @return True if the file was written successfully.
+ */
+bool writeEphemeris(const char *filename, uint64_t hash, double span, const std::vector<EphemerisSegments> &bodies,
+                    const std::vector<double> &coefficients)
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  uint32_t header[3] = {EPHEMERIS_VERSION, (uint32_t)bodies.size(), EPHEMERIS_COEFFICIENTS};
+  file.write(EPHEMERIS_MAGIC, sizeof(EPHEMERIS_MAGIC));
+  file.write((const char *)header, sizeof(header));
+  file.write((const char *)&hash, sizeof(hash));
+  file.write((const char *)&span, sizeof(span));
+  if (!bodies.empty())
+    file.write((const char *)&bodies[0], bodies.size() * sizeof(EphemerisSegments));
+  if (!coefficients.empty())
+    file.write((const char *)&coefficients[0], coefficients.size() * sizeof(double));
+  return (bool)file;
+};
+
+/**
+ * @brief Checks an ephemeris header and segment tables against the size of their file.
+ * @param bytes The contents of the file, at least its header.
+ * @param fileSize Size of the file, in bytes.
+ * @param hash Hash the file must have been written with.
+ * @param bodyCount Receives the number of bodies.
+ * @param span Receives the span.
+ * @return True if the header is valid and the file holds exactly its tables.
+ */
+static bool checkEphemerisHeader(const char *bytes, uint64_t fileSize, uint64_t hash, uint32_t &bodyCount, double &span)
+{
+  uint32_t header[3];
+  uint64_t fileHash;
+  memcpy(header, bytes + sizeof(EPHEMERIS_MAGIC), sizeof(header));
+  memcpy(&fileHash, bytes + 16, sizeof(fileHash));
+  memcpy(&span, bytes + 24, sizeof(span));
+  if (memcmp(bytes, EPHEMERIS_MAGIC, sizeof(EPHEMERIS_MAGIC)) != 0 || header[0] != EPHEMERIS_VERSION ||
+      header[2] != EPHEMERIS_COEFFICIENTS || fileHash != hash || !(span > 0.0))
+    return false;
+  bodyCount = header[1];
+  return fileSize >= EPHEMERIS_HEADER_SIZE + (uint64_t)bodyCount * sizeof(EphemerisSegments);
+};
+
+/**
+ * @brief Checks that the segment tables match the number of coefficients.
+ * @param bodies The segment table of every body.
+ * @param bodyCount Number of bodies.
+ * @param coefficientBytes Size of the coefficients, in bytes.
+ * @return True if every segment lies within the coefficients and all are used.
+ */
+static bool checkEphemerisSegments(const EphemerisSegments *bodies, uint32_t bodyCount, uint64_t coefficientBytes)
+{
+  uint64_t segments = 0;
+  for (uint32_t i = 0; i < bodyCount; ++i)
+  {
+    if (bodies[i].first != segments || (bodies[i].count && !(bodies[i].length > 0.0)))
+      return false;
+    segments += bodies[i].count;
+  }
+  return coefficientBytes == segments * EPHEMERIS_SEGMENT_DOUBLES * sizeof(double);
+};
+
+/**
+ * @brief Opens an ephemeris file.
+ * @param filename Path to the file.
+ * @param hash Hash the file must have been written with.
+ * @param ephemeris The ephemeris that receives the series.
+ * @return True if the file exists, matches the hash and holds exactly its tables.
+ *
+ * The file is opened with `openMappedFile` and evaluated in place. An open
+ * ephemeris must be closed before it is opened again.
+ */
+bool openEphemeris(const char *filename, uint64_t hash, Ephemeris &ephemeris)
+{
+  ephemeris.span = 0.0;
+  ephemeris.bodyCount = 0;
+  ephemeris.bodies = NULL;
+  ephemeris.coefficients = NULL;
+  uint32_t bodyCount = 0;
+  double span = 0.0;
+
+  if (!openMappedFile(filename, ephemeris.file))
+    return false;
+  const char *bytes = ephemeris.file.data;
+  size_t size = ephemeris.file.size;
+  const EphemerisSegments *bodies = (const EphemerisSegments *)(bytes + EPHEMERIS_HEADER_SIZE);
+  if (size < EPHEMERIS_HEADER_SIZE || !checkEphemerisHeader(bytes, size, hash, bodyCount, span) ||
+      !checkEphemerisSegments(bodies, bodyCount, size - EPHEMERIS_HEADER_SIZE - bodyCount * sizeof(EphemerisSegments)))
+  {
+    closeMappedFile(ephemeris.file);
+    return false;
+  }
+  ephemeris.bodies = bodies;
+  ephemeris.coefficients = (const double *)(bytes + EPHEMERIS_HEADER_SIZE + bodyCount * sizeof(EphemerisSegments));
+
+  ephemeris.span = span;
+  ephemeris.bodyCount = (int)bodyCount;
+  return true;
+};
+
+/**
+ * @brief Releases the series of an ephemeris.
+ * @param ephemeris The ephemeris to close; it is left empty.
+ */
+void closeEphemeris(Ephemeris &ephemeris)
+{
+  closeMappedFile(ephemeris.file);
+  ephemeris.span = 0.0;
+  ephemeris.bodyCount = 0;
+  ephemeris.bodies = NULL;
+  ephemeris.coefficients = NULL;
+  ephemeris.bodyStorage.clear();
+  ephemeris.coefficientStorage.clear();
+};
+
+/**
+ * @brief Opens the cached ephemeris of the simulation period, or fits and caches it.
+ * @param ephemeris The ephemeris that receives the series.
+ *
+ * When the series have to be fitted, they are used from memory for this
+ * run and the cache is only read by the next one.
+ */
+void loadEphemeris(Ephemeris &ephemeris)
+{
+  uint64_t hash = hashEphemeris(SIMULATION_PERIOD);
+  char filename[256];
+  snprintf(filename, sizeof(filename), "%s/ephemeris-%016llx.eph", EPHEMERIS_CACHE_DIRECTORY, (unsigned long long)hash);
+  if (openEphemeris(filename, hash, ephemeris))
+    return;
+
+  computeEphemeris(SIMULATION_PERIOD, ephemeris.bodyStorage, ephemeris.coefficientStorage);
+  if (!writeEphemeris(filename, hash, SIMULATION_PERIOD, ephemeris.bodyStorage, ephemeris.coefficientStorage))
+    std::cerr << "Failed to cache the ephemeris: " << filename << std::endl;
+  ephemeris.span = SIMULATION_PERIOD;
+  ephemeris.bodyCount = (int)ephemeris.bodyStorage.size();
+  ephemeris.bodies = &ephemeris.bodyStorage[0];
+  ephemeris.coefficients = ephemeris.coefficientStorage.empty() ? NULL : &ephemeris.coefficientStorage[0];
+};
+
+/**
+ * @brief Evaluates the position of a body.
+ * @param ephemeris The ephemeris.
+ * @param body Index of the body.
+ * @param time The simulation angle, in degrees.
+ * @param position Receives the position, in orbit radii.
+ *
+ * The time selects a segment and is mapped to [-1, 1] within it; the
+ * coordinates are then summed with Clenshaw's recurrence, two multiply-adds
+ * per coefficient. The three recurrences run in the same loop, so their
+ * dependency chains overlap. Times within the span, which the simulation
+ * keeps its angle in, skip the modulo. Bodies without segments are at the
+ * origin.
+ */
+void ephemerisPosition(const Ephemeris &ephemeris, int body, double time, double position[3])
+{
+  position[0] = position[1] = position[2] = 0.0;
+  if (body < 0 || body >= ephemeris.bodyCount || ephemeris.bodies[body].count == 0)
+    return;
+
+  const EphemerisSegments &segments = ephemeris.bodies[body];
+  double t = time;
+  if (t < 0.0 || t >= ephemeris.span)
+  {
+    t = fmod(t, ephemeris.span);
+    if (t < 0.0)
+      t += ephemeris.span;
+  }
+  double scaled = t / segments.length;
+  uint32_t index = (uint32_t)scaled;
+  if (index >= segments.count)
+    index = segments.count - 1;
+  double x = 2.0 * (scaled - index) - 1.0;
+  double twoX = 2.0 * x;
+
+  const double *cx = ephemeris.coefficients + (size_t)(segments.first + index) * EPHEMERIS_SEGMENT_DOUBLES;
+  const double *cy = cx + EPHEMERIS_COEFFICIENTS;
+  const double *cz = cy + EPHEMERIS_COEFFICIENTS;
+  double bx1 = 0.0, by1 = 0.0, bz1 = 0.0;
+  double bx2 = 0.0, by2 = 0.0, bz2 = 0.0;
+  for (int j = EPHEMERIS_COEFFICIENTS - 1; j > 0; --j)
+  {
+    double bx = twoX * bx1 - bx2 + cx[j];
+    double by = twoX * by1 - by2 + cy[j];
+    double bz = twoX * bz1 - bz2 + cz[j];
+    bx2 = bx1;
+    by2 = by1;
+    bz2 = bz1;
+    bx1 = bx;
+    by1 = by;
+    bz1 = bz;
+  }
+  position[0] = x * bx1 - bx2 + cx[0];
+  position[1] = x * by1 - by2 + cy[0];
+  position[2] = x * bz1 - bz2 + cz[0];
+};
@@ -0,0 +1,157 @@
+/**
+ * @file ephemeris.h
+ * @brief Declares the precomputed ephemeris of the celestial bodies.
+ *
+ * Body positions are not evaluated from their orbital model every frame.
+ * Like the JPL ephemerides, the ephemeris cuts the simulation period into
+ * segments and stores, for each body and segment, the Chebyshev series of
+ * the three coordinates of its position. A position is then a segment
+ * lookup and a short Clenshaw recurrence, a few multiply-adds per
+ * coordinate, whatever the cost of the model the series were fitted to.
+ * Segments cover `EPHEMERIS_SEGMENT_ANGLE` degrees of a body's orbit, so
+ * faster bodies get more of them, and the fit is exact to about 10^-12 of
+ * the orbit radius.
+ *
+ * Positions are measured in orbit radii, so the same series place a body
+ * at the scene's scale and at its real distance. Bodies without an orbit,
+ * such as the Sun, have no segments and stay at the origin.
+ *
+ * The series are fitted at the first startup and cached in a file named
+ * after a hash of the model and the fit parameters, which later runs
+ * memory-map. An ephemeris file starts with the 4-byte magic `SEPH`,
+ * followed by the version, the body count and the coefficient count per
+ * series as 32-bit unsigned integers, the hash as a 64-bit unsigned
+ * integer and the span as a 64-bit float, in little-endian order. Then
+ * come the segment table of every body and the coefficients, as 64-bit
+ * floats.
+ */
+
+#ifndef EPHEMERIS_H
+#define EPHEMERIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "mapped_file.h"
+
+/**
+ * @def EPHEMERIS_CACHE_DIRECTORY
+ * @brief Directory the ephemeris is cached in.
+ *
+ * It holds the other generated assets and is not part of the sources.
+ */
+#define EPHEMERIS_CACHE_DIRECTORY "../assets/packs"
+
+/**
+ * @def EPHEMERIS_VERSION
+ * @brief Version of the ephemeris file format and of the fit, part of the hash.
+ */
+#define EPHEMERIS_VERSION 1
+
+/**
+ * @def EPHEMERIS_COEFFICIENTS
+ * @brief Number of Chebyshev coefficients of each coordinate in a segment.
+ */
+#define EPHEMERIS_COEFFICIENTS 9
+
+/**
+ * @def EPHEMERIS_SEGMENT_ANGLE
+ * @brief Largest angle, in degrees, a body moves along its orbit within one segment.
+ */
+#define EPHEMERIS_SEGMENT_ANGLE 45.0
+
+/**
+ * @struct EphemerisSegments
+ * @brief Segment table of one body, in its file layout.
+ */
+struct EphemerisSegments
+{
+  double length;  ///< Simulation time covered by each segment, in degrees of simulation angle.
+  uint32_t count; ///< Number of segments, covering the span; 0 for a body at the origin.
+  uint32_t first; ///< Index of the body's first segment among all segments.
+};
+
+/**
+ * @struct Ephemeris
+ * @brief Chebyshev series of the positions of every body.
+ *
+ * Every segment holds `EPHEMERIS_COEFFICIENTS` coefficients of X, then of
+ * Y, then of Z. The tables either point into the opened file or into the
+ * storage vectors, when the series were just fitted.
+ */
+struct Ephemeris
+{
+  double span;                                 ///< Simulation time covered, after which positions repeat.
+  int bodyCount;                               ///< Number of bodies, indexed by `BodyIndex`.
+  const EphemerisSegments *bodies;             ///< Segment table of every body.
+  const double *coefficients;                  ///< Coefficients of all segments.
+  MappedFile file;                             ///< Contents of the ephemeris file, if the series were read.
+  std::vector<EphemerisSegments> bodyStorage;  ///< Segment tables when they were fitted.
+  std::vector<double> coefficientStorage;      ///< Coefficients when they were fitted.
+};
+
+/**
+ * @brief Hashes the orbital model together with the fit parameters.
+ * @param span Simulation time the ephemeris covers.
+ * @return The 64-bit FNV-1a hash identifying the series.
+ */
+uint64_t hashEphemeris(double span);
+
+/**
+ * @brief Fits the Chebyshev series of every body.
+ * @param span Simulation time to cover, in degrees of simulation angle.
+ * @param bodies Receives the segment table of every body.
+ * @param coefficients Receives the coefficients of all segments.
+ *
+ * Each series interpolates the orbital model at the Chebyshev nodes of its
+ * segment.
+ */
+void computeEphemeris(double span, std::vector<EphemerisSegments> &bodies, std::vector<double> &coefficients);
+
+/**
+ * @brief Writes series to an ephemeris file.
+ * @param filename Path to the file.
+ * @param hash Hash of the model, see `hashEphemeris`.
+ * @param span Simulation time the series cover.
+ * @param bodies The segment table of every body.
+ * @param coefficients The coefficients of all segments.
+ * @return True if the file was written successfully.
+ */
+bool writeEphemeris(const char *filename, uint64_t hash, double span, const std::vector<EphemerisSegments> &bodies,
+                    const std::vector<double> &coefficients);
+
+/**
+ * @brief Opens an ephemeris file.
+ * @param filename Path to the file.
+ * @param hash Hash the file must have been written with.
+ * @param ephemeris The ephemeris that receives the series.
+ * @return True if the file exists, matches the hash and holds exactly its tables.
+ */
+bool openEphemeris(const char *filename, uint64_t hash, Ephemeris &ephemeris);
+
+/**
+ * @brief Releases the series of an ephemeris.
+ * @param ephemeris The ephemeris to close; it is left empty.
+ */
+void closeEphemeris(Ephemeris &ephemeris);
+
+/**
+ * @brief Opens the cached ephemeris of the simulation period, or fits and caches it.
+ * @param ephemeris The ephemeris that receives the series.
+ *
+ * The cache file lives in `EPHEMERIS_CACHE_DIRECTORY`. A file that cannot
+ * be written only costs the fit again at the next startup.
+ */
+void loadEphemeris(Ephemeris &ephemeris);
+
+/**
+ * @brief Evaluates the position of a body.
+ * @param ephemeris The ephemeris.
+ * @param body Index of the body.
+ * @param time The simulation angle, in degrees; reduced modulo the span.
+ * @param position Receives the position, in orbit radii.
+ */
+void ephemerisPosition(const Ephemeris &ephemeris, int body, double time, double position[3]);
+
+#endif // EPHEMERIS_H
@@ -0,0 +1,145 @@
+/**
+ * @file frustum.cpp
+ * @brief Implements view-frustum culling of bounding spheres.
+ */
+
+#include "frustum.h"
+
+#include <cmath>
+
+/**
+ * @brief Extracts the frustum of a view-projection matrix.
+ * @param viewProjection The product `projection * view`.
+ * @return The frustum in the space the view matrix transforms from.
+ *
+ * The planes are combinations of the matrix rows (Gribb and Hartmann): each
+ * one is the fourth row plus or minus one of the first three, normalized so
+ * that plane distances are in world units. A plane without a normal, such
+ * as the far plane of a projection whose depth range exceeds single
+ * precision, lies at infinity and is replaced by one every point is in
+ * front of.
+ */
+Frustum extractFrustum(const Mat4 &viewProjection)
+{
+  const float *m = viewProjection.m;
+  Frustum frustum;
+  for (int i = 0; i < 6; ++i)
+  {
+    int row = i / 2;
+    float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+    float a = m[3] + sign * m[row];
+    float b = m[7] + sign * m[4 + row];
+    float c = m[11] + sign * m[8 + row];
+    float d = m[15] + sign * m[12 + row];
+    float length = sqrtf(a * a + b * b + c * c);
+    if (length < 1e-6f)
+    {
+      a = b = c = 0.0f;
+      d = length = 1.0f;
+    }
+    frustum.planes[i][0] = a / length;
+    frustum.planes[i][1] = b / length;
+    frustum.planes[i][2] = c / length;
+    frustum.planes[i][3] = d / length;
+  }
+  return frustum;
+};
+
+/**
+ * @brief Removes all spheres from a batch, keeping its memory.
+ * @param batch The batch to clear.
+ */
+void clearCullingBatch(CullingBatch &batch)
+{
+  batch.x.clear();
+  batch.y.clear();
+  batch.z.clear();
+  batch.radius.clear();
+  batch.visible.clear();
+};
+
+/**
+ * @brief Appends a bounding sphere to a batch.
+ * @param batch The batch.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @return The index of the sphere in the batch.
+ */
+size_t addCullingSphere(CullingBatch &batch, const Vec3 &center, float radius)
+{
+  batch.x.push_back(center.x);
+  batch.y.push_back(center.y);
+  batch.z.push_back(center.z);
+  batch.radius.push_back(radius);
+  return batch.x.size() - 1;
+};
+
+/**
+ * @brief Tests every sphere of a batch against a frustum.
+ * @param frustum The frustum.
+ * @param batch The spheres to test; `batch.visible` receives the results.
+ * @return The number of spheres that are at least partially inside.
+ *
+ * A sphere is rejected as soon as its center lies farther than its radius
+ * behind any plane. The loop over spheres is branch-free so that it can be
+ * vectorized; spheres near a frustum corner may be kept conservatively.
+ */
+size_t cullSpheres(const Frustum &frustum, CullingBatch &batch)
+{
+  size_t count = batch.x.size();
+  batch.visible.resize(count);
+  if (count == 0)
+    return 0;
+
+  const float *x = &batch.x[0];
+  const float *y = &batch.y[0];
+  const float *z = &batch.z[0];
+  const float *radius = &batch.radius[0];
+  unsigned char *visible = &batch.visible[0];
+
+  for (size_t i = 0; i < count; ++i)
+    visible[i] = 1;
+
+  for (int p = 0; p < 6; ++p)
+  {
+    float a = frustum.planes[p][0];
+    float b = frustum.planes[p][1];
+    float c = frustum.planes[p][2];
+    float d = frustum.planes[p][3];
+    for (size_t i = 0; i < count; ++i)
+    {
+      float distance = a * x[i] + b * y[i] + c * z[i] + d;
+      visible[i] &= (unsigned char)(distance >= -radius[i]);
+    }
+  }
+
+  size_t visibleCount = 0;
+  for (size_t i = 0; i < count; ++i)
+    visibleCount += visible[i];
+  return visibleCount;
+};
+
+/**
+ * @brief Classifies one bounding sphere against a frustum.
+ * @param frustum The frustum.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @return Whether the sphere is outside, partially inside or inside.
+ *
+ * Hierarchies use this test to accept a node whose sphere is inside every
+ * plane together with all of its children, without testing them.
+ */
+FrustumTest testSphere(const Frustum &frustum, const Vec3 &center, float radius)
+{
+  FrustumTest result = FRUSTUM_INSIDE;
+  for (int p = 0; p < 6; ++p)
+  {
+    const float *plane = frustum.planes[p];
+    float distance = plane[0] * center.x + plane[1] * center.y + plane[2] * center.z + plane[3];
+    if (distance < -radius)
+      return FRUSTUM_OUTSIDE;
+    if (distance < radius)
+      result = FRUSTUM_INTERSECTS;
+  }
+  return result;
+};
@@ -0,0 +1,98 @@
+/**
+ * @file frustum.h
+ * @brief Declares view-frustum culling of bounding spheres.
+ *
+ * This file declares the frustum extracted from a view-projection matrix and
+ * a batch test that classifies many bounding spheres at once. Spheres are
+ * passed as separate coordinate arrays so that the test runs as a tight loop
+ * the compiler can vectorize.
+ */
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "transform.h"
+
+/**
+ * @struct Frustum
+ * @brief The six clipping planes of a view volume.
+ *
+ * Each plane is stored as `(a, b, c, d)` with a unit normal pointing inside
+ * the volume, so a point `p` is inside when `a*p.x + b*p.y + c*p.z + d >= 0`.
+ * The order is left, right, bottom, top, near, far.
+ */
+struct Frustum
+{
+  float planes[6][4]; ///< Normalized plane equations.
+};
+
+/**
+ * @enum FrustumTest
+ * @brief Position of a bounding volume relative to a frustum.
+ */
+enum FrustumTest
+{
+  FRUSTUM_OUTSIDE = 0, ///< Entirely outside.
+  FRUSTUM_INTERSECTS,  ///< Partially inside, or near a corner of the frustum.
+  FRUSTUM_INSIDE       ///< Entirely inside.
+};
+
+/**
+ * @struct CullingBatch
+ * @brief Bounding spheres to be tested against a frustum, in SoA layout.
+ *
+ * The arrays are reused from frame to frame; `visible` receives 1 for each
+ * sphere that intersects the frustum and 0 otherwise.
+ */
+struct CullingBatch
+{
+  std::vector<float> x;                ///< X coordinate of every sphere center.
+  std::vector<float> y;                ///< Y coordinate of every sphere center.
+  std::vector<float> z;                ///< Z coordinate of every sphere center.
+  std::vector<float> radius;           ///< Radius of every sphere.
+  std::vector<unsigned char> visible;  ///< Result of the last test, one flag per sphere.
+};
+
+/**
+ * @brief Extracts the frustum of a view-projection matrix.
+ * @param viewProjection The product `projection * view`.
+ * @return The frustum in the space the view matrix transforms from.
+ */
+Frustum extractFrustum(const Mat4 &viewProjection);
+
+/**
+ * @brief Removes all spheres from a batch, keeping its memory.
+ * @param batch The batch to clear.
+ */
+void clearCullingBatch(CullingBatch &batch);
+
+/**
+ * @brief Appends a bounding sphere to a batch.
+ * @param batch The batch.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @return The index of the sphere in the batch.
+ */
+size_t addCullingSphere(CullingBatch &batch, const Vec3 &center, float radius);
+
+/**
+ * @brief Tests every sphere of a batch against a frustum.
+ * @param frustum The frustum.
+ * @param batch The spheres to test; `batch.visible` receives the results.
+ * @return The number of spheres that are at least partially inside.
+ */
+size_t cullSpheres(const Frustum &frustum, CullingBatch &batch);
+
+/**
+ * @brief Classifies one bounding sphere against a frustum.
+ * @param frustum The frustum.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @return Whether the sphere is outside, partially inside or inside.
+ */
+FrustumTest testSphere(const Frustum &frustum, const Vec3 &center, float radius);
+
+#endif // FRUSTUM_H
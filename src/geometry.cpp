@@ -0,0 +1,143 @@
+/**
+ * @file geometry.cpp
+ * @brief Implements CPU-side mesh generation for celestial bodies.
+ *
+ * This file provides the tessellation routines for spheres, disks and orbits.
+ * Output containers are reused between calls, so regenerating a mesh of the
+ * same size does not allocate.
+ */
+
+#include "geometry.h"
+
+#include <cmath>
+
+/**
+ * @brief Appends one interleaved vertex to a mesh.
+ * @param mesh The mesh to extend.
+ * @param x, y, z The vertex position.
+ * @param nx, ny, nz The vertex normal.
+ * @param s, t The texture coordinates.
+ */
+static inline void pushVertex(Mesh &mesh, float x, float y, float z, float nx, float ny, float nz, float s, float t)
+{
+  mesh.vertices.push_back(x);
+  mesh.vertices.push_back(y);
+  mesh.vertices.push_back(z);
+  mesh.vertices.push_back(nx);
+  mesh.vertices.push_back(ny);
+  mesh.vertices.push_back(nz);
+  mesh.vertices.push_back(s);
+  mesh.vertices.push_back(t);
+};
+
+/**
+ * @brief Appends the two triangles of a grid quad to a mesh.
+ * @param mesh The mesh to extend.
+ * @param columns Number of vertices per grid row.
+ * @param row The row of the quad's first vertex.
+ * @param column The column of the quad's first vertex.
+ */
+static inline void pushGridQuad(Mesh &mesh, int columns, int row, int column)
+{
+  unsigned int a = row * columns + column;
+  unsigned int b = a + columns;
+  mesh.indices.push_back(a);
+  mesh.indices.push_back(b);
+  mesh.indices.push_back(a + 1);
+  mesh.indices.push_back(a + 1);
+  mesh.indices.push_back(b);
+  mesh.indices.push_back(b + 1);
+};
+
+/**
+ * @brief Tessellates a textured sphere.
+ * @param radius The radius of the sphere.
+ * @param slices Number of subdivisions around the Z-axis.
+ * @param stacks Number of subdivisions along the Z-axis.
+ * @param mesh The mesh that receives the generated geometry.
+ *
+ * Vertices are generated on a (stacks + 1) x (slices + 1) grid so that the
+ * texture seam gets its own column of vertices.
+ */
+void buildSphere(float radius, int slices, int stacks, Mesh &mesh)
+{
+  mesh.vertices.clear();
+  mesh.indices.clear();
+  mesh.vertices.reserve((size_t)(stacks + 1) * (slices + 1) * MESH_VERTEX_FLOATS);
+  mesh.indices.reserve((size_t)stacks * slices * 6);
+
+  const float pi = 3.14159265358979f;
+  for (int i = 0; i <= stacks; ++i)
+  {
+    float rho = pi * i / stacks;
+    float sinRho = sinf(rho);
+    float cosRho = cosf(rho);
+    for (int j = 0; j <= slices; ++j)
+    {
+      float theta = (j == slices) ? 0.0f : 2.0f * pi * j / slices;
+      float x = -sinf(theta) * sinRho;
+      float y = cosf(theta) * sinRho;
+      float z = cosRho;
+      pushVertex(mesh, x * radius, y * radius, z * radius, x, y, z, (float)j / slices, 1.0f - (float)i / stacks);
+    }
+  }
+
+  for (int i = 0; i < stacks; ++i)
+    for (int j = 0; j < slices; ++j)
+      pushGridQuad(mesh, slices + 1, i, j);
+};
+
+/**
+ * @brief Tessellates a flat textured disk with a hole in the middle.
+ * @param innerRadius The inner radius of the disk.
+ * @param outerRadius The outer radius of the disk.
+ * @param slices Number of subdivisions around the Z-axis.
+ * @param loops Number of concentric rings between the inner and outer radius.
+ * @param mesh The mesh that receives the generated geometry.
+ */
+void buildDisk(float innerRadius, float outerRadius, int slices, int loops, Mesh &mesh)
+{
+  mesh.vertices.clear();
+  mesh.indices.clear();
+  mesh.vertices.reserve((size_t)(loops + 1) * (slices + 1) * MESH_VERTEX_FLOATS);
+  mesh.indices.reserve((size_t)loops * slices * 6);
+
+  const float pi = 3.14159265358979f;
+  float radiusStep = (outerRadius - innerRadius) / loops;
+  float texScale = 1.0f / (2.0f * outerRadius);
+  for (int l = 0; l <= loops; ++l)
+  {
+    float r = innerRadius + l * radiusStep;
+    for (int s = 0; s <= slices; ++s)
+    {
+      float angle = (s == slices) ? 0.0f : 2.0f * pi * s / slices;
+      float sa = sinf(angle);
+      float ca = cosf(angle);
+      pushVertex(mesh, r * sa, r * ca, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f + sa * r * texScale, 0.5f + ca * r * texScale);
+    }
+  }
+
+  for (int l = 0; l < loops; ++l)
+    for (int s = 0; s < slices; ++s)
+      pushGridQuad(mesh, slices + 1, l, s);
+};
+
+/**
+ * @brief Generates the vertices of a circular orbit.
+ * @param radius The radius of the orbit.
+ * @param segments Number of line segments in the closed loop.
+ * @param vertices The array that receives the XYZ position of every vertex.
+ */
+void buildOrbit(float radius, int segments, std::vector<float> &vertices)
+{
+  vertices.resize((size_t)segments * 3);
+
+  const float pi = 3.14159265358979f;
+  for (int i = 0; i < segments; ++i)
+  {
+    float theta = 2.0f * pi * i / segments;
+    vertices[i * 3 + 0] = radius * cosf(theta);
+    vertices[i * 3 + 1] = 0.0f;
+    vertices[i * 3 + 2] = radius * sinf(theta);
+  }
+};
@@ -0,0 +1,70 @@
+/**
+ * @file geometry.h
+ * @brief Provides CPU-side mesh generation for celestial bodies.
+ *
+ * This file declares the mesh type and the functions used to tessellate
+ * spheres, orbits and ring disks. The generated meshes follow the same
+ * parameterization as the GLU quadrics, so they can replace `gluSphere` and
+ * `gluDisk` without changing how textures are mapped.
+ */
+
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <vector>
+
+/**
+ * @def MESH_VERTEX_FLOATS
+ * @brief Number of floats per interleaved mesh vertex.
+ *
+ * Each vertex stores its position (3 floats), normal (3 floats) and texture
+ * coordinates (2 floats), in that order.
+ */
+#define MESH_VERTEX_FLOATS 8
+
+/**
+ * @struct Mesh
+ * @brief Indexed triangle mesh with interleaved vertex attributes.
+ */
+struct Mesh
+{
+  std::vector<float> vertices;       ///< Interleaved position, normal and texture coordinates.
+  std::vector<unsigned int> indices; ///< Triangle list indices into the vertex array.
+};
+
+/**
+ * @brief Tessellates a textured sphere.
+ * @param radius The radius of the sphere.
+ * @param slices Number of subdivisions around the Z-axis.
+ * @param stacks Number of subdivisions along the Z-axis.
+ * @param mesh The mesh that receives the generated geometry.
+ *
+ * The poles lie on the Z-axis and the texture coordinates wrap around it,
+ * matching `gluSphere` with texturing enabled.
+ */
+void buildSphere(float radius, int slices, int stacks, Mesh &mesh);
+
+/**
+ * @brief Tessellates a flat textured disk with a hole in the middle.
+ * @param innerRadius The inner radius of the disk.
+ * @param outerRadius The outer radius of the disk.
+ * @param slices Number of subdivisions around the Z-axis.
+ * @param loops Number of concentric rings between the inner and outer radius.
+ * @param mesh The mesh that receives the generated geometry.
+ *
+ * The disk lies in the XY plane facing +Z, with texture coordinates matching
+ * `gluDisk`.
+ */
+void buildDisk(float innerRadius, float outerRadius, int slices, int loops, Mesh &mesh);
+
+/**
+ * @brief Generates the vertices of a circular orbit.
+ * @param radius The radius of the orbit.
+ * @param segments Number of line segments in the closed loop.
+ * @param vertices The array that receives the XYZ position of every vertex.
+ *
+ * The orbit lies in the XZ plane and is meant to be drawn as a line loop.
+ */
+void buildOrbit(float radius, int segments, std::vector<float> &vertices);
+
+#endif // GEOMETRY_H
@@ -0,0 +1,111 @@
+/**
+ * @file gpu_profiler.cpp
+ * @brief Implements the GPU timer queries that measure the passes of a frame.
+ */
+
+#include "gpu_profiler.h"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Checks whether the current context supports timer queries.
+ * @return True for OpenGL 3.3 and later, or with `ARB_timer_query` or
+ *         `EXT_timer_query`.
+ *
+ * Contexts older than 3.3 are never core profiles, so their extension
+ * string can be read in one piece.
+ */
+static bool supportsTimerQueries()
+{
+  int major = 0;
+  int minor = 0;
+  const char *version = (const char *)glGetString(GL_VERSION);
+  if (!version || sscanf(version, "%d.%d", &major, &minor) != 2)
+    return false;
+  if (major * 10 + minor >= 33)
+    return true;
+
+  const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+  return extensions && (strstr(extensions, "GL_ARB_timer_query") || strstr(extensions, "GL_EXT_timer_query"));
+};
+
+/**
+ * @brief Checks the context and creates the profiler's queries.
+ * @param profiler The profiler to initialize.
+ * @return True if the context supports timer queries.
+ */
+bool initGpuProfiler(GpuProfiler &profiler)
+{
+  profiler.supported = supportsTimerQueries();
+  profiler.frame = 0;
+  for (int timer = 0; timer < GPU_TIMER_COUNT; ++timer)
+    profiler.milliseconds[timer] = 0.0f;
+  for (int slot = 0; slot < GPU_PROFILER_LATENCY; ++slot)
+  {
+    for (int timer = 0; timer < GPU_TIMER_COUNT; ++timer)
+    {
+      profiler.queries[slot][timer] = 0;
+      profiler.pending[slot][timer] = false;
+    }
+  }
+
+  if (profiler.supported)
+    glGenQueries(GPU_PROFILER_LATENCY * GPU_TIMER_COUNT, &profiler.queries[0][0]);
+  return profiler.supported;
+};
+
+/**
+ * @brief Starts recording a new frame.
+ * @param profiler The profiler.
+ */
+void beginGpuProfilerFrame(GpuProfiler &profiler)
+{
+  if (!profiler.supported)
+    return;
+
+  profiler.frame = (profiler.frame + 1) % GPU_PROFILER_LATENCY;
+  for (int timer = 0; timer < GPU_TIMER_COUNT; ++timer)
+  {
+    if (!profiler.pending[profiler.frame][timer])
+      continue;
+
+    GLuint query = profiler.queries[profiler.frame][timer];
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available)
+    {
+      GLuint64 nanoseconds = 0;
+      glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+      profiler.milliseconds[timer] = (float)(nanoseconds * 1e-6);
+    }
+    profiler.pending[profiler.frame][timer] = false;
+  }
+};
+
+/**
+ * @brief Starts measuring a pass.
+ * @param profiler The profiler.
+ * @param timer The pass.
+ *
+ * A query whose result was skipped is simply issued again; OpenGL discards
+ * its previous result.
+ */
+void beginGpuTimer(GpuProfiler &profiler, GpuTimer timer)
+{
+  if (!profiler.supported)
+    return;
+
+  glBeginQuery(GL_TIME_ELAPSED, profiler.queries[profiler.frame][timer]);
+  profiler.pending[profiler.frame][timer] = true;
+};
+
+/**
+ * @brief Stops measuring the pass started last.
+ * @param profiler The profiler.
+ */
+void endGpuTimer(GpuProfiler &profiler)
+{
+  if (profiler.supported)
+    glEndQuery(GL_TIME_ELAPSED);
+};
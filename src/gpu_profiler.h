@@ -0,0 +1,79 @@
+/**
+ * @file gpu_profiler.h
+ * @brief Declares the GPU timer queries that measure the passes of a frame.
+ *
+ * The profiler wraps each pass of a frame in a `GL_TIME_ELAPSED` query.
+ * Queries are allocated for `GPU_PROFILER_LATENCY` frames and reused in
+ * turn, so a result is only read once the GPU has long finished the frame
+ * it measured and reading it never stalls the pipeline. The profiler does
+ * nothing when the context has no timer queries.
+ */
+
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include "opengl.h"
+
+/**
+ * @def GPU_PROFILER_LATENCY
+ * @brief Number of frames whose queries are in flight at once.
+ */
+#define GPU_PROFILER_LATENCY 3
+
+/**
+ * @enum GpuTimer
+ * @brief Passes of a frame measured by the profiler.
+ */
+enum GpuTimer
+{
+  GPU_TIMER_STARFIELD = 0, ///< Drawing the background stars.
+  GPU_TIMER_BODIES,        ///< Executing the render queue: bodies, rings and orbits.
+  GPU_TIMER_COUNT
+};
+
+/**
+ * @struct GpuProfiler
+ * @brief Timer queries of the last frames and their latest results.
+ */
+struct GpuProfiler
+{
+  bool supported;                                        ///< Whether the context has timer queries.
+  GLuint queries[GPU_PROFILER_LATENCY][GPU_TIMER_COUNT]; ///< Query objects of every frame slot.
+  bool pending[GPU_PROFILER_LATENCY][GPU_TIMER_COUNT];   ///< Whether a query was issued and not read yet.
+  unsigned int frame;                                    ///< Slot of the frame being recorded.
+  float milliseconds[GPU_TIMER_COUNT];                   ///< Latest GPU time of every pass, in milliseconds.
+};
+
+/**
+ * @brief Checks the context and creates the profiler's queries.
+ * @param profiler The profiler to initialize.
+ * @return True if the context supports timer queries (OpenGL 3.3,
+ *         `ARB_timer_query` or `EXT_timer_query`); otherwise the profiler is
+ *         left disabled and every time reads 0.
+ */
+bool initGpuProfiler(GpuProfiler &profiler);
+
+/**
+ * @brief Starts recording a new frame.
+ * @param profiler The profiler.
+ *
+ * The results of the frame that last used the next slot are collected
+ * first; a result that is not available yet is skipped and the previous
+ * time of its pass is kept.
+ */
+void beginGpuProfilerFrame(GpuProfiler &profiler);
+
+/**
+ * @brief Starts measuring a pass.
+ * @param profiler The profiler.
+ * @param timer The pass; timers cannot be nested.
+ */
+void beginGpuTimer(GpuProfiler &profiler, GpuTimer timer);
+
+/**
+ * @brief Stops measuring the pass started last.
+ * @param profiler The profiler.
+ */
+void endGpuTimer(GpuProfiler &profiler);
+
+#endif // GPU_PROFILER_H
@@ -0,0 +1,21 @@
+/**
+ * @file hash.cpp
+ * @brief Implements the hash identifying cached data and replayed frames.
+ */
+
+#include "hash.h"
+
+/**
+ * @brief Hashes bytes with the 64-bit FNV-1a hash.
+ * @param data The bytes.
+ * @param size Number of bytes.
+ * @param hash Hash to continue.
+ * @return The hash of the bytes, continued from @p hash.
+ */
+uint64_t fnv1a(const void *data, size_t size, uint64_t hash)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; ++i)
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  return hash;
+};
@@ -0,0 +1,32 @@
+/**
+ * @file hash.h
+ * @brief Declares the hash identifying cached data and replayed frames.
+ *
+ * The caches on disk are named after a hash of everything their contents
+ * depend on, and replays checksum the frames they draw. Both use the 64-bit
+ * FNV-1a hash, which is simple, stable across platforms and fast enough for
+ * a frame per step.
+ */
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @def FNV1A_OFFSET_BASIS
+ * @brief Starting value of a 64-bit FNV-1a hash.
+ */
+#define FNV1A_OFFSET_BASIS 14695981039346656037ull
+
+/**
+ * @brief Hashes bytes with the 64-bit FNV-1a hash.
+ * @param data The bytes.
+ * @param size Number of bytes.
+ * @param hash Hash to continue, so that several buffers can be hashed as one.
+ * @return The hash of the bytes, continued from @p hash.
+ */
+uint64_t fnv1a(const void *data, size_t size, uint64_t hash = FNV1A_OFFSET_BASIS);
+
+#endif // HASH_H
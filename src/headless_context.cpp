@@ -0,0 +1,170 @@
+/**
+ * @file headless_context.cpp
+ * @brief Implements window-less OpenGL context creation.
+ *
+ * This file creates the context through EGL on Linux, preferring the Mesa
+ * surfaceless platform so that no X server is needed, and through CGL on
+ * macOS. Builds without either API get a stub that always fails.
+ */
+
+#include "headless_context.h"
+
+#include <iostream>
+
+#if defined(__APPLE__)
+
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/OpenGL.h>
+
+/**
+ * @var headlessContext
+ * @brief The CGL context currently in use, if any.
+ */
+static CGLContextObj headlessContext = NULL;
+
+bool createHeadlessContext(int major, int minor, bool coreProfile)
+{
+  CGLPixelFormatAttribute attributes[] = {
+      kCGLPFAOpenGLProfile,
+      (CGLPixelFormatAttribute)(coreProfile ? kCGLOGLPVersion_3_2_Core : kCGLOGLPVersion_Legacy),
+      kCGLPFAAccelerated,
+      (CGLPixelFormatAttribute)0};
+
+  CGLPixelFormatObj pixelFormat;
+  GLint count;
+  if (CGLChoosePixelFormat(attributes, &pixelFormat, &count) != kCGLNoError || !pixelFormat)
+  {
+    std::cerr << "Failed to choose a headless CGL pixel format" << std::endl;
+    return false;
+  }
+
+  CGLError error = CGLCreateContext(pixelFormat, NULL, &headlessContext);
+  CGLDestroyPixelFormat(pixelFormat);
+  if (error != kCGLNoError)
+  {
+    std::cerr << "Failed to create a headless CGL context" << std::endl;
+    return false;
+  }
+
+  (void)major;
+  (void)minor;
+  return CGLSetCurrentContext(headlessContext) == kCGLNoError;
+};
+
+void destroyHeadlessContext()
+{
+  if (!headlessContext)
+    return;
+  CGLSetCurrentContext(NULL);
+  CGLDestroyContext(headlessContext);
+  headlessContext = NULL;
+};
+
+#elif defined(SOLAR_HAVE_EGL)
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+/**
+ * @var headlessDisplay
+ * @brief The EGL display owning the headless context.
+ */
+static EGLDisplay headlessDisplay = EGL_NO_DISPLAY;
+
+/**
+ * @var headlessContext
+ * @brief The EGL context currently in use, if any.
+ */
+static EGLContext headlessContext = EGL_NO_CONTEXT;
+
+/**
+ * @brief Opens the EGL display used for headless rendering.
+ * @return The initialized display, or `EGL_NO_DISPLAY` on failure.
+ *
+ * The Mesa surfaceless platform is tried first because it needs neither an
+ * X server nor a GPU device node; the default display is used otherwise.
+ */
+static EGLDisplay openHeadlessDisplay()
+{
+  EGLDisplay display = EGL_NO_DISPLAY;
+
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (getPlatformDisplay)
+    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+  if (display != EGL_NO_DISPLAY && !eglInitialize(display, NULL, NULL))
+    display = EGL_NO_DISPLAY;
+#endif
+
+  if (display == EGL_NO_DISPLAY)
+  {
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && !eglInitialize(display, NULL, NULL))
+      display = EGL_NO_DISPLAY;
+  }
+  return display;
+};
+
+bool createHeadlessContext(int major, int minor, bool coreProfile)
+{
+  headlessDisplay = openHeadlessDisplay();
+  if (headlessDisplay == EGL_NO_DISPLAY || !eglBindAPI(EGL_OPENGL_API))
+  {
+    std::cerr << "Failed to initialize a headless EGL display" << std::endl;
+    return false;
+  }
+
+  EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+  EGLConfig config = NULL;
+  EGLint count = 0;
+  eglChooseConfig(headlessDisplay, configAttributes, &config, 1, &count);
+
+  EGLint contextAttributes[] = {
+      EGL_CONTEXT_MAJOR_VERSION, major,
+      EGL_CONTEXT_MINOR_VERSION, minor,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK,
+      coreProfile ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+      EGL_NONE};
+  headlessContext = eglCreateContext(headlessDisplay, count > 0 ? config : (EGLConfig)0, EGL_NO_CONTEXT, contextAttributes);
+  if (headlessContext == EGL_NO_CONTEXT)
+  {
+    std::cerr << "Failed to create a headless OpenGL " << major << "." << minor << " context" << std::endl;
+    return false;
+  }
+
+  if (!eglMakeCurrent(headlessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, headlessContext))
+  {
+    std::cerr << "Failed to make the headless context current" << std::endl;
+    destroyHeadlessContext();
+    return false;
+  }
+  return true;
+};
+
+void destroyHeadlessContext()
+{
+  if (headlessDisplay == EGL_NO_DISPLAY)
+    return;
+  eglMakeCurrent(headlessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  if (headlessContext != EGL_NO_CONTEXT)
+    eglDestroyContext(headlessDisplay, headlessContext);
+  eglTerminate(headlessDisplay);
+  headlessContext = EGL_NO_CONTEXT;
+  headlessDisplay = EGL_NO_DISPLAY;
+};
+
+#else
+
+bool createHeadlessContext(int major, int minor, bool coreProfile)
+{
+  (void)major;
+  (void)minor;
+  (void)coreProfile;
+  std::cerr << "Headless OpenGL contexts are not supported by this build" << std::endl;
+  return false;
+};
+
+void destroyHeadlessContext(){};
+
+#endif
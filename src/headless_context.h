@@ -0,0 +1,31 @@
+/**
+ * @file headless_context.h
+ * @brief Creates an OpenGL context without a window.
+ *
+ * This file declares the functions used by tools that need OpenGL but must
+ * run without a display, such as the microbenchmarks. The context has no
+ * default framebuffer; rendering has to target a framebuffer object.
+ */
+
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+/**
+ * @brief Creates an OpenGL context without a window and makes it current.
+ * @param major Requested OpenGL major version.
+ * @param minor Requested OpenGL minor version.
+ * @param coreProfile If true, a core profile context is requested;
+ *                    otherwise a compatibility context is created.
+ * @return True if the context was created and made current.
+ *
+ * On Linux the context is created through EGL, on macOS through CGL. Only one
+ * headless context can exist at a time.
+ */
+bool createHeadlessContext(int major, int minor, bool coreProfile);
+
+/**
+ * @brief Destroys the context created by `createHeadlessContext`.
+ */
+void destroyHeadlessContext();
+
+#endif // HEADLESS_CONTEXT_H
@@ -0,0 +1,152 @@
+/**
+ * @file input_handler.cpp
+ * @brief Implements the queueing, recording and processing of the window's input events.
+ */
+
+#include "input_handler.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "keyboard_handler.h"
+#include "mouse_handler.h"
+
+/**
+ * @var inputQueue
+ * @brief Input events of the window not applied yet; empty at startup.
+ */
+InputQueue inputQueue;
+
+/**
+ * @var inputScheduled
+ * @brief Whether the timer processing the queue is registered.
+ */
+static bool inputScheduled = false;
+
+/**
+ * @var inputRecording
+ * @brief Whether the input events are being recorded.
+ */
+static bool inputRecording = false;
+
+/**
+ * @var inputRecordingStart
+ * @brief GLUT elapsed time when the recording started, in milliseconds.
+ */
+static int inputRecordingStart = 0;
+
+/**
+ * @var inputRecordingPath
+ * @brief Path of the input log written at exit.
+ */
+static std::string inputRecordingPath;
+
+/**
+ * @var inputRecordingLog
+ * @brief Events recorded so far.
+ */
+static InputLog inputRecordingLog;
+
+/**
+ * @brief Writes the recorded input log.
+ *
+ * This function is registered with `atexit`, since the application leaves
+ * its main loop through `exit`.
+ */
+static void writeInputRecording()
+{
+  if (writeInputLog(inputRecordingPath.c_str(), inputRecordingLog))
+    std::cout << "Input log written to " << inputRecordingPath << " (" << inputRecordingLog.records.size()
+              << " events)" << std::endl;
+  else
+    std::cerr << "Failed to write input log: " << inputRecordingPath << std::endl;
+};
+
+/**
+ * @brief Starts recording the input events of the window.
+ * @param path Path of the input log written when the application exits.
+ * @param flags Session options replayed with the log.
+ * @param width Current width of the window, in pixels.
+ * @param height Current height of the window, in pixels.
+ */
+void startInputRecording(const char *path, uint32_t flags, int width, int height)
+{
+  inputRecordingPath = path;
+  inputRecordingLog.flags = flags;
+  inputRecordingLog.width = (uint32_t)width;
+  inputRecordingLog.height = (uint32_t)height;
+  inputRecordingLog.records.clear();
+  inputRecordingStart = glutGet(GLUT_ELAPSED_TIME);
+  inputRecording = true;
+  atexit(writeInputRecording);
+};
+
+/**
+ * @brief Appends an input event to the running recording, if any.
+ * @param event The event.
+ */
+void recordInput(const InputEvent &event)
+{
+  if (inputRecording)
+    appendInputRecord(inputRecordingLog, (uint32_t)(glutGet(GLUT_ELAPSED_TIME) - inputRecordingStart), event);
+};
+
+/**
+ * @brief Queues an input event and schedules its processing.
+ * @param event The event.
+ *
+ * The event is recorded before it is queued, so that the log keeps every
+ * motion even though the queue merges them.
+ */
+void queueInput(const InputEvent &event)
+{
+  recordInput(event);
+  pushInputEvent(inputQueue, event);
+  if (inputScheduled)
+    return;
+
+  inputScheduled = true;
+  glutTimerFunc(0, processInput, 0);
+};
+
+/**
+ * @brief Applies input events to the scene and empties their queue.
+ * @param queue The events.
+ */
+void applyInputEvents(InputQueue &queue)
+{
+  for (size_t i = 0; i < queue.events.size(); ++i)
+  {
+    const InputEvent &event = queue.events[i];
+    switch (event.type)
+    {
+    case INPUT_KEY:
+      applyKey((unsigned char)event.key);
+      break;
+    case INPUT_MOTION:
+      applyMouseMotion(event.x, event.y);
+      break;
+    case INPUT_BUTTON:
+      applyMouseButton(event.key, event.state, event.x, event.y);
+      break;
+    default:
+      break;
+    }
+  }
+  clearInputQueue(queue);
+};
+
+/**
+ * @brief Applies the queued input events and requests a redraw.
+ * @param value Unused parameter for timer function.
+ */
+void processInput(int value)
+{
+  inputScheduled = false;
+
+  applyInputEvents(inputQueue);
+  startSimulationTimer();
+
+  requestRedraw(REDRAW_INPUT);
+};
@@ -0,0 +1,79 @@
+/**
+ * @file input_handler.h
+ * @brief Queues the input events of the window and applies them once per frame.
+ *
+ * This file declares the GLUT side of the input queue. The keyboard and
+ * mouse callbacks only queue their events; the first one of a main loop
+ * iteration registers a zero-delay timer, which GLUT calls once every
+ * pending window event has been delivered. It applies the queued events in
+ * order, with the mouse motions merged, then requests a single redraw,
+ * which is only posted if the events changed what the window shows. A timer
+ * is used rather than the idle callback, which stays free for the benchmark
+ * script, and no polling happens between events.
+ *
+ * While a recording runs, every event is also appended to an input log with
+ * the time it was received, and the log is written when the application
+ * exits, so that `replay_runner` can play the session again.
+ */
+
+#ifndef INPUT_HANDLER_H
+#define INPUT_HANDLER_H
+
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+#include "input_log.h"
+#include "input_queue.h"
+#include "redraw_scheduler.h"
+
+/**
+ * @var inputQueue
+ * @brief Input events of the window not applied yet.
+ */
+extern InputQueue inputQueue;
+
+/**
+ * @brief Starts recording the input events of the window.
+ * @param path Path of the input log written when the application exits.
+ * @param flags Session options replayed with the log, a combination of `InputLogFlag`.
+ * @param width Current width of the window, in pixels.
+ * @param height Current height of the window, in pixels.
+ */
+void startInputRecording(const char *path, uint32_t flags, int width, int height);
+
+/**
+ * @brief Appends an input event to the running recording, if any.
+ * @param event The event; window resizes are recorded as `INPUT_RESIZE`.
+ */
+void recordInput(const InputEvent &event);
+
+/**
+ * @brief Queues an input event and schedules its processing.
+ * @param event The event, as reported by a GLUT callback.
+ */
+void queueInput(const InputEvent &event);
+
+/**
+ * @brief Applies input events to the scene and empties their queue.
+ * @param queue The events, in the order they happened.
+ *
+ * Keys go to `applyKey`, motions to `applyMouseMotion` and buttons to
+ * `applyMouseButton`. No GLUT function is called, so replays apply their
+ * events the same way without a window.
+ */
+void applyInputEvents(InputQueue &queue);
+
+/**
+ * @brief Applies the queued input events and requests a redraw.
+ *
+ * The events are applied by `applyInputEvents`, then the simulation timer
+ * is restarted in case they resumed the simulation or started a flight.
+ *
+ * @param value Unused parameter for timer function.
+ */
+void processInput(int value);
+
+#endif // INPUT_HANDLER_H
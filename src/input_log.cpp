@@ -0,0 +1,97 @@
+/**
+ * @file input_log.cpp
+ * @brief Implements input logs.
+ */
+
+#include "input_log.h"
+
+#include <cstring>
+#include <fstream>
+
+/**
+ * @var INPUT_LOG_MAGIC
+ * @brief First bytes of every input log file.
+ */
+static const char INPUT_LOG_MAGIC[4] = {'S', 'I', 'N', 'P'};
+
+/**
+ * @brief Appends an event to a log.
+ * @param log The log.
+ * @param time Time the event was received, in milliseconds since the recording started.
+ * @param event The event.
+ */
+void appendInputRecord(InputLog &log, uint32_t time, const InputEvent &event)
+{
+  InputRecord record;
+  record.time = time;
+  record.type = (uint8_t)event.type;
+  record.key = (uint8_t)event.key;
+  record.state = (uint8_t)event.state;
+  record.unused = 0;
+  record.x = (int16_t)event.x;
+  record.y = (int16_t)event.y;
+  log.records.push_back(record);
+};
+
+/**
+ * @brief Returns the event stored in a record.
+ * @param record The record.
+ * @return The event.
+ */
+InputEvent inputRecordEvent(const InputRecord &record)
+{
+  InputEvent event = {(InputEventType)record.type, record.key, record.state, record.x, record.y};
+  return event;
+};
+
+/**
+ * @brief Writes a log to a file.
+ * @param filename Path to the file.
+ * @param log The log to write.
+ * @return True if the file was written successfully.
+ */
+bool writeInputLog(const char *filename, const InputLog &log)
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  uint32_t header[5] = {INPUT_LOG_VERSION, log.flags, log.width, log.height, (uint32_t)log.records.size()};
+  file.write(INPUT_LOG_MAGIC, sizeof(INPUT_LOG_MAGIC));
+  file.write((const char *)header, sizeof(header));
+  if (!log.records.empty())
+    file.write((const char *)&log.records[0], log.records.size() * sizeof(InputRecord));
+  return (bool)file;
+};
+
+/**
+ * @brief Reads a log from a file.
+ * @param filename Path to the file.
+ * @param log The log that receives the contents of the file.
+ * @return True if the file exists, has the current version and the expected size.
+ */
+bool readInputLog(const char *filename, InputLog &log)
+{
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file)
+    return false;
+  std::streamoff fileSize = file.tellg();
+  file.seekg(0);
+
+  char magic[4];
+  uint32_t header[5];
+  file.read(magic, sizeof(magic));
+  file.read((char *)header, sizeof(header));
+  if (!file || memcmp(magic, INPUT_LOG_MAGIC, sizeof(magic)) != 0 || header[0] != INPUT_LOG_VERSION)
+    return false;
+  if ((uint64_t)fileSize != sizeof(magic) + sizeof(header) + (uint64_t)header[4] * sizeof(InputRecord))
+    return false;
+
+  log.flags = header[1];
+  log.width = header[2];
+  log.height = header[3];
+  log.records.resize(header[4]);
+  if (!log.records.empty())
+    file.read((char *)&log.records[0], log.records.size() * sizeof(InputRecord));
+  return (bool)file;
+};
@@ -0,0 +1,99 @@
+/**
+ * @file input_log.h
+ * @brief Declares input logs, recordings of the input events of a session.
+ *
+ * An input log stores every input event of an interactive session with the
+ * time it was received, together with what the replay needs to start from
+ * the same state: the renderer backend, the lighting and the window size.
+ * Replaying a log at fixed time steps renders the same frames on every run,
+ * so a recorded session that triggered a slowdown becomes a reproducible
+ * benchmark.
+ *
+ * An input log file starts with the 4-byte magic `SINP`, followed by the
+ * version, the flags, the window width and height and the record count as
+ * 32-bit unsigned integers in little-endian order, then the 12-byte records.
+ */
+
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "input_queue.h"
+
+/**
+ * @def INPUT_LOG_VERSION
+ * @brief Version of the input log file format written by `writeInputLog`.
+ */
+#define INPUT_LOG_VERSION 1
+
+/**
+ * @enum InputLogFlag
+ * @brief Session options stored in the flags of an input log.
+ */
+enum InputLogFlag
+{
+  INPUT_LOG_CORE_RENDERER = 1 << 0, ///< The session drew with the core backend.
+  INPUT_LOG_LIGHTING = 1 << 1       ///< The session started with the Sun's lighting on.
+};
+
+/**
+ * @struct InputRecord
+ * @brief One event of an input log, in its file layout.
+ */
+struct InputRecord
+{
+  uint32_t time;  ///< Time the event was received, in milliseconds since the recording started.
+  uint8_t type;   ///< Kind of event, an `InputEventType`.
+  uint8_t key;    ///< ASCII code of the key, or the mouse button.
+  uint8_t state;  ///< Whether the button was pressed or released.
+  uint8_t unused; ///< Padding, always 0.
+  int16_t x;      ///< Horizontal cursor position, or the window width.
+  int16_t y;      ///< Vertical cursor position, or the window height.
+};
+
+/**
+ * @struct InputLog
+ * @brief Recorded input session, kept in CPU memory.
+ */
+struct InputLog
+{
+  uint32_t flags;                   ///< Session options, a combination of `InputLogFlag`.
+  uint32_t width;                   ///< Width of the window when the recording started, in pixels.
+  uint32_t height;                  ///< Height of the window when the recording started, in pixels.
+  std::vector<InputRecord> records; ///< Events, in the order they were received.
+};
+
+/**
+ * @brief Appends an event to a log.
+ * @param log The log.
+ * @param time Time the event was received, in milliseconds since the recording started.
+ * @param event The event.
+ */
+void appendInputRecord(InputLog &log, uint32_t time, const InputEvent &event);
+
+/**
+ * @brief Returns the event stored in a record.
+ * @param record The record.
+ * @return The event, as it was queued.
+ */
+InputEvent inputRecordEvent(const InputRecord &record);
+
+/**
+ * @brief Writes a log to a file.
+ * @param filename Path to the file.
+ * @param log The log to write.
+ * @return True if the file was written successfully.
+ */
+bool writeInputLog(const char *filename, const InputLog &log);
+
+/**
+ * @brief Reads a log from a file.
+ * @param filename Path to the file.
+ * @param log The log that receives the contents of the file.
+ * @return True if the file exists, has the current version and the expected size.
+ */
+bool readInputLog(const char *filename, InputLog &log);
+
+#endif // INPUT_LOG_H
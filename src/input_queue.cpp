@@ -0,0 +1,31 @@
+/**
+ * @file input_queue.cpp
+ * @brief Implements the queue of raw input events.
+ */
+
+#include "input_queue.h"
+
+/**
+ * @brief Appends an event to a queue.
+ * @param queue The queue.
+ * @param event The event.
+ */
+void pushInputEvent(InputQueue &queue, const InputEvent &event)
+{
+  if (event.type == INPUT_MOTION && !queue.events.empty() && queue.events.back().type == INPUT_MOTION)
+  {
+    queue.events.back() = event;
+    return;
+  }
+
+  queue.events.push_back(event);
+};
+
+/**
+ * @brief Removes all events from a queue, keeping its memory.
+ * @param queue The queue to clear.
+ */
+void clearInputQueue(InputQueue &queue)
+{
+  queue.events.clear();
+};
@@ -0,0 +1,71 @@
+/**
+ * @file input_queue.h
+ * @brief Declares the queue of raw input events.
+ *
+ * The window system callbacks do not act on the scene: they append the raw
+ * keyboard and mouse events to a queue, which the application drains once
+ * per frame. Consecutive mouse motions are merged as they are queued, since
+ * only the total movement between two frames matters, so a high-rate mouse
+ * costs one camera update per frame instead of one per event. The queue
+ * does not depend on the window system, so whatever drains it, such as a
+ * replay or another thread, does not need a window.
+ */
+
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <vector>
+
+/**
+ * @enum InputEventType
+ * @brief Kinds of input events.
+ */
+enum InputEventType
+{
+  INPUT_KEY = 0, ///< A key was pressed.
+  INPUT_MOTION,  ///< The mouse moved with a button pressed.
+  INPUT_BUTTON,  ///< A mouse button was pressed or released.
+  INPUT_RESIZE   ///< The window was resized to `x` by `y` pixels; only recorded, never queued.
+};
+
+/**
+ * @struct InputEvent
+ * @brief Raw input event, with the values the window system reported.
+ */
+struct InputEvent
+{
+  InputEventType type; ///< Kind of event.
+  int key;             ///< ASCII code of the key, or the mouse button.
+  int state;           ///< Whether the button was pressed or released; 0 for other events.
+  int x;               ///< Horizontal cursor position, in pixels from the left of the window.
+  int y;               ///< Vertical cursor position, in pixels from the top of the window.
+};
+
+/**
+ * @struct InputQueue
+ * @brief Input events received since the queue was last drained, oldest first.
+ */
+struct InputQueue
+{
+  std::vector<InputEvent> events; ///< Queued events.
+};
+
+/**
+ * @brief Appends an event to a queue.
+ * @param queue The queue.
+ * @param event The event.
+ *
+ * A motion that directly follows another one replaces it: motions report
+ * absolute cursor positions, so the last one carries the movement of both.
+ * Motions separated by a key or a button stay apart, so every event is
+ * applied in the order it happened.
+ */
+void pushInputEvent(InputQueue &queue, const InputEvent &event);
+
+/**
+ * @brief Removes all events from a queue, keeping its memory.
+ * @param queue The queue to clear.
+ */
+void clearInputQueue(InputQueue &queue);
+
+#endif // INPUT_QUEUE_H
@@ -4,83 +4,52 @@
  *
  * This file provides the implementation of functions for handling keyboard
  * input to control various aspects of the application, such as camera zoom,
- * orbital visibility, and simulation state.
+ * orbital visibility, and simulation state. The GLUT callback only queues
+ * the keys; they are applied with the other input events of the frame.
  */
 
 #include "keyboard_handler.h"
 
-/**
- * @var showOrbits
- * @brief Flag to toggle orbital visibility.
- *
- * This variable indicates whether the orbital paths of celestial bodies
- * are visible or hidden.
- */
-bool showOrbits = false;
-
-/**
- * @var cameraDistance
- * @brief Distance of the camera from the target.
- *
- * This variable represents the distance between the camera and the point
- * it is observing, affecting the zoom level.
- */
-float cameraDistance = 50.0;
+#include <algorithm>
 
 /**
- * @var selectedElement
- * @brief Index of the currently selected celestial body.
- *
- * This variable represents the index of the currently selected planet
- * or celestial body, used for highlighting or focusing. A value of -1
- * indicates no selection.
- */
-int selectedElement = -1;
-
-/**
- * @var paused
- * @brief Flag to toggle simulation pause state.
+ * @brief Adjusts the camera zoom level.
+ * @param out If true, zooms out; otherwise, zooms in.
  *
- * This variable indicates whether the simulation is currently paused
- * or running.
+ * This function adjusts the camera distance based on the zoom direction,
+ * down to just above the surface of the camera's target when the renderer
+ * allows it.
  */
-bool paused = false;
+static void zoom(bool out)
+{
+  zoomCamera(scene.camera, out, cameraMinDistance(renderer, scene));
+};
 
 /**
- * @brief Adjusts the camera zoom level.
- * @param out If true, zooms out; otherwise, zooms in.
- *
- * This function adjusts the camera distance based on the zoom direction.
- * The distance is clamped between 5.0 and 100.0 units.
+ * @brief Changes the time scale and prints the new one.
+ * @param steps Number of steps to speed the simulation up, or to slow it
+ *              down if negative.
  */
-void zoom(bool out)
+static void warp(int steps)
 {
-  if (!out)
-  {
-    cameraDistance -= 1.0;
-    if (cameraDistance < 5.0)
-      cameraDistance = 5.0;
-  }
-  else
-  {
-    cameraDistance += 1.0;
-    if (cameraDistance > 100.0)
-      cameraDistance = 100.0;
-  }
-  glutPostRedisplay();
+  warpSimulation(scene.simulation, steps);
+  std::cout << "Time scale: " << (scene.simulation.reversed ? "-" : "") << (long long)scene.simulation.timeScale << "x"
+            << std::endl;
 };
 
 /**
- * @brief Handles keyboard input to control application features.
+ * @brief Applies a key press to the application.
  * @param key The ASCII code of the pressed key.
- * @param x The X-coordinate of the mouse cursor.
- * @param y The Y-coordinate of the mouse cursor.
  *
- * This function is called when a key is pressed. It processes the key input
- * to perform actions such as zooming the camera, toggling orbital visibility,
- * selecting celestial bodies, and pausing or resuming the simulation.
+ * This function processes the key input to perform actions such as zooming
+ * the camera, toggling orbital visibility, selecting celestial bodies,
+ * toggling the Sun's lighting and the true scale, and pausing or resuming the
+ * simulation or changing its speed and direction, and bookmarking or
+ * restoring the scene state. Selecting a body flies the camera to it. No GLUT
+ * function is called, so that replays can apply keys without a window; the
+ * caller restarts the simulation timer.
  */
-void keyPressed(unsigned char key, int x, int y)
+void applyKey(unsigned char key)
 {
   switch (key)
   {
@@ -97,53 +66,77 @@ void keyPressed(unsigned char key, int x, int y)
     break;
   case 'O':
   case 'o':
-    showOrbits = !showOrbits;
+    scene.showOrbits = !scene.showOrbits;
     break;
   case '0':
-    cameraDistance = 10;
-    selectedElement = 0;
-    break;
   case '1':
-    cameraDistance = 10;
-    selectedElement = 1;
-    break;
   case '2':
-    cameraDistance = 10;
-    selectedElement = 2;
-    break;
   case '3':
-    cameraDistance = 10;
-    selectedElement = 3;
-    break;
   case '4':
-    cameraDistance = 10;
-    selectedElement = 4;
-    break;
   case '5':
-    cameraDistance = 10;
-    selectedElement = 5;
-    break;
   case '6':
-    cameraDistance = 10;
-    selectedElement = 6;
-    break;
   case '7':
-    cameraDistance = 10;
-    selectedElement = 7;
-    break;
   case '8':
-    cameraDistance = 10;
-    selectedElement = 8;
+    flyCamera(renderer, scene, key - '0', 10);
     break;
   case 'a':
   case 'A':
-    selectedElement = -1;
+    flyCamera(renderer, scene, -1, scene.camera.distance);
     break;
   case 'p':
   case 'P':
-    paused = !paused;
+    scene.simulation.paused = !scene.simulation.paused;
+    break;
+  case '+':
+  case '=':
+    warp(1);
+    break;
+  case '-':
+  case '_':
+    warp(-1);
+    break;
+  case 'r':
+  case 'R':
+    scene.simulation.reversed = !scene.simulation.reversed;
+    warp(0);
+    break;
+  case 'l':
+  case 'L':
+    renderer.lighting = !renderer.lighting;
+    break;
+  case 'b':
+  case 'B':
+    saveSnapshot();
+    break;
+  case 'n':
+  case 'N':
+    restoreNextSnapshot();
+    break;
+  case 't':
+  case 'T':
+    // The flight's path is measured in the units of the previous scale.
+    scene.trueScale = !scene.trueScale;
+    scene.flight.active = false;
     break;
   default:
     break;
   }
-};
\ No newline at end of file
+
+  // A new target or scale may leave the camera below the target's surface.
+  scene.camera.distance = std::max(scene.camera.distance, cameraMinDistance(renderer, scene));
+};
+
+/**
+ * @brief Handles keyboard input to control application features.
+ * @param key The ASCII code of the pressed key.
+ * @param x The X-coordinate of the mouse cursor.
+ * @param y The Y-coordinate of the mouse cursor.
+ *
+ * This function is called when a key is pressed. It queues the key, which
+ * is applied with the other input events of the frame.
+ */
+void keyPressed(unsigned char key, int x, int y)
+{
+  InputEvent event = {INPUT_KEY, key, 0, x, y};
+  queueInput(event);
+};
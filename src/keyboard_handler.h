@@ -18,50 +18,40 @@
 
 #include <iostream>
 
-/**
- * @var showOrbits
- * @brief Flag to toggle orbital visibility.
- *
- * This external boolean variable indicates whether the orbital paths of
- * celestial bodies are visible or hidden.
- */
-extern bool showOrbits;
+#include "input_handler.h"
+#include "redraw_scheduler.h"
+#include "renderer.h"
+#include "scene.h"
+#include "snapshot_handler.h"
 
 /**
- * @var cameraDistance
- * @brief Distance of the camera from the target.
+ * @var scene
+ * @brief State of the displayed scene.
  *
- * This external float variable represents the distance between the camera
- * and the point it is observing, affecting the zoom level.
+ * This external object holds the simulation, camera and view options that
+ * the keyboard controls: camera zoom, orbital visibility, the selected
+ * celestial body and the pause state.
  */
-extern float cameraDistance;
+extern SceneState scene;
 
 /**
- * @var zoomExcess
- * @brief Additional zoom factor beyond the default.
- *
- * This external float variable represents the amount of additional zoom
- * applied to the camera view, beyond the default zoom level.
+ * @var renderer
+ * @brief Renderer drawing the scene, whose lighting the keyboard toggles.
  */
-extern float zoomExcess;
+extern Renderer renderer;
 
 /**
- * @var selectedElement
- * @brief Index of the currently selected celestial body.
- *
- * This external integer variable represents the index of the currently
- * selected planet or celestial body, used for highlighting or focusing.
- */
-extern int selectedElement;
-
-/**
- * @var paused
- * @brief Flag to toggle simulation pause state.
+ * @brief Applies a key press to the application.
+ * @param key The ASCII code of the pressed key.
  *
- * This external boolean variable indicates whether the simulation is currently
- * paused or running.
+ * This function updates various aspects of the application based on the key
+ * input, such as toggling orbital visibility, adjusting camera zoom,
+ * selecting celestial bodies, toggling the Sun's lighting and the true scale,
+ * pausing or resuming the simulation, changing its time scale or direction,
+ * and bookmarking the scene state or restoring a bookmark. The caller
+ * restarts the simulation timer and requests the redraw.
  */
-extern bool paused;
+void applyKey(unsigned char key);
 
 /**
  * @brief Handles keyboard input for controlling the application.
@@ -69,10 +59,9 @@ extern bool paused;
  * @param x The X-coordinate of the mouse cursor.
  * @param y The Y-coordinate of the mouse cursor.
  *
- * This function is called when a key is pressed. It updates various aspects
- * of the application based on the key input, such as toggling orbital visibility,
- * adjusting camera zoom, selecting celestial bodies, and pausing or resuming
- * the simulation.
+ * This function is called when a key is pressed. It queues the key for
+ * `processInput`, which applies it once per frame with the other input
+ * events.
  */
 void keyPressed(unsigned char key, int x, int y);
 
@@ -2,34 +2,49 @@
  * @file main.cpp
  * @brief Main entry point for the Solar System simulation application.
  *
- * This file contains the main function and the core rendering logic for
- * the Solar System simulation, including initialization, drawing, and
- * updating the scene. It also handles user input via keyboard and mouse.
+ * This file contains the main function and the GLUT front end of the Solar
+ * System simulation: window creation, the display and reshape callbacks,
+ * and the registration of the keyboard and mouse handlers, whose events
+ * `input_handler` queues and applies once per frame. Redraws are
+ * scheduled by `redraw_scheduler`; the simulation and the rendering itself
+ * live in the `solar_core` library. Recorded sessions are replayed without
+ * a window by `replay_runner`.
  */
 
 #define GL_SILENCE_DEPRECATION
 
 #include <iostream>
-#include <cmath>
+#include <cstring>
 
 #ifdef __APPLE__
 #include <GLUT/glut.h>
 #else
-#include <GL/glut.h>
+#include <GL/freeglut.h>
 #endif
 
-#include "stb_image.h"
-#include "textures.h"
-#include "planet_radii.h"
-#include "orbit_radii.h"
-#include "planet_speeds.h"
+#include "benchmark_runner.h"
+#include "keyboard_handler.h"
+#include "mouse_handler.h"
+#include "redraw_scheduler.h"
+#include "renderer.h"
+#include "replay_runner.h"
+#include "snapshot_handler.h"
+#include "scene.h"
 
-#include "texture_loader.cpp"
-#include "mouse_handler.cpp"
-#include "keyboard_handler.cpp"
+/**
+ * @var scene
+ * @brief State of the displayed scene.
+ *
+ * This object holds the simulation, camera and view options shared by the
+ * display callback and the input handlers.
+ */
+SceneState scene = initialSceneState();
 
-GLuint sunTexture, mercuryTexture, venusTexture, earthTexture, marsTexture, jupiterTexture, saturnTexture, saturnRingTexture, uranusTexture, neptuneTexture;
-float rotationAngle = 0.0;
+/**
+ * @var renderer
+ * @brief Renderer drawing the scene into the window.
+ */
+Renderer renderer;
 
 /**
  * @brief Prints the command menu for user instructions.
@@ -48,7 +63,13 @@ void printCommandMenu()
   std::cout << "🔍 Zoom in: press 'w'\n";
   std::cout << "🔎 Zoom out: press 's'\n";
   std::cout << "⏸️ Pause animation: press 'p'\n";
+  std::cout << "⏩ Speed up / slow down time: press '+' / '-'\n";
+  std::cout << "⏪ Reverse time: press 'r'\n";
+  std::cout << "💡 Toggle sunlight: press 'l'\n";
+  std::cout << "📏 Toggle true scale: press 't'\n";
+  std::cout << "🔖 Bookmark state / restore next bookmark: press 'b' / 'n'\n";
   std::cout << "🖱️ Move camera: press and hold the left mouse button and drag\n";
+  std::cout << "🎯 Select a body: click it\n";
   std::cout << "🌐 View all elements: press 'A'\n";
   std::cout << "🌍 View individual element:\n";
   std::cout << "  0️⃣ SUN\n";
@@ -64,237 +85,73 @@ void printCommandMenu()
 };
 
 /**
- * @brief Initializes OpenGL settings and loads textures.
- *
- * This function sets up OpenGL settings, such as enabling texture mapping
- * and depth testing. It also loads textures for all celestial bodies and
- * prints the command menu.
- */
-void init()
-{
-  glEnable(GL_TEXTURE_2D);
-  glClearColor(0.0, 0.0, 0.0, 0.0);
-  glEnable(GL_DEPTH_TEST);
-
-  sunTexture = loadTexture(SUN_TEXTURE);
-  mercuryTexture = loadTexture(MERCURY_TEXTURE);
-  venusTexture = loadTexture(VENUS_TEXTURE);
-  earthTexture = loadTexture(EARTH_TEXTURE);
-  marsTexture = loadTexture(MARS_TEXTURE);
-  jupiterTexture = loadTexture(JUPITER_TEXTURE);
-  saturnTexture = loadTexture(SATURN_TEXTURE);
-  uranusTexture = loadTexture(URANUS_TEXTURE);
-  neptuneTexture = loadTexture(NEPTUNE_TEXTURE);
-  saturnRingTexture = loadTexture(SATURN_RING_TEXTURE);
-
-  printCommandMenu();
-};
-
-/**
- * @brief Draws a textured sphere with the given texture and radius.
- * @param texture The texture to apply to the sphere.
- * @param radius The radius of the sphere.
- *
- * This function draws a textured sphere using the specified texture and
- * radius, representing a celestial body.
- */
-void drawTexturedSphere(GLuint texture, float radius)
-{
-  glRotatef(90.0f, 1.0f, 0.0f, 0.0f);
-  GLUquadric *quad = gluNewQuadric();
-  gluQuadricTexture(quad, GL_TRUE);
-  glBindTexture(GL_TEXTURE_2D, texture);
-  gluSphere(quad, radius, 36, 18);
-  gluDeleteQuadric(quad);
-};
-
-/**
- * @brief Draws an orbit with the given radius.
- * @param radius The radius of the orbit.
+ * @brief Creates the application window with a context suited to a backend.
+ * @param backend The renderer backend the context is created for.
+ * @return The GLUT window ID.
  *
- * This function draws a circular orbit using line loops, representing
- * the path on which a planet revolves around a star.
+ * The core backend requests an OpenGL 3.3 core-profile context (3.2 core on
+ * macOS, which provides the newest supported version); the legacy backend
+ * requests a default context.
  */
-void drawOrbit(float radius)
+int createWindow(RendererBackend backend)
 {
-  glBegin(GL_LINE_LOOP);
-  for (int i = 0; i < 360; ++i)
-  {
-    float theta = i * 3.14159f / 180.0f;
-    glVertex3f(radius * cos(theta), 0.0f, radius * sin(theta));
-  }
-  glEnd();
-};
-
-/**
- * @brief Draws the sun with optional lighting.
- * @param withLighting If true, lighting effects are enabled; otherwise, they are disabled.
- *
- * This function draws the sun using the sun texture. It also applies a
- * rotation based on the current rotation angle. Lighting effects are applied
- * if specified.
- */
-void drawSun(bool withLighting)
-{
-  if (!withLighting)
+  unsigned int displayMode = GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH;
+#ifdef __APPLE__
+  if (backend == RENDERER_CORE)
+    displayMode |= GLUT_3_2_CORE_PROFILE;
+#else
+  if (backend == RENDERER_CORE)
   {
-    glDisable(GL_LIGHTING);
-    glDisable(GL_LIGHT0);
-    return;
+    glutInitContextVersion(3, 3);
+    glutInitContextProfile(GLUT_CORE_PROFILE);
   }
-
-  glPushMatrix();
-  glRotatef(rotationAngle, 0.0, 1.0, 0.0);
-  drawTexturedSphere(sunTexture, SUN_RADIUS);
-  glPopMatrix();
-};
-
-/**
- * @brief Draws Saturn's rings.
- * @param innerRadius The inner radius of the rings.
- * @param outerRadius The outer radius of the rings.
- *
- * This function draws Saturn's rings as a series of textured disks. The
- * transparency and spacing of the disks create the appearance of rings.
- */
-void drawSaturnRing(float innerRadius, float outerRadius)
-{
-  int numDisks = 25;
-  GLUquadric *quad = gluNewQuadric();
-  glBindTexture(GL_TEXTURE_2D, saturnTexture);
-  gluQuadricTexture(quad, GL_TRUE);
-
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  float radiusStep = (outerRadius - innerRadius) / numDisks;
-
-  for (int i = 0; i < numDisks; ++i)
+  else
   {
-    float offset = 0.0;
-    if (i % 2 == 0)
-    {
-      offset = .5;
-    }
-    float currentInnerRadius = innerRadius + i * radiusStep + offset;
-    float currentOuterRadius = currentInnerRadius + radiusStep;
-
-    float alpha = (float)i / (float)(numDisks - 1);
-
-    glColor4f(1.0f, 1.0f, 1.0f, alpha);
-
-    glPushMatrix();
-    glRotatef(10.0f, 1.0f, 0.0f, 0.0f);
-    gluDisk(quad, currentInnerRadius, currentOuterRadius, 64, 64);
-    glPopMatrix();
+    glutInitContextVersion(1, 0);
+    glutInitContextProfile(0);
   }
-
-  glDisable(GL_BLEND);
-
-  gluDeleteQuadric(quad);
+#endif
+  glutInitDisplayMode(displayMode);
+  glutInitWindowSize(1000, 800);
+  glutInitWindowPosition(250, 100);
+  return glutCreateWindow("Solar System");
 };
 
 /**
- * @brief Draws a planet with the specified parameters.
- * @param texture The texture to apply to the planet.
- * @param orbitRadius The radius of the planet's orbit around the sun.
- * @param orbitSpeed The speed of the planet's orbit.
- * @param planetRadius The radius of the planet.
- * @param name The name of the planet (for logging purposes).
- * @param hasRing If true, a ring is drawn around the planet (default is false).
- * @param innerRingRadius The inner radius of the ring (default is 0.0f).
- * @param outerRingRadius The outer radius of the ring (default is 0.0f).
+ * @brief Creates the window, initializes the renderer and prints the command menu.
+ * @param backend The renderer backend requested on the command line.
  *
- * This function draws a planet with the specified texture and radius, and
- * optionally draws a ring around the planet if specified.
+ * This function sets up OpenGL and loads the textures of all celestial
+ * bodies through the renderer, then prints the command menu. If the core
+ * backend cannot run in the created context, the window is recreated with a
+ * default context and the legacy backend is used instead.
  */
-void drawPlanet(GLuint texture, float orbitRadius, float orbitSpeed, float planetRadius, const char *name, bool hasRing = false, float innerRingRadius = 0.0f, float outerRingRadius = 0.0f)
+void init(RendererBackend backend)
 {
-  if (showOrbits)
-    drawOrbit(orbitRadius);
-
-  glPushMatrix();
-  glRotatef(rotationAngle * orbitSpeed, 0.0, 1.0, 0.0);
-  glTranslatef(orbitRadius, 0.0, 0.0);
-  drawTexturedSphere(texture, planetRadius);
-
-  if (hasRing)
+  int window = createWindow(backend);
+  if (!initRenderer(renderer, backend))
   {
-    drawSaturnRing(innerRingRadius, outerRingRadius);
+    std::cerr << "Falling back to the legacy renderer" << std::endl;
+    glutDestroyWindow(window);
+    createWindow(RENDERER_LEGACY);
+    initRenderer(renderer, RENDERER_LEGACY);
   }
 
-  glPopMatrix();
+  printCommandMenu();
 };
 
 /**
  * @brief Displays the current frame.
  *
- * This function clears the color and depth buffers, sets up the camera
- * view, and draws all celestial bodies based on the current state. It also
- * handles the selection of individual planets or the entire solar system.
+ * This function renders the scene, presents the frame and records it as
+ * the last frame drawn.
  */
 void display()
 {
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-  glLoadIdentity();
-  gluLookAt(cameraDistance * cos(cameraAngleY) * sin(cameraAngleX),
-            cameraDistance * sin(cameraAngleY),
-            cameraDistance * cos(cameraAngleY) * cos(cameraAngleX),
-            0.0, 0.0, 0.0,
-            0.0, 1.0, 0.0);
-
-  switch (selectedElement)
-  {
-  case 0:
-    drawSun(true);
-    break;
-  case 1:
-    drawSun(false);
-    drawPlanet(mercuryTexture, 0.0, MERCURY_SPEED, MERCURY_RADIUS, "MERCURY");
-    break;
-  case 2:
-    drawSun(false);
-    drawPlanet(venusTexture, 0.0, VENUS_SPEED, VENUS_RADIUS, "VENUS");
-    break;
-  case 3:
-    drawSun(false);
-    drawPlanet(earthTexture, 0.0, EARTH_SPEED, EARTH_RADIUS, "EARTH");
-    break;
-  case 4:
-    drawSun(false);
-    drawPlanet(marsTexture, 0.0, MARS_SPEED, MARS_RADIUS, "MARS");
-    break;
-  case 5:
-    drawSun(false);
-    drawPlanet(jupiterTexture, 0.0, JUPITER_SPEED, JUPITER_RADIUS, "JUPITER");
-    break;
-  case 6:
-    drawSun(false);
-    drawPlanet(saturnTexture, 0.0, SATURN_SPEED, SATURN_RADIUS, "SATURN", true, SATURN_RADIUS * 1.2f, SATURN_RADIUS * 2.0f);
-    break;
-  case 7:
-    drawSun(false);
-    drawPlanet(uranusTexture, 0.0, URANUS_SPEED, URANUS_RADIUS, "URANUS");
-    break;
-  case 8:
-    drawSun(false);
-    drawPlanet(neptuneTexture, 0.0, NEPTUNE_SPEED, NEPTUNE_RADIUS, "NEPTUNE");
-    break;
-  default:
-    drawSun(true);
-    drawPlanet(mercuryTexture, MERCURY_ORBIT_RADIUS, MERCURY_SPEED, MERCURY_RADIUS, "MERCURY");
-    drawPlanet(venusTexture, VENUS_ORBIT_RADIUS, VENUS_SPEED, VENUS_RADIUS, "VENUS");
-    drawPlanet(earthTexture, EARTH_ORBIT_RADIUS, EARTH_SPEED, EARTH_RADIUS, "EARTH");
-    drawPlanet(marsTexture, MARS_ORBIT_RADIUS, MARS_SPEED, MARS_RADIUS, "MARS");
-    drawPlanet(jupiterTexture, JUPITER_ORBIT_RADIUS, JUPITER_SPEED, JUPITER_RADIUS, "JUPITER");
-    drawPlanet(saturnTexture, SATURN_ORBIT_RADIUS, SATURN_SPEED, SATURN_RADIUS, "SATURN", true, SATURN_RADIUS * 1.2f, SATURN_RADIUS * 2.0f);
-    drawPlanet(uranusTexture, URANUS_ORBIT_RADIUS, URANUS_SPEED, URANUS_RADIUS, "URANUS");
-    drawPlanet(neptuneTexture, NEPTUNE_ORBIT_RADIUS, NEPTUNE_SPEED, NEPTUNE_RADIUS, "NEPTUNE");
-    break;
-  }
+  renderScene(renderer, scene);
 
   glutSwapBuffers();
+  redrawDone();
 };
 
 /**
@@ -303,33 +160,15 @@ void display()
  * @param h The new height of the window.
  *
  * This function adjusts the viewport and projection matrix when the window
- * is resized to ensure the correct aspect ratio and perspective.
+ * is resized to ensure the correct aspect ratio and perspective, and
+ * requests a redraw. A running recording logs the new size.
  */
 void reshape(int w, int h)
 {
-  glViewport(0, 0, (GLsizei)w, (GLsizei)h);
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  gluPerspective(45.0, (GLfloat)w / (GLfloat)h, 1.0, 200.0);
-  glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
-};
-
-/**
- * @brief Updates the simulation state.
- * @param value Unused parameter for timer function.
- *
- * This function updates the rotation angle for animation and schedules
- * the next update call. It also checks if the simulation is paused or
- * running.
- */
-void update(int value)
-{
-  if (!paused)
-    rotationAngle += 0.5;
-
-  glutPostRedisplay();
-  glutTimerFunc(16, update, 0);
+  InputEvent event = {INPUT_RESIZE, 0, 0, w, h};
+  recordInput(event);
+  resizeRenderer(renderer, w, h);
+  requestRedraw(REDRAW_WINDOW);
 };
 
 /**
@@ -341,20 +180,99 @@ void update(int value)
  * This function initializes GLUT, sets up the window, and registers
  * callback functions for display, reshape, keyboard, and mouse events.
  * It then enters the GLUT main loop.
+ *
+ * Passing `--benchmark [report.json]` runs the deterministic benchmark
+ * script instead of the interactive simulation and writes the measured
+ * frame times to the given report (`benchmark.json` by default). Passing
+ * `--renderer core` draws with the OpenGL 3.3 core-profile backend instead
+ * of the fixed-function one (`--renderer legacy`, the default), and
+ * `--no-lighting` starts with the Sun's lighting turned off.
+ *
+ * Passing `--record log` writes the input events of the session to the
+ * given input log at exit; `--replay log [report.json]` plays such a log
+ * again without a window, on a fixed time step, and writes its frame times
+ * to the given report (`replay.json` by default) instead of starting GLUT.
+ * Passing `--snapshot file` resumes from the last state saved in the given
+ * snapshot file, appends bookmarks to it and saves the state at exit. It
+ * cannot be combined with `--record`, since a replay starts from the initial
+ * state without the file's bookmarks.
  */
 int main(int argc, char **argv)
 {
+  bool recording = false;
+  bool resuming = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+      return runReplay(argv[i + 1], i + 2 < argc && argv[i + 2][0] != '-' ? argv[i + 2] : "replay.json");
+    recording = recording || strcmp(argv[i], "--record") == 0;
+    resuming = resuming || strcmp(argv[i], "--snapshot") == 0;
+  }
+  if (recording && resuming)
+  {
+    std::cerr << "--record cannot be combined with --snapshot: replays start from the initial state" << std::endl;
+    return 1;
+  }
+
   glutInit(&argc, argv);
-  glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
-  glutInitWindowSize(1000, 800);
-  glutInitWindowPosition(250, 100);
-  glutCreateWindow("Solar System");
 
-  init();
+  const char *benchmarkReport = NULL;
+  const char *recordLog = NULL;
+  const char *snapshotFile = NULL;
+  RendererBackend backend = RENDERER_LEGACY;
+  bool lighting = true;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--benchmark") == 0)
+    {
+      benchmarkReport = "benchmark.json";
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+        benchmarkReport = argv[++i];
+    }
+    else if (strcmp(argv[i], "--renderer") == 0 && i + 1 < argc)
+    {
+      ++i;
+      if (strcmp(argv[i], "core") == 0)
+        backend = RENDERER_CORE;
+      else if (strcmp(argv[i], "legacy") != 0)
+        std::cerr << "Unknown renderer '" << argv[i] << "', using legacy" << std::endl;
+    }
+    else if (strcmp(argv[i], "--no-lighting") == 0)
+    {
+      lighting = false;
+    }
+    else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+    {
+      recordLog = argv[++i];
+    }
+    else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+    {
+      snapshotFile = argv[++i];
+    }
+  }
+
+  init(backend);
+  renderer.lighting = lighting;
 
   glutDisplayFunc(display);
   glutReshapeFunc(reshape);
-  glutTimerFunc(16, update, 0); // 60 FPS
+
+  if (benchmarkReport)
+  {
+    startBenchmark(scene, display, &renderer.stats, benchmarkReport);
+  }
+  else
+  {
+    if (recordLog)
+    {
+      uint32_t flags = (renderer.backend == RENDERER_CORE ? INPUT_LOG_CORE_RENDERER : 0) |
+                       (renderer.lighting ? INPUT_LOG_LIGHTING : 0);
+      startInputRecording(recordLog, flags, glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT));
+    }
+    if (snapshotFile)
+      openSnapshotFile(snapshotFile);
+    startSimulationTimer();
+  }
 
   glutKeyboardFunc(keyPressed);
 
@@ -0,0 +1,90 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implements read-only mapped files.
+ */
+
+#include "mapped_file.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/**
+ * @def SOLAR_HAVE_MMAP
+ * @brief Defined when files are memory-mapped rather than read.
+ */
+#define SOLAR_HAVE_MMAP
+#endif
+
+/**
+ * @brief Opens a file for reading.
+ * @param filename Path to the file.
+ * @param file Receives the contents.
+ * @return True if the file exists and could be mapped or read.
+ */
+bool openMappedFile(const char *filename, MappedFile &file)
+{
+  file.data = NULL;
+  file.size = 0;
+  file.mapping = NULL;
+  file.storage.clear();
+#ifdef SOLAR_HAVE_MMAP
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+  {
+    close(fd);
+    return false;
+  }
+  size_t size = (size_t)info.st_size;
+  if (size == 0)
+  {
+    close(fd);
+    return true;
+  }
+  void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return false;
+  file.mapping = mapping;
+  file.data = (const char *)mapping;
+  file.size = size;
+#else
+  std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+  if (!stream)
+    return false;
+  file.storage.resize((size_t)stream.tellg());
+  stream.seekg(0);
+  if (!file.storage.empty())
+    stream.read(&file.storage[0], (std::streamsize)file.storage.size());
+  if (!stream)
+  {
+    file.storage.clear();
+    return false;
+  }
+  file.data = file.storage.empty() ? NULL : &file.storage[0];
+  file.size = file.storage.size();
+#endif
+  return true;
+};
+
+/**
+ * @brief Releases the contents of a file.
+ * @param file The file to close; it is left empty.
+ */
+void closeMappedFile(MappedFile &file)
+{
+#ifdef SOLAR_HAVE_MMAP
+  if (file.mapping)
+    munmap(file.mapping, file.size);
+#endif
+  file.data = NULL;
+  file.size = 0;
+  file.mapping = NULL;
+  file.storage.clear();
+};
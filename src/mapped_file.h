@@ -0,0 +1,52 @@
+/**
+ * @file mapped_file.h
+ * @brief Declares read-only mapped files.
+ *
+ * The binary caches and save files are parsed in place rather than copied
+ * into their own structures. Where memory mapping is available the file is
+ * mapped read-only, so its pages are only loaded as they are read;
+ * elsewhere it is read whole into memory, and the callers see the same
+ * contiguous bytes either way.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct MappedFile
+ * @brief Contents of a file opened for reading.
+ *
+ * The contents start at the beginning of a mapping or of a heap block, so
+ * they are suitably aligned for any record type. A file read into `storage`
+ * must not be copied while `data` is in use, since the copy would point
+ * into the original.
+ */
+struct MappedFile
+{
+  const char *data;          ///< Contents of the file, or NULL when closed or empty.
+  size_t size;               ///< Size of the contents, in bytes.
+  void *mapping;             ///< Start of the mapping, or NULL when the file was read.
+  std::vector<char> storage; ///< Contents read without memory mapping.
+};
+
+/**
+ * @brief Opens a file for reading.
+ * @param filename Path to the file.
+ * @param file Receives the contents.
+ * @return True if the file exists and could be mapped or read.
+ *
+ * An empty file opens with a NULL `data`. On failure @p file is left empty.
+ * An open file must be closed before it is opened again.
+ */
+bool openMappedFile(const char *filename, MappedFile &file);
+
+/**
+ * @brief Releases the contents of a file.
+ * @param file The file to close; it is left empty.
+ */
+void closeMappedFile(MappedFile &file);
+
+#endif // MAPPED_FILE_H
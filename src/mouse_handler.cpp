@@ -4,28 +4,14 @@
  *
  * This file provides the implementation of functions for handling mouse
  * input, including mouse motion and button events, to control the camera's
- * position and orientation in the application.
+ * position and orientation in the application. The GLUT callbacks only
+ * queue the events; they are applied with the other input events of the
+ * frame.
  */
 
 #include "mouse_handler.h"
 
-/**
- * @var cameraAngleX
- * @brief Camera angle around the X-axis.
- *
- * This variable represents the rotation angle of the camera around the
- * X-axis, affecting the vertical view direction.
- */
-float cameraAngleX = 0.0;
-
-/**
- * @var cameraAngleY
- * @brief Camera angle around the Y-axis.
- *
- * This variable represents the rotation angle of the camera around the
- * Y-axis, affecting the horizontal view direction.
- */
-float cameraAngleY = 0.0;
+#include <cstdlib>
 
 /**
  * @var lastMouseX
@@ -55,61 +41,126 @@ int lastMouseY = 0;
 bool leftButtonPressed = false;
 
 /**
- * @brief Handles mouse motion events to adjust camera orientation.
+ * @var mouseDragged
+ * @brief Whether the current press of the left button is a drag.
+ *
+ * This variable is set once the cursor leaves the `MOUSE_CLICK_SLOP`
+ * square around the position where the button was pressed, so that
+ * releasing it does not select a body.
+ */
+bool mouseDragged = false;
+
+/**
+ * @var pressMouseX
+ * @brief X-coordinate of the mouse cursor when the left button was pressed.
+ */
+static int pressMouseX = 0;
+
+/**
+ * @var pressMouseY
+ * @brief Y-coordinate of the mouse cursor when the left button was pressed.
+ */
+static int pressMouseY = 0;
+
+/**
+ * @brief Selects the body under a point of the window, if any.
+ * @param x The X-coordinate of the point.
+ * @param y The Y-coordinate of the point.
+ *
+ * The body is picked in the last frame drawn, which is what the user
+ * clicked on, and the camera flies to it. Clicking empty space or the
+ * selected body changes nothing.
+ */
+static void selectBodyAt(int x, int y)
+{
+  int body = pickBody(renderer, x, y);
+  if (body < 0 || body == scene.selectedElement)
+    return;
+
+  flyCamera(renderer, scene, body, 10);
+};
+
+/**
+ * @brief Applies a mouse motion to the camera orientation.
  * @param x The X-coordinate of the mouse cursor.
  * @param y The Y-coordinate of the mouse cursor.
  *
- * This function is called when the mouse is moved. If the left mouse button
- * is pressed, it updates the camera's orientation based on the cursor's
+ * If the left mouse button is pressed, this function updates the camera's
+ * orientation based on the cursor's movement since the last applied
  * position. The camera angles are clamped to prevent excessive rotation.
  */
-void mouseMotion(int x, int y)
+void applyMouseMotion(int x, int y)
 {
   if (leftButtonPressed)
   {
-    int dx = x - lastMouseX;
-    int dy = y - lastMouseY;
+    if (abs(x - pressMouseX) > MOUSE_CLICK_SLOP || abs(y - pressMouseY) > MOUSE_CLICK_SLOP)
+      mouseDragged = true;
 
-    cameraAngleX += dx * 0.005;
-    cameraAngleY += dy * 0.005;
-
-    // Clamp cameraAngleY to prevent excessive vertical rotation
-    if (cameraAngleY > 1.5)
-      cameraAngleY = 1.5;
-    if (cameraAngleY < -1.5)
-      cameraAngleY = -1.5;
+    orbitCamera(scene.camera, x - lastMouseX, y - lastMouseY);
 
     lastMouseX = x;
     lastMouseY = y;
-
-    glutPostRedisplay();
   }
 };
 
 /**
- * @brief Handles mouse button events to toggle camera control.
+ * @brief Applies a mouse button event to the camera control.
  * @param button The mouse button that was pressed or released.
  * @param state The state of the mouse button (GLUT_DOWN or GLUT_UP).
  * @param x The X-coordinate of the mouse cursor.
  * @param y The Y-coordinate of the mouse cursor.
  *
- * This function is called when a mouse button is pressed or released. It
- * updates the state of the left mouse button and records the cursor position
- * when the button is pressed.
+ * This function updates the state of the left mouse button and records the
+ * cursor position when the button is pressed. A release that ends a click
+ * rather than a drag selects the body under the cursor.
  */
-void mouseButton(int button, int state, int x, int y)
+void applyMouseButton(int button, int state, int x, int y)
 {
   if (button == GLUT_LEFT_BUTTON)
   {
     if (state == GLUT_DOWN)
     {
       leftButtonPressed = true;
-      lastMouseX = x;
-      lastMouseY = y;
+      mouseDragged = false;
+      lastMouseX = pressMouseX = x;
+      lastMouseY = pressMouseY = y;
     }
     else
     {
       leftButtonPressed = false;
+      if (!mouseDragged)
+        selectBodyAt(x, y);
     }
   }
+};
+
+/**
+ * @brief Handles mouse motion events.
+ * @param x The X-coordinate of the mouse cursor.
+ * @param y The Y-coordinate of the mouse cursor.
+ *
+ * This function is called when the mouse is moved with a button pressed.
+ * It queues the motion, merged with the other motions of the frame.
+ */
+void mouseMotion(int x, int y)
+{
+  InputEvent event = {INPUT_MOTION, 0, 0, x, y};
+  queueInput(event);
+};
+
+/**
+ * @brief Handles mouse button events.
+ * @param button The mouse button that was pressed or released.
+ * @param state The state of the mouse button (GLUT_DOWN or GLUT_UP).
+ * @param x The X-coordinate of the mouse cursor.
+ * @param y The Y-coordinate of the mouse cursor.
+ *
+ * This function is called when a mouse button is pressed or released. It
+ * queues the event, which is applied with the other input events of the
+ * frame.
+ */
+void mouseButton(int button, int state, int x, int y)
+{
+  InputEvent event = {INPUT_BUTTON, button, state, x, y};
+  queueInput(event);
 };
\ No newline at end of file
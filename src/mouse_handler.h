@@ -3,7 +3,8 @@
  * @brief Handles mouse input for camera control.
  *
  * This file declares functions and external variables used for handling mouse
- * input to control the camera's position and orientation in the application.
+ * input to control the camera's position and orientation in the application,
+ * and to select the body under the cursor with a click.
  */
 
 #ifndef MOUSE_HANDLER_H
@@ -15,32 +16,32 @@
 #include <GL/glut.h>
 #endif
 
+#include "input_handler.h"
+#include "redraw_scheduler.h"
+#include "renderer.h"
+#include "scene.h"
+
 /**
- * @var cameraDistance
- * @brief Distance of the camera from the target.
- *
- * This external variable represents the distance between the camera and the
- * point it is looking at, affecting the zoom level.
+ * @def MOUSE_CLICK_SLOP
+ * @brief Distance, in pixels, the cursor may move while the left button is
+ *        pressed for the release to count as a click rather than a drag.
  */
-extern float cameraDistance;
+#define MOUSE_CLICK_SLOP 3
 
 /**
- * @var cameraAngleX
- * @brief Camera angle around the X-axis.
+ * @var scene
+ * @brief State of the displayed scene.
  *
- * This external variable represents the rotation angle of the camera around
- * the X-axis, affecting the vertical view direction.
+ * This external object holds the camera that mouse dragging orbits around
+ * the target and the selection that clicks change.
  */
-extern float cameraAngleX;
+extern SceneState scene;
 
 /**
- * @var cameraAngleY
- * @brief Camera angle around the Y-axis.
- *
- * This external variable represents the rotation angle of the camera around
- * the Y-axis, affecting the horizontal view direction.
+ * @var renderer
+ * @brief Renderer drawing the scene, whose last frame clicks are picked in.
  */
-extern float cameraAngleY;
+extern Renderer renderer;
 
 /**
  * @var lastMouseX
@@ -69,13 +70,44 @@ extern int lastMouseY;
  */
 extern bool leftButtonPressed;
 
+/**
+ * @var mouseDragged
+ * @brief Whether the cursor moved farther than `MOUSE_CLICK_SLOP` since the
+ *        left button was pressed.
+ */
+extern bool mouseDragged;
+
+/**
+ * @brief Applies a mouse motion to the camera orientation.
+ * @param x The X-coordinate of the mouse cursor.
+ * @param y The Y-coordinate of the mouse cursor.
+ *
+ * While the left button is pressed, the camera orbits by the cursor's
+ * movement since the last applied position, so merged motions move it by
+ * their total.
+ */
+void applyMouseMotion(int x, int y);
+
+/**
+ * @brief Applies a mouse button event to the camera control.
+ * @param button The mouse button that was pressed or released.
+ * @param state The state of the mouse button (GLUT_DOWN or GLUT_UP).
+ * @param x The X-coordinate of the mouse cursor.
+ * @param y The Y-coordinate of the mouse cursor.
+ *
+ * Pressing the left button starts a drag or a click; releasing it after a
+ * click selects the body under the cursor.
+ */
+void applyMouseButton(int button, int state, int x, int y);
+
 /**
  * @brief Handles mouse motion events.
  * @param x The X-coordinate of the mouse cursor.
  * @param y The Y-coordinate of the mouse cursor.
  *
- * This function is called when the mouse is moved, allowing updates to the
- * camera's orientation based on the cursor's position.
+ * This function is called when the mouse is moved with a button pressed.
+ * It queues the motion for `processInput`, which merges the motions of a
+ * frame before applying them.
  */
 void mouseMotion(int x, int y);
 
@@ -86,8 +118,8 @@ void mouseMotion(int x, int y);
  * @param x The X-coordinate of the mouse cursor.
  * @param y The Y-coordinate of the mouse cursor.
  *
- * This function is called when a mouse button is pressed or released, allowing
- * updates to the camera's control state.
+ * This function is called when a mouse button is pressed or released. It
+ * queues the event for `processInput`.
  */
 void mouseButton(int button, int state, int x, int y);
 
@@ -0,0 +1,32 @@
+/**
+ * @file opengl.h
+ * @brief Includes the OpenGL and GLU headers used by the core library.
+ *
+ * The core library must not depend on GLUT, so its sources include this
+ * header instead of `glut.h`. Extension prototypes are enabled so that
+ * functions newer than OpenGL 1.1, such as `glGenerateMipmap`, are declared;
+ * on macOS the core-profile header is included for the same reason.
+ */
+
+#ifndef OPENGL_H
+#define OPENGL_H
+
+#ifndef GL_SILENCE_DEPRECATION
+#define GL_SILENCE_DEPRECATION
+#endif
+
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+
+#ifdef __APPLE__
+#define GL_DO_NOT_WARN_IF_MULTIPLE_GL_VERSIONS_HEADERS_INCLUDED
+#include <OpenGL/gl.h>
+#include <OpenGL/gl3.h>
+#include <OpenGL/glu.h>
+#else
+#include <GL/gl.h>
+#include <GL/glu.h>
+#endif
+
+#endif // OPENGL_H
@@ -0,0 +1,118 @@
+/**
+ * @file picking.cpp
+ * @brief Implements ray-cast picking of bounding spheres.
+ */
+
+#include "picking.h"
+
+#include <cmath>
+
+/**
+ * @brief Computes the ray through a point of the viewport.
+ * @param view The viewing matrix.
+ * @param projection The perspective projection.
+ * @param x Horizontal position, in normalized device coordinates.
+ * @param y Vertical position, in normalized device coordinates.
+ * @param spread Radius of the cone per unit of distance along the ray.
+ * @return The ray.
+ *
+ * The direction is built in view space from the projection's focal
+ * lengths, then rotated back with the transpose of the view's rotation,
+ * which also gives the camera position from the view's translation, so no
+ * matrix is inverted.
+ */
+PickRay pickRay(const Mat4 &view, const Mat4 &projection, float x, float y, float spread)
+{
+  const float *m = view.m;
+  float vx = x / projection.m[0];
+  float vy = y / projection.m[5];
+  float vz = -1.0f;
+  float length = sqrtf(vx * vx + vy * vy + vz * vz);
+  vx /= length;
+  vy /= length;
+  vz /= length;
+
+  PickRay ray;
+  ray.origin.x = -(m[0] * m[12] + m[1] * m[13] + m[2] * m[14]);
+  ray.origin.y = -(m[4] * m[12] + m[5] * m[13] + m[6] * m[14]);
+  ray.origin.z = -(m[8] * m[12] + m[9] * m[13] + m[10] * m[14]);
+  ray.direction.x = m[0] * vx + m[1] * vy + m[2] * vz;
+  ray.direction.y = m[4] * vx + m[5] * vy + m[6] * vz;
+  ray.direction.z = m[8] * vx + m[9] * vy + m[10] * vz;
+  ray.spread = spread;
+  return ray;
+};
+
+/**
+ * @brief Finds the nearest sphere of a batch hit by a ray.
+ * @param batch The spheres.
+ * @param ray The ray.
+ * @param index Receives the index of the sphere hit, if any.
+ * @return True if the ray hits a sphere in front of its origin.
+ *
+ * A sphere is hit when its center lies ahead of the camera and closer to
+ * the ray than its radius widened by the cone. The spheres are tested in
+ * blocks by a branch-free loop that the compiler vectorizes; the distance at
+ * which the ray enters a sphere, which needs a square root, is only
+ * computed for the few spheres hit.
+ */
+bool pickSpheres(const CullingBatch &batch, const PickRay &ray, size_t &index)
+{
+  const size_t block = 256;
+  size_t count = batch.x.size();
+  if (count == 0)
+    return false;
+
+  const float *x = &batch.x[0];
+  const float *y = &batch.y[0];
+  const float *z = &batch.z[0];
+  const float *radius = &batch.radius[0];
+  const Vec3 &o = ray.origin;
+  const Vec3 &d = ray.direction;
+  const float spread = ray.spread;
+
+  unsigned char hits[block];
+  float nearest = INFINITY;
+  size_t nearestIndex = count;
+  for (size_t first = 0; first < count; first += block)
+  {
+    size_t size = count - first < block ? count - first : block;
+    unsigned char anyHit = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+      float cx = x[first + i] - o.x;
+      float cy = y[first + i] - o.y;
+      float cz = z[first + i] - o.z;
+      float along = cx * d.x + cy * d.y + cz * d.z;
+      float reach = radius[first + i] + spread * along;
+      float inside = reach * reach - (cx * cx + cy * cy + cz * cz - along * along);
+      hits[i] = (unsigned char)((radius[first + i] > 0.0f) & (along > 0.0f) & (inside >= 0.0f));
+      anyHit |= hits[i];
+    }
+    if (!anyHit)
+      continue;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+      if (!hits[i])
+        continue;
+      float cx = x[first + i] - o.x;
+      float cy = y[first + i] - o.y;
+      float cz = z[first + i] - o.z;
+      float along = cx * d.x + cy * d.y + cz * d.z;
+      float reach = radius[first + i] + spread * along;
+      float inside = reach * reach - (cx * cx + cy * cy + cz * cz - along * along);
+      float entry = along - sqrtf(fmaxf(inside, 0.0f));
+      if (entry < nearest)
+      {
+        nearest = entry;
+        nearestIndex = first + i;
+      }
+    }
+  }
+
+  if (nearestIndex == count)
+    return false;
+  index = nearestIndex;
+  return true;
+};
@@ -0,0 +1,83 @@
+/**
+ * @file redraw_scheduler.cpp
+ * @brief Implements the scheduling of the window redraws.
+ */
+
+#include "redraw_scheduler.h"
+
+/**
+ * @var redrawScheduler
+ * @brief Redraw scheduling of the window; nothing drawn and no timer armed yet.
+ */
+RedrawScheduler redrawScheduler = {SceneState(), false, false, false, false, 0};
+
+/**
+ * @brief Requests a redraw if the window no longer shows the current state.
+ * @param reason What asks for the redraw.
+ */
+void requestRedraw(RedrawReason reason)
+{
+  if (redrawScheduler.posted)
+    return;
+  if (reason != REDRAW_WINDOW && redrawScheduler.hasDrawn && redrawScheduler.drawnLighting == renderer.lighting &&
+      sceneStatesEqual(redrawScheduler.drawn, scene))
+    return;
+
+  redrawScheduler.posted = true;
+  glutPostRedisplay();
+};
+
+/**
+ * @brief Records that a frame of the current state has been drawn.
+ */
+void redrawDone()
+{
+  redrawScheduler.drawn = scene;
+  redrawScheduler.drawnLighting = renderer.lighting;
+  redrawScheduler.hasDrawn = true;
+  redrawScheduler.posted = false;
+};
+
+/**
+ * @brief Advances the simulation and the camera flight and schedules the next tick.
+ * @param value Unused parameter for timer function.
+ *
+ * The simulation advances by the real time elapsed since the previous tick,
+ * so slightly late ticks do not slow it down. `advanceSimulation` cuts gaps
+ * longer than `SIMULATION_MAX_ADVANCE_SECONDS` (0.1 s), so after a stall the
+ * simulation runs slower than its time scale instead of jumping ahead. The
+ * camera flight advances by the full elapsed time and keeps flying while the
+ * simulation is paused. Once the simulation is paused and the camera has
+ * arrived, the timer is not rearmed, so an idle window only wakes up for
+ * input and window events.
+ */
+static void simulationTick(int value)
+{
+  if (scene.simulation.paused && !scene.flight.active)
+  {
+    redrawScheduler.ticking = false;
+    return;
+  }
+
+  int now = glutGet(GLUT_ELAPSED_TIME);
+  double seconds = (now - redrawScheduler.lastTick) / 1000.0;
+  if (!scene.simulation.paused)
+    advanceSimulation(scene.simulation, seconds);
+  advanceCameraFlight(scene.flight, seconds);
+  redrawScheduler.lastTick = now;
+  requestRedraw(REDRAW_SIMULATION);
+  glutTimerFunc(REDRAW_TICK_MS, simulationTick, 0);
+};
+
+/**
+ * @brief Starts the simulation timer unless it runs or nothing moves.
+ */
+void startSimulationTimer()
+{
+  if (redrawScheduler.ticking || (scene.simulation.paused && !scene.flight.active))
+    return;
+
+  redrawScheduler.ticking = true;
+  redrawScheduler.lastTick = glutGet(GLUT_ELAPSED_TIME);
+  glutTimerFunc(REDRAW_TICK_MS, simulationTick, 0);
+};
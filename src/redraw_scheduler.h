@@ -0,0 +1,105 @@
+/**
+ * @file redraw_scheduler.h
+ * @brief Schedules the redraws of the window.
+ *
+ * This file declares the scheduler that decides when the window is redrawn.
+ * A frame is only requested when something it shows has changed: the
+ * simulation advanced, the camera flew, an input changed the camera, the
+ * view options or the lighting, or the window was resized. The simulation
+ * timer only runs while the animation plays or the camera flies, so a
+ * paused, untouched window leaves the GLUT main loop blocked waiting for
+ * events instead of polling.
+ */
+
+#ifndef REDRAW_SCHEDULER_H
+#define REDRAW_SCHEDULER_H
+
+#ifdef __APPLE__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+#include "renderer.h"
+#include "scene.h"
+
+/**
+ * @def REDRAW_TICK_MS
+ * @brief Interval between two simulation ticks, in milliseconds (60 Hz).
+ */
+#define REDRAW_TICK_MS 16
+
+/**
+ * @enum RedrawReason
+ * @brief What asks the window to be redrawn.
+ */
+enum RedrawReason
+{
+  REDRAW_SIMULATION, ///< The simulation or the camera flight advanced.
+  REDRAW_INPUT,      ///< A key or the mouse may have changed the scene or the renderer.
+  REDRAW_WINDOW      ///< The window changed, so its contents must be drawn again.
+};
+
+/**
+ * @struct RedrawScheduler
+ * @brief State of the redraw scheduling.
+ */
+struct RedrawScheduler
+{
+  SceneState drawn;   ///< Scene of the last frame drawn.
+  bool drawnLighting; ///< Lighting of the last frame drawn.
+  bool hasDrawn;      ///< Whether a frame has been drawn yet.
+  bool posted;        ///< Whether a redisplay is pending.
+  bool ticking;       ///< Whether the simulation timer is armed.
+  int lastTick;       ///< Time of the last simulation tick, in milliseconds since GLUT started.
+};
+
+/**
+ * @var scene
+ * @brief State of the displayed scene, compared with the last frame drawn.
+ */
+extern SceneState scene;
+
+/**
+ * @var renderer
+ * @brief Renderer drawing the scene, whose lighting is part of the frame.
+ */
+extern Renderer renderer;
+
+/**
+ * @var redrawScheduler
+ * @brief Redraw scheduling of the window.
+ */
+extern RedrawScheduler redrawScheduler;
+
+/**
+ * @brief Requests a redraw if the window no longer shows the current state.
+ * @param reason What asks for the redraw.
+ *
+ * Window changes always post a redisplay. Other requests only post one if
+ * the scene or the lighting differs from the last frame drawn, so inputs
+ * that change nothing, such as zooming against a limit, cost no frame.
+ * Requests made before the pending frame is drawn are merged into it.
+ */
+void requestRedraw(RedrawReason reason);
+
+/**
+ * @brief Records that a frame of the current state has been drawn.
+ *
+ * The display callback calls this function after rendering, whether the
+ * frame was requested or GLUT redraws a damaged window.
+ */
+void redrawDone();
+
+/**
+ * @brief Starts the simulation timer unless it runs or nothing moves.
+ *
+ * Every tick advances the simulation and the camera flight by the real time
+ * elapsed since the previous one and requests a redraw. The timer stops at
+ * the first tick where the simulation is paused and the camera is not
+ * flying, so it must be started again when the simulation resumes or a
+ * flight starts.
+ */
+void startSimulationTimer();
+
+#endif // REDRAW_SCHEDULER_H
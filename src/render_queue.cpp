@@ -0,0 +1,175 @@
+/**
+ * @file render_queue.cpp
+ * @brief Implements the render command queue.
+ *
+ * This file provides the sort key layout and the radix sort that orders the
+ * commands of a frame before the renderer executes them.
+ */
+
+#include "render_queue.h"
+
+#include <string.h>
+
+/**
+ * @def RENDER_KEY_PASS_SHIFT
+ * @brief Position of the 2-bit pass field in a sort key.
+ */
+#define RENDER_KEY_PASS_SHIFT 62
+
+/**
+ * @def RENDER_KEY_MATERIAL_BITS
+ * @brief Width of the material field in a sort key.
+ */
+#define RENDER_KEY_MATERIAL_BITS 22
+
+/**
+ * @def RENDER_KEY_DEPTH_BITS
+ * @brief Width of the quantized depth field in a sort key.
+ */
+#define RENDER_KEY_DEPTH_BITS 24
+
+/**
+ * @brief Quantizes a view-space distance to the depth field of a key.
+ * @param depth View-space distance from the camera.
+ * @return The distance mapped to `[0, 2^RENDER_KEY_DEPTH_BITS - 1]`.
+ */
+static uint64_t quantizeDepth(float depth)
+{
+  const uint64_t maxDepth = (1ull << RENDER_KEY_DEPTH_BITS) - 1;
+  if (!(depth > 0.0f))
+    return 0;
+  if (depth >= RENDER_DEPTH_RANGE)
+    return maxDepth;
+  return (uint64_t)(depth / RENDER_DEPTH_RANGE * (float)maxDepth);
+};
+
+/**
+ * @brief Builds the sort key of a command.
+ * @param pass The pass the command belongs to.
+ * @param material Identifier of the command's material.
+ * @param depth View-space distance from the camera to the object.
+ * @return The 64-bit sort key.
+ *
+ * Layout, from the most significant bit:
+ * - opaque:      pass (2) | material (22) | depth (24) | unused (16)
+ * - transparent: pass (2) | inverted depth (24) | material (22) | unused (16)
+ */
+uint64_t makeRenderKey(RenderPass pass, unsigned int material, float depth)
+{
+  const uint64_t maxDepth = (1ull << RENDER_KEY_DEPTH_BITS) - 1;
+  const uint64_t materialMask = (1ull << RENDER_KEY_MATERIAL_BITS) - 1;
+
+  uint64_t key = (uint64_t)pass << RENDER_KEY_PASS_SHIFT;
+  uint64_t quantized = quantizeDepth(depth);
+  if (pass == RENDER_PASS_OPAQUE)
+  {
+    key |= ((uint64_t)material & materialMask) << (RENDER_KEY_PASS_SHIFT - RENDER_KEY_MATERIAL_BITS);
+    key |= quantized << (RENDER_KEY_PASS_SHIFT - RENDER_KEY_MATERIAL_BITS - RENDER_KEY_DEPTH_BITS);
+  }
+  else
+  {
+    key |= (maxDepth - quantized) << (RENDER_KEY_PASS_SHIFT - RENDER_KEY_DEPTH_BITS);
+    key |= ((uint64_t)material & materialMask) << (RENDER_KEY_PASS_SHIFT - RENDER_KEY_DEPTH_BITS - RENDER_KEY_MATERIAL_BITS);
+  }
+  return key;
+};
+
+/**
+ * @brief Returns the pass encoded in a sort key.
+ * @param key The sort key.
+ * @return The pass of the command.
+ */
+RenderPass renderKeyPass(uint64_t key)
+{
+  return (RenderPass)(key >> RENDER_KEY_PASS_SHIFT);
+};
+
+/**
+ * @brief Removes all commands from the queue, keeping its memory.
+ * @param queue The queue to clear.
+ */
+void clearRenderQueue(RenderQueue &queue)
+{
+  queue.commands.clear();
+  queue.keys.clear();
+  queue.order.clear();
+};
+
+/**
+ * @brief Adds a command to the queue.
+ * @param queue The queue.
+ * @param command The command to add.
+ */
+void submitRenderCommand(RenderQueue &queue, const RenderCommand &command)
+{
+  queue.order.push_back((uint32_t)queue.commands.size());
+  queue.keys.push_back(command.key);
+  queue.commands.push_back(command);
+};
+
+/**
+ * @brief Sorts the queue by key.
+ * @param queue The queue to sort.
+ *
+ * All eight byte histograms are built in a single pass over the keys; a byte
+ * whose histogram has a single non-empty bucket is skipped.
+ */
+void sortRenderQueue(RenderQueue &queue)
+{
+  size_t count = queue.keys.size();
+  if (count < 2)
+    return;
+
+  uint32_t histograms[8][256];
+  memset(histograms, 0, sizeof(histograms));
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint64_t key = queue.keys[i];
+    for (int digit = 0; digit < 8; ++digit)
+      ++histograms[digit][(key >> (digit * 8)) & 0xff];
+  }
+
+  queue.scratchKeys.resize(count);
+  queue.scratchOrder.resize(count);
+
+  uint64_t *keys = &queue.keys[0];
+  uint32_t *order = &queue.order[0];
+  uint64_t *sortedKeys = &queue.scratchKeys[0];
+  uint32_t *sortedOrder = &queue.scratchOrder[0];
+
+  for (int digit = 0; digit < 8; ++digit)
+  {
+    uint32_t *histogram = histograms[digit];
+    int shift = digit * 8;
+    if (histogram[(keys[0] >> shift) & 0xff] == count)
+      continue;
+
+    uint32_t offset = 0;
+    for (int bucket = 0; bucket < 256; ++bucket)
+    {
+      uint32_t bucketCount = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += bucketCount;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint32_t position = histogram[(keys[i] >> shift) & 0xff]++;
+      sortedKeys[position] = keys[i];
+      sortedOrder[position] = order[i];
+    }
+
+    uint64_t *swapKeys = keys;
+    keys = sortedKeys;
+    sortedKeys = swapKeys;
+    uint32_t *swapOrder = order;
+    order = sortedOrder;
+    sortedOrder = swapOrder;
+  }
+
+  if (keys != &queue.keys[0])
+  {
+    queue.keys.swap(queue.scratchKeys);
+    queue.order.swap(queue.scratchOrder);
+  }
+};
@@ -0,0 +1,148 @@
+/**
+ * @file render_queue.h
+ * @brief Declares the render command queue.
+ *
+ * Draw functions do not issue OpenGL calls directly; they submit commands
+ * tagged with a 64-bit sort key. Before execution the queue is radix-sorted
+ * on that key, so that commands sharing a pass and a material end up next to
+ * each other and state changes are only made when the state actually
+ * changes.
+ */
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "transform.h"
+
+/**
+ * @enum RenderPass
+ * @brief Passes of a frame, in execution order.
+ */
+enum RenderPass
+{
+  RENDER_PASS_OPAQUE = 0,      ///< Depth-tested opaque geometry, sorted front to back.
+  RENDER_PASS_TRANSPARENT = 1, ///< Alpha-blended geometry, sorted back to front unless the backend blends it in any order.
+};
+
+/**
+ * @def RENDER_DEPTH_RANGE
+ * @brief View-space distance mapped to the largest depth key.
+ *
+ * Matches the far clipping plane of the legacy projection; farther commands
+ * share the largest key.
+ */
+#define RENDER_DEPTH_RANGE 200.0f
+
+/**
+ * @enum RenderFlag
+ * @brief Lighting and placement options of a command, combined in `RenderCommand::flags`.
+ */
+enum RenderFlag
+{
+  RENDER_FLAG_LIT = 1,       ///< The Sun lights the command and its body's occluders shadow it; others keep their full color.
+  RENDER_FLAG_RING = 2,      ///< The command is its body's ring: it is only translated to the body, and receives the shadow of the body and of the body's occluders.
+  RENDER_FLAG_ATMOSPHERE = 4 ///< The command is its body's atmosphere shell, shaded from the precomputed scattering tables; only the core backend draws it.
+};
+
+/**
+ * @struct RenderCommand
+ * @brief A single draw submitted to the queue.
+ */
+struct RenderCommand
+{
+  uint64_t key;         ///< Sort key built by `makeRenderKey`.
+  int body;             ///< Body whose orbital placement is applied after `model`, or -1.
+  Mat4 model;           ///< Object transform, relative to the body's center or, without a body, to the world.
+  unsigned int mesh;    ///< Index of the mesh to draw, owned by the renderer.
+  unsigned int texture; ///< OpenGL texture to bind, or 0 for untextured geometry.
+  float color[4];       ///< Color multiplied with the texture, alpha included.
+  unsigned int flags;   ///< Combination of `RenderFlag` values.
+};
+
+/**
+ * @struct RenderStats
+ * @brief Counters describing the work done for the last executed frame.
+ */
+struct RenderStats
+{
+  unsigned int commands;     ///< Commands executed.
+  unsigned int textureBinds; ///< Texture binds issued.
+  unsigned int passChanges;  ///< Blend and depth state switches issued.
+  unsigned int drawCalls;    ///< Draw calls issued.
+  unsigned int bodiesCulled; ///< Bodies outside the view frustum, not submitted.
+  unsigned int ringsCulled;  ///< Rings outside the view frustum, not submitted.
+  unsigned int orbitsCulled; ///< Orbits outside the view frustum, not submitted.
+  unsigned int stars;        ///< Stars drawn in the background.
+  float starfieldGpuMs;      ///< GPU time of the starfield, in milliseconds, measured a few frames earlier.
+  float bodiesGpuMs;         ///< GPU time of the render queue, in milliseconds, measured a few frames earlier.
+};
+
+/**
+ * @struct RenderQueue
+ * @brief Commands of one frame and the scratch memory used to sort them.
+ *
+ * All arrays are reused from frame to frame, so a queue that has reached its
+ * working size no longer allocates.
+ */
+struct RenderQueue
+{
+  std::vector<RenderCommand> commands; ///< Commands in submission order.
+  std::vector<uint64_t> keys;          ///< Sort keys, reordered by `sortRenderQueue`.
+  std::vector<uint32_t> order;         ///< Command indices in execution order after sorting.
+  std::vector<uint64_t> scratchKeys;   ///< Radix sort ping-pong buffer for keys.
+  std::vector<uint32_t> scratchOrder;  ///< Radix sort ping-pong buffer for indices.
+};
+
+/**
+ * @brief Builds the sort key of a command.
+ * @param pass The pass the command belongs to.
+ * @param material Identifier of the command's material (its texture); only
+ *                 the low 22 bits are used.
+ * @param depth View-space distance from the camera to the object.
+ * @return The 64-bit sort key.
+ *
+ * The pass always occupies the most significant bits. Opaque commands are
+ * then ordered by material and, within a material, front to back so that
+ * early depth rejection discards hidden fragments. Transparent commands are
+ * ordered back to front first, as blending requires, and by material only
+ * among commands at the same depth. Commands with equal keys keep their
+ * submission order.
+ */
+uint64_t makeRenderKey(RenderPass pass, unsigned int material, float depth);
+
+/**
+ * @brief Returns the pass encoded in a sort key.
+ * @param key The sort key.
+ * @return The pass of the command.
+ */
+RenderPass renderKeyPass(uint64_t key);
+
+/**
+ * @brief Removes all commands from the queue, keeping its memory.
+ * @param queue The queue to clear.
+ */
+void clearRenderQueue(RenderQueue &queue);
+
+/**
+ * @brief Adds a command to the queue.
+ * @param queue The queue.
+ * @param command The command to add.
+ */
+void submitRenderCommand(RenderQueue &queue, const RenderCommand &command);
+
+/**
+ * @brief Sorts the queue by key.
+ * @param queue The queue to sort.
+ *
+ * This function performs a stable least-significant-digit radix sort of the
+ * keys with 8-bit digits, carrying the command indices along. Digits that
+ * are identical for every key are skipped, so typical frames only pay for
+ * the few bytes that actually vary. The commands themselves are not moved;
+ * `queue.order` lists them in execution order.
+ */
+void sortRenderQueue(RenderQueue &queue);
+
+#endif // RENDER_QUEUE_H
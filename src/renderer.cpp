@@ -0,0 +1,1012 @@
+/**
+ * @file renderer.cpp
+ * @brief Implements the solar system renderer.
+ *
+ * This file contains the submission routines for the Sun, the planets, their
+ * orbits and Saturn's rings, the frustum culling applied before submission,
+ * and the executor that draws the sorted render queue with the fixed-function
+ * OpenGL pipeline, lit by the Sun as a point light. The placement of the
+ * bodies relative to the floating origin and the occluders of the analytic
+ * shadows are computed here for both backends.
+ */
+
+#include "renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "atmosphere.h"
+#include "picking.h"
+#include "renderer_core.h"
+#include "shadows.h"
+#include "texture_loader.h"
+#include "texture_pack.h"
+#include "geometry.h"
+#include "textures.h"
+
+/**
+ * @brief Uploads a triangle mesh to OpenGL buffer objects.
+ * @param mesh The mesh to upload.
+ * @return The uploaded mesh.
+ */
+static GpuMesh uploadMesh(const Mesh &mesh)
+{
+  GpuMesh gpuMesh;
+  glGenBuffers(1, &gpuMesh.vertexBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), &mesh.vertices[0], GL_STATIC_DRAW);
+
+  glGenBuffers(1, &gpuMesh.indexBuffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpuMesh.indexBuffer);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), &mesh.indices[0], GL_STATIC_DRAW);
+
+  gpuMesh.count = (GLsizei)mesh.indices.size();
+  gpuMesh.mode = GL_TRIANGLES;
+  gpuMesh.textured = true;
+  gpuMesh.first = 0;
+  gpuMesh.baseVertex = 0;
+  return gpuMesh;
+};
+
+/**
+ * @brief Uploads a line loop to an OpenGL buffer object.
+ * @param vertices The XYZ position of every vertex.
+ * @return The uploaded mesh.
+ */
+static GpuMesh uploadLineLoop(const std::vector<float> &vertices)
+{
+  GpuMesh gpuMesh;
+  glGenBuffers(1, &gpuMesh.vertexBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
+
+  gpuMesh.indexBuffer = 0;
+  gpuMesh.count = (GLsizei)(vertices.size() / 3);
+  gpuMesh.mode = GL_LINE_LOOP;
+  gpuMesh.textured = false;
+  gpuMesh.first = 0;
+  gpuMesh.baseVertex = 0;
+  return gpuMesh;
+};
+
+/**
+ * @brief Sets up the fixed-function light of the Sun.
+ *
+ * `GL_LIGHT0` is a white point light without ambient or specular terms, and
+ * the draw color becomes the ambient and diffuse material, so lit surfaces
+ * keep `AMBIENT_LIGHT` of their color on their night side. Normals are
+ * renormalized since body models are scaled. The light's position is set
+ * every frame, and lighting itself is only enabled for lit commands.
+ */
+static void initLegacyLighting()
+{
+  GLfloat ambient[] = {AMBIENT_LIGHT, AMBIENT_LIGHT, AMBIENT_LIGHT, 1.0f};
+  GLfloat black[] = {0.0f, 0.0f, 0.0f, 1.0f};
+  GLfloat white[] = {1.0f, 1.0f, 1.0f, 1.0f};
+  glLightModelfv(GL_LIGHT_MODEL_AMBIENT, ambient);
+  glLightfv(GL_LIGHT0, GL_AMBIENT, black);
+  glLightfv(GL_LIGHT0, GL_DIFFUSE, white);
+  glLightfv(GL_LIGHT0, GL_SPECULAR, black);
+  glEnable(GL_LIGHT0);
+
+  glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+  glEnable(GL_COLOR_MATERIAL);
+  glEnable(GL_NORMALIZE);
+};
+
+/**
+ * @brief Initializes OpenGL settings and loads textures.
+ * @param renderer The renderer to initialize.
+ * @param backend The pipeline to draw with.
+ * @return True on success; false if the current context cannot run the
+ *         requested backend.
+ *
+ * Besides the textures, this function uploads the unit sphere, the unit orbit
+ * and the disks of every ring once, so that no geometry is generated while
+ * rendering. With the core backend, the body textures are uploaded from the
+ * texture pack as the layers of one texture array instead of separate
+ * textures, and the meshes are moved into shared pools. Without a pack, the
+ * textures are resampled into one at startup. The orbital parameters of the
+ * bodies are gathered in `renderer.bodyParams`; all catalog bodies start at
+ * phase 0. Their positions come from the ephemeris, read from its cache or
+ * fitted. The core backend is checked first so that nothing is loaded when it
+ * is unavailable and the caller falls back to the legacy pipeline.
+ */
+bool initRenderer(Renderer &renderer, RendererBackend backend)
+{
+  renderer.backend = backend;
+  renderer.core = CoreBackend();
+
+  renderer.bodyParams.resize(BODY_COUNT);
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    BodyParams &params = renderer.bodyParams[i];
+    params.orbitRadius = BODIES[i].orbitRadius;
+    params.orbitSpeed = BODIES[i].orbitSpeed;
+    params.orbitPhase = 0.0f;
+    params.radius = BODIES[i].radius;
+  }
+  renderer.time = 0.0f;
+  renderer.camera = initialCameraState();
+  renderer.bodyCount = 0;
+  renderer.lighting = true;
+  Vec3 origin = {0.0f, 0.0f, 0.0f};
+  renderer.sunPosition = origin;
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    renderer.centers[i] = origin;
+    renderer.scales[i] = 1.0f;
+    renderer.orbitRadii[i] = 0.0f;
+  }
+
+  if (backend == RENDERER_CORE)
+  {
+    if (!initCoreBackend(renderer))
+      return false;
+  }
+  else
+  {
+    glEnable(GL_TEXTURE_2D);
+    initLegacyLighting();
+  }
+
+  glClearColor(0.0, 0.0, 0.0, 0.0);
+  glEnable(GL_DEPTH_TEST);
+
+  if (backend == RENDERER_CORE)
+  {
+    TexturePack pack;
+    if (!readTexturePack(BODY_TEXTURE_PACK, pack) || pack.layers != BODY_COUNT)
+    {
+      std::cerr << "Texture pack " << BODY_TEXTURE_PACK << " not found, resampling the body textures" << std::endl;
+      const char *paths[BODY_COUNT];
+      for (int i = 0; i < BODY_COUNT; ++i)
+        paths[i] = BODIES[i].texturePath;
+      buildTexturePack(paths, BODY_COUNT, BODY_TEXTURE_WIDTH, BODY_TEXTURE_HEIGHT, pack);
+    }
+    renderer.core.textureArray = uploadTexturePack(pack);
+    for (int i = 0; i < BODY_COUNT; ++i)
+      renderer.bodyTextures[i] = i + 1;
+    renderer.saturnRingTexture = 0;
+  }
+  else
+  {
+    for (int i = 0; i < BODY_COUNT; ++i)
+      renderer.bodyTextures[i] = loadTexture(BODIES[i].texturePath);
+    renderer.saturnRingTexture = loadTexture(SATURN_RING_TEXTURE);
+  }
+
+  Mesh mesh;
+  buildSphere(1.0f, 36, 18, mesh);
+  renderer.meshes.push_back(uploadMesh(mesh));
+
+  std::vector<float> orbitVertices;
+  buildOrbit(1.0f, 360, orbitVertices);
+  renderer.meshes.push_back(uploadLineLoop(orbitVertices));
+
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    renderer.ringMeshes[i] = 0;
+    const Body &body = BODIES[i];
+    if (!bodyHasRing(body))
+      continue;
+
+    renderer.ringMeshes[i] = (unsigned int)renderer.meshes.size();
+    float radiusStep = (body.outerRingRadius - body.innerRingRadius) / RING_DISK_COUNT;
+    for (int d = 0; d < RING_DISK_COUNT; ++d)
+    {
+      float offset = (d % 2 == 0) ? RING_DISK_OFFSET : 0.0f;
+      float innerRadius = body.innerRingRadius + d * radiusStep + offset;
+      buildDisk(innerRadius, innerRadius + radiusStep, 64, 64, mesh);
+      renderer.meshes.push_back(uploadMesh(mesh));
+    }
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  if (backend == RENDERER_CORE)
+    createCoreMeshPools(renderer);
+
+  loadEphemeris(renderer.ephemeris);
+  initStarfield(renderer, STAR_CATALOG);
+  initGpuProfiler(renderer.profiler);
+
+  renderer.width = 0;
+  renderer.height = 0;
+  renderer.projection = mat4Identity();
+  return true;
+};
+
+/**
+ * @brief Adjusts the viewport and projection to a new framebuffer size.
+ * @param renderer The renderer.
+ * @param width The new width, in pixels.
+ * @param height The new height, in pixels.
+ *
+ * This function adjusts the viewport and projection matrix to ensure the
+ * correct aspect ratio and perspective. The projection is built on the CPU
+ * so that the frustum used for culling is exactly the one OpenGL clips to;
+ * the core backend uploads it with the view matrix every frame. The core
+ * backend's planes span `LOG_DEPTH_NEAR` to `LOG_DEPTH_FAR`, which its
+ * logarithmic depth resolves; the legacy one keeps a standard depth buffer,
+ * from 1 to `RENDER_DEPTH_RANGE`.
+ */
+void resizeRenderer(Renderer &renderer, int width, int height)
+{
+  renderer.width = width;
+  renderer.height = height > 0 ? height : 1;
+
+  glViewport(0, 0, (GLsizei)renderer.width, (GLsizei)renderer.height);
+  GLfloat aspect = (GLfloat)renderer.width / (GLfloat)renderer.height;
+  if (renderer.backend == RENDERER_CORE)
+  {
+    renderer.projection = mat4Perspective(45.0f, aspect, LOG_DEPTH_NEAR, LOG_DEPTH_FAR);
+    resizeCoreTargets(renderer);
+    return;
+  }
+
+  renderer.projection = mat4Perspective(45.0f, aspect, 1.0f, RENDER_DEPTH_RANGE);
+  glMatrixMode(GL_PROJECTION);
+  glLoadMatrixf(renderer.projection.m);
+  glMatrixMode(GL_MODELVIEW);
+  glLoadIdentity();
+};
+
+/**
+ * @brief Submits one command to the renderer's queue.
+ * @param renderer The renderer.
+ * @param view The viewing matrix of the frame, used to compute the depth.
+ * @param pass The pass the command belongs to.
+ * @param body The body placing the command, or -1 for world-space geometry.
+ * @param center World-space center of the command, used to compute the depth.
+ * @param model The object transform, relative to the body's center.
+ * @param mesh Index of the mesh to draw.
+ * @param texture The texture to bind, or 0 for untextured geometry.
+ * @param alpha Opacity of the command.
+ * @param flags Lighting and placement options of the command, see `RenderFlag`.
+ *
+ * The core backend blends transparent commands in any order, so they are
+ * keyed at depth 0: the sort then only groups them by material, and the
+ * radix sort skips the depth digits of the pass.
+ */
+static void submit(Renderer &renderer, const Mat4 &view, RenderPass pass, int body, const Vec3 &center, const Mat4 &model, unsigned int mesh, GLuint texture, float alpha, unsigned int flags)
+{
+  Vec3 viewPosition = mat4TransformPoint(view, center);
+  bool unordered = pass == RENDER_PASS_TRANSPARENT && renderer.backend == RENDERER_CORE;
+
+  RenderCommand command;
+  command.key = makeRenderKey(pass, texture, unordered ? 0.0f : -viewPosition.z);
+  command.body = body;
+  command.model = model;
+  command.mesh = mesh;
+  command.texture = texture;
+  command.color[0] = command.color[1] = command.color[2] = texture ? 1.0f : 0.7f;
+  command.color[3] = alpha;
+  command.flags = flags;
+  submitRenderCommand(renderer.queue, command);
+};
+
+/**
+ * @brief Submits a textured body sphere.
+ * @param renderer The renderer.
+ * @param view The viewing matrix of the frame.
+ * @param index Index of the body in the `BODIES` table.
+ * @param center World-space center of the body.
+ *
+ * The sphere is rotated so that its poles lie on the Y-axis, as the GLU
+ * sphere it replaces was. Every body but the Sun, which shines by itself, is
+ * lit.
+ */
+static void submitTexturedSphere(Renderer &renderer, const Mat4 &view, int index, const Vec3 &center)
+{
+  Mat4 model = mat4Multiply(mat4Rotate(90.0f, 1.0f, 0.0f, 0.0f), mat4Scale(BODIES[index].radius * renderer.scales[index]));
+  submit(renderer, view, RENDER_PASS_OPAQUE, index, center, model, MESH_SPHERE, renderer.bodyTextures[index], 1.0f, index != SUN ? RENDER_FLAG_LIT : 0);
+};
+
+/**
+ * @brief Submits the atmosphere shell of a body, if it has one.
+ * @param renderer The renderer.
+ * @param view The viewing matrix of the frame.
+ * @param index Index of the body in the `BODIES` table.
+ * @param center World-space center of the body.
+ *
+ * The shell is the unit sphere scaled to the top of the atmosphere and
+ * drawn in the transparent pass. Only the core backend has the scattering
+ * tables, and the scattered light comes from the Sun, so shells are only
+ * submitted with the core backend and lighting enabled.
+ */
+static void submitAtmosphere(Renderer &renderer, const Mat4 &view, int index, const Vec3 &center)
+{
+  if (!bodyHasAtmosphere(index) || !renderer.lighting || renderer.backend != RENDERER_CORE || !renderer.core.atmosphereTextures[0])
+    return;
+  Mat4 model = mat4Scale(BODIES[index].radius * renderer.scales[index] * (1.0f + ATMOSPHERES[index].thickness));
+  submit(renderer, view, RENDER_PASS_TRANSPARENT, index, center, model, MESH_SPHERE, 0, 1.0f, RENDER_FLAG_ATMOSPHERE);
+};
+
+/**
+ * @brief Submits an orbit with the given radius.
+ * @param renderer The renderer, holding the position of the Sun.
+ * @param view The viewing matrix of the frame.
+ * @param radius The radius of the orbit.
+ *
+ * The orbit is the unit orbit scaled to the requested radius, centered on
+ * the Sun and drawn as a flat-colored line loop.
+ */
+static void submitOrbit(Renderer &renderer, const Mat4 &view, float radius)
+{
+  if (radius <= 0.0f)
+    return;
+  const Vec3 &sun = renderer.centers[SUN];
+  Mat4 model = mat4Multiply(mat4Translate(sun.x, sun.y, sun.z), mat4Scale(radius, 1.0f, radius));
+  submit(renderer, view, RENDER_PASS_OPAQUE, -1, sun, model, MESH_ORBIT, 0, 1.0f, 0);
+};
+
+/**
+ * @brief Returns the tilt of a ring relative to the orbital plane.
+ * @return The rotation applied to the ring disks, which are built in the XY plane.
+ */
+static Mat4 ringTilt()
+{
+  return mat4Rotate(100.0f, 1.0f, 0.0f, 0.0f);
+};
+
+/**
+ * @brief Submits a ring.
+ * @param renderer The renderer.
+ * @param view The viewing matrix of the frame.
+ * @param index Index of the ringed body in the `BODIES` table.
+ * @param center World-space center of the ringed body.
+ *
+ * The ring is drawn as a series of textured disks, tilted by 10 degrees.
+ * Unlike the body, the ring does not turn with the orbital angle: its plane
+ * keeps its orientation in space, so the Sun lights it and its shadow falls
+ * on the body from a height that changes along the orbit. The transparency
+ * and spacing of the disks create the appearance of rings; the disks are
+ * transparent commands. The fixed-function executor blends them in their
+ * inner-to-outer submission order, since they share a depth; the core backend
+ * blends them independently of their order. Rings are not lit: they are
+ * nearly edge-on to the Sun, which would leave them black. They still receive
+ * the shadow of their body.
+ */
+static void submitSaturnRing(Renderer &renderer, const Mat4 &view, int index, const Vec3 &center)
+{
+  Mat4 tilt = mat4Multiply(ringTilt(), mat4Scale(renderer.scales[index]));
+  for (int i = 0; i < RING_DISK_COUNT; ++i)
+  {
+    float alpha = (float)i / (float)(RING_DISK_COUNT - 1);
+    submit(renderer, view, RENDER_PASS_TRANSPARENT, index, center, tilt, renderer.ringMeshes[index] + i, renderer.bodyTextures[index], alpha, RENDER_FLAG_RING);
+  }
+};
+
+/**
+ * @brief Returns the radius of a sphere enclosing a body's ring.
+ * @param body The ringed body.
+ * @return The bounding radius, centered on the body.
+ */
+static float ringBoundingRadius(const Body &body)
+{
+  return body.outerRingRadius + RING_DISK_OFFSET;
+};
+
+/**
+ * @brief Returns the orbital angle of a body.
+ * @param renderer The renderer, holding the time of the frame.
+ * @param params The orbital parameters of the body.
+ * @return The angle, in radians.
+ */
+static float orbitAngle(const Renderer &renderer, const BodyParams &params)
+{
+  return (renderer.time * params.orbitSpeed + params.orbitPhase) * 3.14159265358979f / 180.0f;
+};
+
+/**
+ * @brief Returns the index of the body the camera looks at.
+ * @param scene The scene.
+ * @return The selected body, or the Sun in the overview.
+ */
+static int cameraTarget(const SceneState &scene)
+{
+  int selected = scene.selectedElement;
+  return selected >= SUN && selected < BODY_COUNT ? selected : SUN;
+};
+
+/**
+ * @brief Returns the length of a render unit.
+ * @param scene The scene.
+ * @return 1 at the scene's scale; in the true-scale mode, the kilometres
+ *         that give the camera's target, or Neptune's orbit in the
+ *         overview, the size it has at the scene's scale.
+ */
+static double renderUnit(const SceneState &scene)
+{
+  if (!scene.trueScale)
+    return 1.0;
+  if (scene.selectedElement != cameraTarget(scene))
+    return BODIES[NEPTUNE].trueOrbitRadius / BODIES[NEPTUNE].orbitRadius;
+  const Body &target = BODIES[scene.selectedElement];
+  return target.trueRadius / target.radius;
+};
+
+/**
+ * @brief Computes the position of every body in world units.
+ * @param renderer The renderer, holding the ephemeris and the orbital parameters.
+ * @param scene The scene, whose simulation angle and scale give the positions.
+ * @param positions Array that receives the position of every body.
+ *
+ * The ephemeris gives positions in orbit radii, which are scaled to world
+ * units: scene units or, in the true-scale mode, kilometres from the real
+ * orbit radii.
+ */
+static void bodyWorldPositions(const Renderer &renderer, const SceneState &scene, DVec3 *positions)
+{
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    double position[3];
+    ephemerisPosition(renderer.ephemeris, i, scene.simulation.rotationAngle, position);
+    double radius = scene.trueScale ? BODIES[i].trueOrbitRadius : renderer.bodyParams[i].orbitRadius;
+    positions[i].x = radius * position[0];
+    positions[i].y = radius * position[1];
+    positions[i].z = radius * position[2];
+  }
+};
+
+/**
+ * @brief Computes the view of a frame.
+ * @param scene The scene being rendered.
+ * @param positions World position of every body at the frame's time.
+ * @param origin Receives the point the camera looks at, in world units.
+ * @param camera Receives the camera of the frame.
+ * @return The length of a render unit, in world units.
+ *
+ * At rest, the camera looks at its target with the scene's camera. During
+ * a flight, the point it looks at is the given fraction of the way from the
+ * start point to the target, both where their bodies are at this frame's
+ * time, and the angles move from the start to the scene's. Zooming during
+ * the flight scales the rest of its path. At the scene's scale, bodies keep
+ * their sizes, so a render unit stays a scene unit; in the true-scale mode,
+ * the render unit follows the camera distance, which moves geometrically
+ * between its two ends in render units, so each end keeps its own unit.
+ */
+static double frameView(const SceneState &scene, const DVec3 *positions, DVec3 &origin, CameraState &camera)
+{
+  const DVec3 &target = positions[cameraTarget(scene)];
+  const CameraFlight &flight = scene.flight;
+  double unit = renderUnit(scene);
+  origin = target;
+  camera = scene.camera;
+  if (!flight.active)
+    return unit;
+
+  double progress = cameraFlightProgress(flight);
+  double fraction, width;
+  cameraFlightPath(flight, progress, fraction, width);
+  width *= scene.camera.distance / flight.toDistance;
+
+  const DVec3 &body = positions[flight.fromBody];
+  DVec3 from = {body.x + flight.fromOffset.x, body.y + flight.fromOffset.y, body.z + flight.fromOffset.z};
+  origin.x = from.x + (target.x - from.x) * fraction;
+  origin.y = from.y + (target.y - from.y) * fraction;
+  origin.z = from.z + (target.z - from.z) * fraction;
+
+  if (scene.trueScale)
+    unit = width / (flight.fromDistance * pow(scene.camera.distance / flight.fromDistance, progress));
+  camera.distance = (float)(width / unit);
+  camera.angleX += flight.angleX * (float)(1.0 - progress);
+  camera.angleY += flight.angleY * (float)(1.0 - progress);
+  return unit;
+};
+
+/**
+ * @brief Places the camera and the bodies of a frame relative to the
+ *        floating origin.
+ * @param renderer The renderer; `renderer.camera`, `renderer.centers`,
+ *                 `renderer.scales`, `renderer.orbitRadii` and
+ *                 `renderer.sunPosition` receive the placement.
+ * @param scene The scene being rendered.
+ * @param bodies Array that receives the indices of the bodies to draw.
+ * @return The number of bodies to draw.
+ *
+ * Positions are computed in double precision, in world units. The origin
+ * is the point the camera looks at: the selected body, the Sun in the
+ * overview, or a point of the camera's flight, see `frameView`. Every
+ * position is then made relative to it and divided by the size of a render
+ * unit in the same pass, and only the result is stored in single
+ * precision. At the scene's scale, a render unit is a scene unit and a
+ * close-up only draws the selected body, lit by the Sun from where it would
+ * be on its orbit. In the true-scale mode, every body is drawn with its
+ * real size; a render unit is chosen so that the selected body, or
+ * Neptune's orbit in the overview, has the size it has at the scene's
+ * scale, so the camera distances stay the same. Every body is drawn during
+ * a flight. Orbits are only drawn in the overview, once the camera has
+ * arrived: seen from a close-up, they are far larger than the segments of
+ * their line loop can follow.
+ */
+static int placeBodies(Renderer &renderer, const SceneState &scene, int *bodies)
+{
+  int selected = scene.selectedElement;
+  bool closeUp = selected == cameraTarget(scene);
+  bool flying = scene.flight.active;
+
+  DVec3 positions[BODY_COUNT];
+  bodyWorldPositions(renderer, scene, positions);
+
+  DVec3 origin;
+  double unit = frameView(scene, positions, origin, renderer.camera);
+
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    const Body &body = BODIES[i];
+    renderer.centers[i].x = (float)((positions[i].x - origin.x) / unit);
+    renderer.centers[i].y = (float)((positions[i].y - origin.y) / unit);
+    renderer.centers[i].z = (float)((positions[i].z - origin.z) / unit);
+    renderer.scales[i] = scene.trueScale ? (float)(body.trueRadius / unit / body.radius) : 1.0f;
+    double orbitRadius = scene.trueScale ? body.trueOrbitRadius : renderer.bodyParams[i].orbitRadius;
+    renderer.orbitRadii[i] = closeUp || flying ? 0.0f : (float)(orbitRadius / unit);
+  }
+  renderer.sunPosition = renderer.centers[SUN];
+
+  int count = 0;
+  if (closeUp && !flying && !scene.trueScale)
+  {
+    bodies[count++] = selected;
+  }
+  else
+  {
+    for (int i = SUN; i < BODY_COUNT; ++i)
+      bodies[count++] = i;
+  }
+  return count;
+};
+
+/**
+ * @brief Returns the closest the camera may get to its target.
+ * @param renderer The renderer.
+ * @param scene The scene, whose selection and scale give the target.
+ * @return The distance, in render units.
+ */
+float cameraMinDistance(const Renderer &renderer, const SceneState &scene)
+{
+  if (renderer.backend != RENDERER_CORE)
+    return CAMERA_MIN_DISTANCE;
+  const Body &target = BODIES[cameraTarget(scene)];
+  double radius = scene.trueScale ? target.trueRadius / renderUnit(scene) : target.radius;
+  return (float)radius * (1.0f + CAMERA_SURFACE_MARGIN);
+};
+
+/**
+ * @brief Selects a body and flies the camera to it.
+ * @param renderer The renderer.
+ * @param scene The scene.
+ * @param selection Index of the body to select, or -1 for the whole system.
+ * @param distance Distance the camera ends at.
+ *
+ * The start point is kept relative to the previous camera target, so a
+ * flight that interrupts another one starts where the camera is and then
+ * moves with the body it was flying to.
+ */
+void flyCamera(const Renderer &renderer, SceneState &scene, int selection, float distance)
+{
+  DVec3 positions[BODY_COUNT];
+  bodyWorldPositions(renderer, scene, positions);
+
+  DVec3 origin;
+  CameraState from;
+  double fromUnit = frameView(scene, positions, origin, from);
+  int fromBody = cameraTarget(scene);
+
+  scene.selectedElement = selection;
+  scene.camera.distance = std::max(distance, cameraMinDistance(renderer, scene));
+
+  const DVec3 &target = positions[cameraTarget(scene)];
+  DVec3 offset = {target.x - origin.x, target.y - origin.y, target.z - origin.z};
+  double separation = sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+  startCameraFlight(scene.flight, from, scene.camera, from.distance * fromUnit, scene.camera.distance * renderUnit(scene),
+                    separation);
+  scene.flight.fromBody = fromBody;
+  scene.flight.fromOffset.x = origin.x - positions[fromBody].x;
+  scene.flight.fromOffset.y = origin.y - positions[fromBody].y;
+  scene.flight.fromOffset.z = origin.z - positions[fromBody].z;
+};
+
+/**
+ * @brief Returns the viewing matrix of a camera.
+ * @param camera The camera, looking at the floating origin.
+ * @return The matrix `gluLookAt` would build, with the Y-axis up.
+ */
+static Mat4 cameraView(const CameraState &camera)
+{
+  Vec3 center = {0.0f, 0.0f, 0.0f};
+  Vec3 up = {0.0f, 1.0f, 0.0f};
+  return mat4LookAt(cameraEye(camera), center, up);
+};
+
+/**
+ * @brief Finds the body drawn under a point of the window.
+ * @param renderer The renderer.
+ * @param x Horizontal position, in pixels from the left of the window.
+ * @param y Vertical position, in pixels from the top of the window.
+ * @return The index of the nearest body under the point, or -1.
+ *
+ * The ray goes through the pixel's center. Its cone covers
+ * `PICK_RADIUS_PIXELS` at every distance: a pixel spans `2 / (f * height)`
+ * units per unit of distance, where `f` is the projection's vertical focal
+ * length.
+ */
+int pickBody(const Renderer &renderer, int x, int y)
+{
+  CullingBatch batch;
+  for (int k = 0; k < renderer.bodyCount; ++k)
+  {
+    int index = renderer.bodies[k];
+    addCullingSphere(batch, renderer.centers[index], BODIES[index].radius * renderer.scales[index]);
+  }
+
+  float ndcX = 2.0f * (x + 0.5f) / renderer.width - 1.0f;
+  float ndcY = 1.0f - 2.0f * (y + 0.5f) / renderer.height;
+  float spread = PICK_RADIUS_PIXELS * 2.0f / (renderer.projection.m[5] * renderer.height);
+  PickRay ray = pickRay(cameraView(renderer.camera), renderer.projection, ndcX, ndcY, spread);
+
+  size_t hit;
+  if (!pickSpheres(batch, ray, hit))
+    return -1;
+  return renderer.bodies[hit];
+};
+
+/**
+ * @brief Returns the transform placing a body in the current frame.
+ * @param renderer The renderer, holding the time and placement of the frame.
+ * @param index Index of the body.
+ * @return The rotation about the Y-axis by the orbital angle, followed by a
+ *         translation to the body's center.
+ *
+ * This is the CPU counterpart of the placement computed by the core vertex
+ * shader. The sun spins in place.
+ */
+static Mat4 bodyPlacement(const Renderer &renderer, int index)
+{
+  const BodyParams &params = renderer.bodyParams[index];
+  float angle = orbitAngle(renderer, params);
+  float c = cosf(angle);
+  float s = sinf(angle);
+  const Vec3 &center = renderer.centers[index];
+  Mat4 placement = {{c, 0.0f, -s, 0.0f,
+                     0.0f, 1.0f, 0.0f, 0.0f,
+                     s, 0.0f, c, 0.0f,
+                     center.x, center.y, center.z, 1.0f}};
+  return placement;
+};
+
+/**
+ * @brief Builds the occluder list of every body drawn this frame.
+ * @param renderer The renderer; `renderer.shadows` receives the lists.
+ * @param bodies Indices of the bodies to draw.
+ * @param count Number of bodies to draw.
+ *
+ * Only drawn bodies cast shadows, so a close-up shows no eclipse, but a
+ * ringed body is always shadowed by its ring. Every pair of bodies is tested
+ * against the penumbra cone, which is negligible next to drawing them. With
+ * lighting disabled, every list is left empty.
+ */
+static void buildShadowReceivers(Renderer &renderer, const int *bodies, int count)
+{
+  for (int i = 0; i < BODY_COUNT; ++i)
+    clearShadowReceiver(renderer.shadows[i]);
+  if (!renderer.lighting)
+    return;
+
+  const Vec3 *centers = renderer.centers;
+  float sunRadius = BODIES[SUN].radius * renderer.scales[SUN];
+  for (int k = 0; k < count; ++k)
+  {
+    int index = bodies[k];
+    const Body &body = BODIES[index];
+    if (index == SUN)
+      continue;
+
+    ShadowReceiver &receiver = renderer.shadows[index];
+    float scale = renderer.scales[index];
+    float extent = (bodyHasRing(body) ? ringBoundingRadius(body) : body.radius) * scale;
+    for (int j = 0; j < count; ++j)
+    {
+      int other = bodies[j];
+      if (other == SUN || other == index)
+        continue;
+      float radius = BODIES[other].radius * renderer.scales[other];
+      if (castsShadow(renderer.sunPosition, sunRadius, centers[other], radius, centers[index], extent))
+        addShadowSphere(receiver, centers[other], radius);
+    }
+
+    if (bodyHasRing(body))
+    {
+      Vec3 axis = {0.0f, 0.0f, 1.0f};
+      setShadowRing(receiver, centers[index], mat4TransformPoint(ringTilt(), axis), body.innerRingRadius * scale, ringBoundingRadius(body) * scale);
+    }
+  }
+};
+
+/**
+ * @brief Culls and submits the bodies drawn this frame.
+ * @param renderer The renderer.
+ * @param view The viewing matrix of the frame.
+ * @param scene The scene being rendered.
+ * @param bodies Indices of the bodies to draw.
+ * @param count Number of bodies to draw.
+ *
+ * Every body contributes three bounding spheres to one batch: the body itself
+ * with its atmosphere, its ring and its orbit. The whole batch is tested
+ * against the frustum at once, then only the visible parts are submitted; the
+ * others are counted in `renderer.stats`. The spheres are centered where
+ * `placeBodies` put the bodies; their placement matrices are built by the
+ * executor.
+ */
+static void submitBodies(Renderer &renderer, const Mat4 &view, const SceneState &scene, const int *bodies, int count)
+{
+  const Vec3 *centers = renderer.centers;
+  const float *orbitRadii = renderer.orbitRadii;
+
+  CullingBatch &batch = renderer.culling;
+  clearCullingBatch(batch);
+  for (int k = 0; k < count; ++k)
+  {
+    int index = bodies[k];
+    const Body &body = BODIES[index];
+    float scale = renderer.scales[index];
+    addCullingSphere(batch, centers[index], body.radius * scale * (1.0f + ATMOSPHERES[index].thickness));
+    addCullingSphere(batch, centers[index], bodyHasRing(body) ? ringBoundingRadius(body) * scale : 0.0f);
+    addCullingSphere(batch, centers[SUN], orbitRadii[index]);
+  }
+
+  Frustum frustum = extractFrustum(mat4Multiply(renderer.projection, view));
+  cullSpheres(frustum, batch);
+
+  RenderStats &stats = renderer.stats;
+  stats.bodiesCulled = 0;
+  stats.ringsCulled = 0;
+  stats.orbitsCulled = 0;
+  for (int k = 0; k < count; ++k)
+  {
+    int index = bodies[k];
+    const Body &body = BODIES[index];
+    const unsigned char *visible = &batch.visible[3 * k];
+
+    if (visible[0])
+    {
+      submitTexturedSphere(renderer, view, index, centers[index]);
+      submitAtmosphere(renderer, view, index, centers[index]);
+    }
+    else
+      ++stats.bodiesCulled;
+
+    if (bodyHasRing(body))
+    {
+      if (visible[1])
+        submitSaturnRing(renderer, view, index, centers[index]);
+      else
+        ++stats.ringsCulled;
+    }
+
+    if (scene.showOrbits && orbitRadii[index] > 0.0f)
+    {
+      if (visible[2])
+        submitOrbit(renderer, view, orbitRadii[index]);
+      else
+        ++stats.orbitsCulled;
+    }
+  }
+};
+
+/**
+ * @brief Binds a mesh's buffers and sets up its vertex arrays.
+ * @param mesh The mesh to bind.
+ */
+static void bindMesh(const GpuMesh &mesh)
+{
+  glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+
+  if (mesh.textured)
+  {
+    GLsizei stride = MESH_VERTEX_FLOATS * sizeof(float);
+    glVertexPointer(3, GL_FLOAT, stride, (const GLvoid *)0);
+    glNormalPointer(GL_FLOAT, stride, (const GLvoid *)(3 * sizeof(float)));
+    glTexCoordPointer(2, GL_FLOAT, stride, (const GLvoid *)(6 * sizeof(float)));
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  }
+  else
+  {
+    glVertexPointer(3, GL_FLOAT, 0, (const GLvoid *)0);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  }
+};
+
+/**
+ * @brief Draws the sorted render queue.
+ * @param renderer The renderer.
+ * @param view The viewing matrix of the frame.
+ *
+ * Blending, texture and mesh state are only touched when they differ from the
+ * previous command; the number of changes is recorded in `renderer.stats`.
+ * The fixed-function pipeline cannot place bodies itself, so the placement of
+ * every body is computed once here and combined with each command's model
+ * matrix; rings are only translated to their body. The Sun's light is placed
+ * with the viewing matrix, since OpenGL stores light positions in eye
+ * coordinates, and is evaluated per vertex. Shadows cannot be computed per
+ * pixel either: a body in the shadow of another is dimmed as a whole by the
+ * fraction of the Sun seen from its center, and ring shadows are not drawn.
+ */
+static void executeRenderQueue(Renderer &renderer, const Mat4 &view)
+{
+  renderer.placements.resize(renderer.bodyParams.size());
+  for (size_t i = 0; i < renderer.bodyParams.size(); ++i)
+    renderer.placements[i] = mat4Multiply(view, bodyPlacement(renderer, (int)i));
+
+  float sunVisibility[BODY_COUNT];
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    sunVisibility[i] = 1.0f;
+    const ShadowReceiver &receiver = renderer.shadows[i];
+    const Vec3 &center = renderer.centers[i];
+    for (int s = 0; s < receiver.sphereCount; ++s)
+    {
+      Vec3 occluder = {receiver.spheres[s][0], receiver.spheres[s][1], receiver.spheres[s][2]};
+      sunVisibility[i] *= sphereSunVisibility(center, renderer.sunPosition, BODIES[SUN].radius * renderer.scales[SUN], occluder, receiver.spheres[s][3]);
+    }
+  }
+
+  RenderQueue &queue = renderer.queue;
+  RenderStats &stats = renderer.stats;
+  stats.commands = (unsigned int)queue.order.size();
+  stats.textureBinds = 0;
+  stats.passChanges = 0;
+  stats.drawCalls = 0;
+
+  if (renderer.lighting)
+  {
+    GLfloat sun[] = {renderer.sunPosition.x, renderer.sunPosition.y, renderer.sunPosition.z, 1.0f};
+    glLoadMatrixf(view.m);
+    glLightfv(GL_LIGHT0, GL_POSITION, sun);
+  }
+
+  int currentPass = -1;
+  int currentLit = -1;
+  unsigned int currentTexture = ~0u;
+  unsigned int currentMesh = ~0u;
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  for (size_t i = 0; i < queue.order.size(); ++i)
+  {
+    const RenderCommand &command = queue.commands[queue.order[i]];
+
+    RenderPass pass = renderKeyPass(queue.keys[i]);
+    if ((int)pass != currentPass)
+    {
+      if (pass == RENDER_PASS_TRANSPARENT)
+      {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      }
+      else
+      {
+        glDisable(GL_BLEND);
+      }
+      currentPass = pass;
+      ++stats.passChanges;
+    }
+
+    if (command.texture != currentTexture)
+    {
+      if (command.texture)
+      {
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, command.texture);
+        ++stats.textureBinds;
+      }
+      else
+      {
+        glDisable(GL_TEXTURE_2D);
+      }
+      currentTexture = command.texture;
+    }
+
+    int lit = (command.flags & RENDER_FLAG_LIT) && renderer.lighting;
+    if (lit != currentLit)
+    {
+      if (lit)
+        glEnable(GL_LIGHTING);
+      else
+        glDisable(GL_LIGHTING);
+      currentLit = lit;
+    }
+
+    if (command.mesh != currentMesh)
+    {
+      bindMesh(renderer.meshes[command.mesh]);
+      currentMesh = command.mesh;
+    }
+
+    Mat4 modelView;
+    if (command.flags & RENDER_FLAG_RING)
+    {
+      const Vec3 &center = renderer.centers[command.body];
+      modelView = mat4Multiply(mat4Multiply(view, mat4Translate(center.x, center.y, center.z)), command.model);
+    }
+    else
+    {
+      const Mat4 &placement = command.body >= 0 ? renderer.placements[command.body] : view;
+      modelView = mat4Multiply(placement, command.model);
+    }
+    glLoadMatrixf(modelView.m);
+    if (lit && command.body >= 0 && sunVisibility[command.body] < 1.0f)
+    {
+      float visibility = sunVisibility[command.body];
+      glColor4f(command.color[0] * visibility, command.color[1] * visibility, command.color[2] * visibility, command.color[3]);
+    }
+    else
+    {
+      glColor4fv(command.color);
+    }
+
+    const GpuMesh &mesh = renderer.meshes[command.mesh];
+    if (mesh.indexBuffer)
+      glDrawElements(mesh.mode, mesh.count, GL_UNSIGNED_INT, (const GLvoid *)0);
+    else
+      glDrawArrays(mesh.mode, 0, mesh.count);
+    ++stats.drawCalls;
+  }
+
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glDisable(GL_BLEND);
+  glDisable(GL_LIGHTING);
+  glEnable(GL_TEXTURE_2D);
+  glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+};
+
+/**
+ * @brief Renders one frame of the scene.
+ * @param renderer The renderer.
+ * @param scene The scene to render.
+ */
+void renderScene(Renderer &renderer, const SceneState &scene)
+{
+  if (renderer.backend == RENDERER_CORE)
+    beginCoreFrame(renderer);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  beginGpuProfilerFrame(renderer.profiler);
+
+  renderer.time = (float)scene.simulation.rotationAngle;
+  renderer.bodyCount = placeBodies(renderer, scene, renderer.bodies);
+  const int *bodies = renderer.bodies;
+  int count = renderer.bodyCount;
+  Mat4 view = cameraView(renderer.camera);
+
+  buildShadowReceivers(renderer, bodies, count);
+  if (renderer.backend == RENDERER_CORE)
+    updateCoreFrame(renderer, view);
+  beginGpuTimer(renderer.profiler, GPU_TIMER_STARFIELD);
+  drawStarfield(renderer, view, starMagnitudeLimit(renderer.camera.distance, cameraMinDistance(renderer, scene)));
+  endGpuTimer(renderer.profiler);
+
+  clearRenderQueue(renderer.queue);
+  submitBodies(renderer, view, scene, bodies, count);
+
+  sortRenderQueue(renderer.queue);
+  beginGpuTimer(renderer.profiler, GPU_TIMER_BODIES);
+  if (renderer.backend == RENDERER_CORE)
+    executeCoreRenderQueue(renderer);
+  else
+    executeRenderQueue(renderer, view);
+  endGpuTimer(renderer.profiler);
+  if (renderer.backend == RENDERER_CORE)
+    presentCoreFrame(renderer);
+
+  renderer.stats.starfieldGpuMs = renderer.profiler.milliseconds[GPU_TIMER_STARFIELD];
+  renderer.stats.bodiesGpuMs = renderer.profiler.milliseconds[GPU_TIMER_BODIES];
+};
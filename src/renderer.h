@@ -0,0 +1,307 @@
+/**
+ * @file renderer.h
+ * @brief Declares the solar system renderer.
+ *
+ * This file declares the renderer state and the functions that set up
+ * OpenGL, load the body textures and draw a scene. The renderer only needs a
+ * current OpenGL context; presenting the frame is left to the caller. Frames
+ * are built the same way for every backend; only the execution of the sorted
+ * render queue differs between the fixed-function and the core-profile
+ * pipelines.
+ *
+ * Body positions are computed in double precision, in kilometres in the
+ * true-scale mode, relative to a floating origin at the camera's target.
+ * They are converted to single-precision render units once per frame, so
+ * the matrices and buffers the GPU reads stay small and exact near the
+ * camera whatever the size of the scene.
+ */
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <vector>
+
+#include "bodies.h"
+#include "ephemeris.h"
+#include "frustum.h"
+#include "gpu_profiler.h"
+#include "opengl.h"
+#include "render_queue.h"
+#include "renderer_core.h"
+#include "scene.h"
+#include "shadows.h"
+#include "starfield.h"
+
+/**
+ * @def RING_DISK_COUNT
+ * @brief Number of concentric disks used to draw a ring.
+ */
+#define RING_DISK_COUNT 25
+
+/**
+ * @def RING_DISK_OFFSET
+ * @brief Extra spacing added to the inner radius of every other ring disk.
+ */
+#define RING_DISK_OFFSET 0.5f
+
+/**
+ * @def FRAME_UNIFORM_BINDING
+ * @brief Uniform buffer binding point of the per-frame block in the core backend.
+ */
+#define FRAME_UNIFORM_BINDING 0
+
+/**
+ * @def SHADOW_UNIFORM_BINDING
+ * @brief Uniform buffer binding point of the shadow occluders in the core backend.
+ */
+#define SHADOW_UNIFORM_BINDING 1
+
+/**
+ * @def BODY_TEXTURE_UNIT
+ * @brief Texture unit of the body parameter buffer in the core backend.
+ */
+#define BODY_TEXTURE_UNIT 1
+
+/**
+ * @def TRANSPARENT_TEXTURE_UNIT
+ * @brief First of the two texture units the core backend reads its
+ *        transparency targets from when resolving them.
+ */
+#define TRANSPARENT_TEXTURE_UNIT 2
+
+/**
+ * @def ATMOSPHERE_TEXTURE_UNIT
+ * @brief First of the two texture units holding the core backend's
+ *        atmosphere transmittance and scattering tables.
+ */
+#define ATMOSPHERE_TEXTURE_UNIT 4
+
+/**
+ * @def BODY_TEXTURE_WIDTH
+ * @brief Width of a layer of the core backend's body texture array.
+ */
+#define BODY_TEXTURE_WIDTH 2048
+
+/**
+ * @def BODY_TEXTURE_HEIGHT
+ * @brief Height of a layer of the core backend's body texture array.
+ */
+#define BODY_TEXTURE_HEIGHT 1024
+
+/**
+ * @def AMBIENT_LIGHT
+ * @brief Fraction of its color a lit surface keeps on its night side.
+ *
+ * Space has no ambient light, but a night side drawn black would hide the
+ * body against the sky.
+ */
+#define AMBIENT_LIGHT 0.08f
+
+/**
+ * @def LOG_DEPTH_NEAR
+ * @brief Near clipping plane of the core backend, in render units.
+ *
+ * The core backend writes a logarithmic depth, whose precision is a fixed
+ * fraction of the distance, so one pass covers the whole range without
+ * z-fighting. In the true-scale close-ups, a render unit stands for 12,000
+ * to 350,000 km, which puts the near plane at most about 4 m away.
+ */
+#define LOG_DEPTH_NEAR 1e-8f
+
+/**
+ * @def LOG_DEPTH_FAR
+ * @brief Far clipping plane of the core backend, in render units, past 100 AU
+ *        in every true-scale close-up.
+ */
+#define LOG_DEPTH_FAR 1e7f
+
+/**
+ * @def CAMERA_SURFACE_MARGIN
+ * @brief Smallest altitude of the camera above its target's surface, as a
+ *        fraction of the target's radius, with the core backend.
+ */
+#define CAMERA_SURFACE_MARGIN 1e-5f
+
+/**
+ * @def PICK_RADIUS_PIXELS
+ * @brief Distance from a body's outline, in pixels, within which a click
+ *        still picks it.
+ */
+#define PICK_RADIUS_PIXELS 4.0f
+
+/**
+ * @enum RendererBackend
+ * @brief OpenGL pipelines the renderer can draw with.
+ */
+enum RendererBackend
+{
+  RENDERER_LEGACY = 0, ///< Fixed-function pipeline, legacy or compatibility contexts.
+  RENDERER_CORE        ///< GLSL shaders, VAOs and uniform buffers, OpenGL 3.3 core profile.
+};
+
+/**
+ * @struct GpuMesh
+ * @brief Mesh stored in OpenGL buffer objects.
+ */
+struct GpuMesh
+{
+  GLuint vertexBuffer; ///< Buffer holding the vertices.
+  GLuint indexBuffer;  ///< Buffer holding the indices, or 0 for non-indexed meshes.
+  GLsizei count;       ///< Number of indices, or of vertices for non-indexed meshes.
+  GLenum mode;         ///< Primitive type passed to the draw call.
+  bool textured;       ///< Whether vertices carry normals and texture coordinates.
+  GLuint first;        ///< First index, or first vertex for non-indexed meshes, in the core backend's pool.
+  GLint baseVertex;    ///< Offset of the mesh's vertices in the core backend's pool.
+};
+
+/**
+ * @struct BodyParams
+ * @brief Orbital parameters of a body, as stored in the body buffer.
+ *
+ * A body turns on itself by `time * orbitSpeed + orbitPhase` degrees about
+ * the Y-axis, where `time` is the simulation angle, like it moves along its
+ * orbit of radius `orbitRadius`. Its position is evaluated on the CPU for
+ * every frame from `Renderer::ephemeris`, see `Renderer::centers`; the core
+ * vertex shader only computes the rotation, so the buffer is uploaded once.
+ */
+struct BodyParams
+{
+  float orbitRadius; ///< Radius of the orbit around the sun.
+  float orbitSpeed;  ///< Angular speed, in degrees per unit of simulation angle.
+  float orbitPhase;  ///< Angle of the body at time 0, in degrees.
+  float radius;      ///< Radius of the body.
+};
+
+/**
+ * @enum RendererMesh
+ * @brief Indices of the shared meshes in `Renderer::meshes`.
+ */
+enum RendererMesh
+{
+  MESH_SPHERE = 0, ///< Unit sphere, scaled to each body's radius.
+  MESH_ORBIT,      ///< Unit orbit, scaled to each orbit's radius.
+  MESH_RING_FIRST  ///< First of the ring disk meshes.
+};
+
+/**
+ * @struct Renderer
+ * @brief OpenGL resources and viewport of the renderer.
+ */
+struct Renderer
+{
+  RendererBackend backend;             ///< Pipeline used to execute the render queue.
+  CoreBackend core;                    ///< State of the core backend, unused by the legacy one.
+  GLuint bodyTextures[BODY_COUNT];     ///< Surface texture of every body, indexed by `BodyIndex`; with the core backend, its layer in the texture array plus one.
+  GLuint saturnRingTexture;            ///< Texture of Saturn's rings.
+  std::vector<GpuMesh> meshes;         ///< Meshes referenced by render commands, see `RendererMesh`.
+  unsigned int ringMeshes[BODY_COUNT]; ///< First of the `RING_DISK_COUNT` disk meshes of each ringed body.
+  std::vector<BodyParams> bodyParams;  ///< Orbital parameters of every body, indexed by `BodyIndex`.
+  Ephemeris ephemeris;                 ///< Precomputed positions of every body along the simulation period.
+  std::vector<Mat4> placements;        ///< Viewing matrix times the placement of every body, used by the legacy executor.
+  float time;                          ///< Simulation angle of the frame being rendered.
+  CameraState camera;                  ///< Camera of the frame being rendered, the scene's or a point of its flight.
+  Vec3 centers[BODY_COUNT];            ///< Center of every body relative to the floating origin, in render units.
+  float scales[BODY_COUNT];            ///< Factor applied to the catalog size of every body, its ring and its atmosphere.
+  float orbitRadii[BODY_COUNT];        ///< Radius of every orbit in render units, or 0 if it is not drawn.
+  int bodies[BODY_COUNT];              ///< Indices of the bodies drawn in the frame being rendered.
+  int bodyCount;                       ///< Number of bodies drawn in the frame being rendered.
+  bool lighting;                       ///< Whether the Sun lights the planets; otherwise every surface is drawn at full color.
+  Vec3 sunPosition;                    ///< Position of the Sun relative to the floating origin in the frame being rendered.
+  ShadowReceiver shadows[BODY_COUNT];  ///< Occluders shadowing every body in the frame being rendered.
+  RenderQueue queue;                   ///< Commands of the frame being rendered.
+  RenderStats stats;                   ///< Counters of the last rendered frame.
+  CullingBatch culling;                ///< Bounding spheres tested against the view frustum.
+  Starfield starfield;                 ///< Stars drawn behind the scene.
+  GpuProfiler profiler;                ///< Timer queries measuring the GPU time of every pass.
+  Mat4 projection;                     ///< Projection matrix, also used to extract the frustum.
+  int width;                           ///< Width of the viewport, in pixels.
+  int height;                          ///< Height of the viewport, in pixels.
+};
+
+/**
+ * @brief Initializes OpenGL settings and loads textures.
+ * @param renderer The renderer to initialize.
+ * @param backend The pipeline to draw with.
+ * @return True on success; false if the current context cannot run the
+ *         requested backend, in which case no resources are created.
+ *
+ * This function sets up OpenGL settings, such as enabling texture mapping,
+ * depth testing and lighting, and loads the textures of all celestial bodies and the
+ * star catalog `STAR_CATALOG`. A missing catalog only leaves the background
+ * black. The core backend requires an OpenGL 3.3 context and the shaders listed in
+ * `shaders.h`.
+ */
+bool initRenderer(Renderer &renderer, RendererBackend backend = RENDERER_LEGACY);
+
+/**
+ * @brief Adjusts the viewport and projection to a new framebuffer size.
+ * @param renderer The renderer.
+ * @param width The new width, in pixels.
+ * @param height The new height, in pixels.
+ *
+ * With the core backend, this also recreates the offscreen targets frames
+ * are drawn into, so it must be called before the first frame.
+ */
+void resizeRenderer(Renderer &renderer, int width, int height);
+
+/**
+ * @brief Returns the closest the camera may get to its target.
+ * @param renderer The renderer.
+ * @param scene The scene, whose selection and scale give the target.
+ * @return Just above the target's surface with the core backend, whose
+ *         logarithmic depth allows it; `CAMERA_MIN_DISTANCE` with the
+ *         legacy one, whose near plane is 1 unit away.
+ */
+float cameraMinDistance(const Renderer &renderer, const SceneState &scene);
+
+/**
+ * @brief Selects a body and flies the camera to it.
+ * @param renderer The renderer, whose placement of the bodies the flight follows.
+ * @param scene The scene; its selection, camera distance and flight are updated.
+ * @param selection Index of the body to select, or -1 for the whole system.
+ * @param distance Distance the camera ends at, raised to `cameraMinDistance`.
+ *
+ * The flight starts from the view of the current frame, even in the middle
+ * of another flight, and ends looking at the new camera target from the
+ * scene's camera angles. Only the path is planned here: every frame then
+ * evaluates it between the bodies' positions at that frame's time, so the
+ * target can keep moving on its orbit while the camera flies to it.
+ */
+void flyCamera(const Renderer &renderer, SceneState &scene, int selection, float distance);
+
+/**
+ * @brief Finds the body drawn under a point of the window.
+ * @param renderer The renderer, holding the placement of the last frame.
+ * @param x Horizontal position, in pixels from the left of the window.
+ * @param y Vertical position, in pixels from the top of the window.
+ * @return The index of the nearest body under the point, or -1 if there is none.
+ *
+ * A ray is cast from the last frame's camera against the bounding spheres
+ * of the bodies it drew, see `picking.h`. Bodies are picked within
+ * `PICK_RADIUS_PIXELS` of their outline, so the true-scale planets, far
+ * smaller than a pixel, can be clicked; rings and atmospheres are not.
+ */
+int pickBody(const Renderer &renderer, int x, int y);
+
+/**
+ * @brief Renders one frame of the scene.
+ * @param renderer The renderer.
+ * @param scene The scene to render.
+ *
+ * This function clears the color and depth buffers, sets up the camera
+ * view, draws the starfield, and draws all celestial bodies based on the
+ * current state, lit by the Sun unless `renderer.lighting` is false. It also
+ * handles the selection of individual planets or the entire solar system,
+ * at the scene's scale or, in the true-scale mode, with the real sizes and
+ * distances of the bodies around the selected one. The camera is placed
+ * together with the bodies, on its flight if one is in progress.
+ * Bodies, rings and orbits whose bounding spheres lie outside the view
+ * frustum are culled; the others are submitted to the render queue, which is
+ * sorted and then executed with redundant state changes skipped; the core
+ * backend blends transparent commands independently of their order. The GPU
+ * time of the starfield and of the render queue, as measured a few frames
+ * earlier, is recorded in `renderer.stats`.
+ */
+void renderScene(Renderer &renderer, const SceneState &scene);
+
+#endif // RENDERER_H
@@ -0,0 +1,747 @@
+/**
+ * @file renderer_core.cpp
+ * @brief Implements the core-profile backend of the renderer.
+ *
+ * The core backend draws the same render queue as the fixed-function
+ * executor. The camera matrices, the time and the centers of the bodies
+ * relative to the floating origin are written once per frame to a uniform
+ * buffer, and the orbital parameters of the bodies are uploaded once to a
+ * buffer texture; the vertex shader places and turns the bodies from them,
+ * so animating any number of bodies costs one uniform buffer write per
+ * frame. The same buffer holds the position of the Sun, which lights the
+ * bodies per pixel in the fragment shader; a second one holds the occluders
+ * that shadow every body. Atmospheres are drawn from lookup tables computed
+ * once, or read from their cache, when the backend is initialized.
+ *
+ * Commands do not set any uniform. Each one becomes an instance record and
+ * an indirect draw command; since meshes share pooled buffers and surfaces
+ * share one texture array, a run of commands of the same pass and pool is
+ * drawn by a single call, whatever the number of bodies.
+ *
+ * Transparent commands are not sorted by depth. They are summed into an
+ * accumulation target and a weight target with weighted blended
+ * order-independent transparency, then a full-screen pass divides the sums
+ * and blends the average over the opaque scene. The result is the same
+ * whichever order rings and other transparent geometry are drawn in, at the
+ * cost of approximating the blending of overlapping layers.
+ */
+
+#include "renderer_core.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "atmosphere.h"
+#include "geometry.h"
+#include "renderer.h"
+#include "shader.h"
+#include "shaders.h"
+
+#if defined(GL_VERSION_4_3)
+/**
+ * @def SOLAR_HAVE_MULTI_DRAW_INDIRECT
+ * @brief Defined when the OpenGL headers declare the multi-draw-indirect entry points.
+ */
+#define SOLAR_HAVE_MULTI_DRAW_INDIRECT
+#endif
+
+/**
+ * @struct FrameUniforms
+ * @brief Contents of the `Frame` uniform block, in std140 layout.
+ */
+struct FrameUniforms
+{
+  Mat4 view;                    ///< Viewing matrix.
+  Mat4 projection;              ///< Projection matrix.
+  float sun[4];                 ///< Position of the Sun relative to the floating origin, then the ambient light.
+  float time;                   ///< Simulation angle, see `BodyParams`.
+  float logDepthNear;           ///< Inverse of the near plane, `LOG_DEPTH_NEAR`.
+  float logDepthScale;          ///< Inverse of the base-2 logarithm of the depth range.
+  float padding;                ///< Aligns the centers to 16 bytes.
+  float centers[BODY_COUNT][4]; ///< Center of every body relative to the floating origin, then its radius.
+};
+
+/**
+ * @brief Checks whether the context supports multi-draw-indirect calls.
+ * @param major Major version of the context.
+ * @param minor Minor version of the context.
+ * @return True for OpenGL 4.3 and later, or with `ARB_multi_draw_indirect`.
+ */
+static bool supportsMultiDrawIndirect(int major, int minor)
+{
+#ifdef SOLAR_HAVE_MULTI_DRAW_INDIRECT
+  if (major * 10 + minor >= 43)
+    return true;
+
+  GLint extensions = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+  for (GLint i = 0; i < extensions; ++i)
+  {
+    const char *name = (const char *)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+    if (name && strcmp(name, "GL_ARB_multi_draw_indirect") == 0)
+      return true;
+  }
+#endif
+  return false;
+};
+
+/**
+ * @brief Loads the atmosphere tables and hands them to the body program.
+ * @param core The core backend, whose body program is in use.
+ *
+ * Bodies with an atmosphere get consecutive slots in the tables; the
+ * `atmospheres` uniform maps every body to its slot, or to -1. The
+ * transmittance layers become a `GL_TEXTURE_2D_ARRAY` and the scattering
+ * blocks are stacked in one `GL_TEXTURE_3D`, both stored as 16-bit floats
+ * and bound once to `ATMOSPHERE_TEXTURE_UNIT` and the unit after it.
+ */
+static void initCoreAtmospheres(CoreBackend &core)
+{
+  AtmosphereParams params[BODY_COUNT];
+  GLfloat slots[2 * BODY_COUNT];
+  int count = 0;
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    slots[2 * i] = bodyHasAtmosphere(i) ? (GLfloat)count : -1.0f;
+    slots[2 * i + 1] = 1.0f + ATMOSPHERES[i].thickness;
+    if (bodyHasAtmosphere(i))
+      params[count++] = ATMOSPHERES[i];
+  }
+  glUniform2fv(glGetUniformLocation(core.program, "atmospheres"), BODY_COUNT, slots);
+  glUniform1i(glGetUniformLocation(core.program, "atmosphereCount"), count);
+  glUniform1i(glGetUniformLocation(core.program, "atmosphereTransmittance"), ATMOSPHERE_TEXTURE_UNIT);
+  glUniform1i(glGetUniformLocation(core.program, "atmosphereScattering"), ATMOSPHERE_TEXTURE_UNIT + 1);
+
+  core.atmosphereTextures[0] = core.atmosphereTextures[1] = 0;
+  if (count == 0)
+    return;
+
+  AtmosphereTables tables;
+  loadAtmosphereTables(params, count, tables);
+
+  glGenTextures(2, core.atmosphereTextures);
+  glActiveTexture(GL_TEXTURE0 + ATMOSPHERE_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, core.atmosphereTextures[0]);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB16F, ATMOSPHERE_TRANSMITTANCE_WIDTH, ATMOSPHERE_TRANSMITTANCE_HEIGHT, count, 0, GL_RGB, GL_FLOAT, &tables.transmittance[0]);
+  glActiveTexture(GL_TEXTURE0 + ATMOSPHERE_TEXTURE_UNIT + 1);
+  glBindTexture(GL_TEXTURE_3D, core.atmosphereTextures[1]);
+  glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, ATMOSPHERE_SCATTERING_WIDTH, ATMOSPHERE_SCATTERING_HEIGHT, ATMOSPHERE_SCATTERING_DEPTH * count, 0, GL_RGBA, GL_FLOAT, &tables.scattering[0]);
+
+  GLenum targets[2] = {GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D};
+  for (int t = 0; t < 2; ++t)
+  {
+    glActiveTexture(GL_TEXTURE0 + ATMOSPHERE_TEXTURE_UNIT + t);
+    glTexParameteri(targets[t], GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(targets[t], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(targets[t], GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(targets[t], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(targets[t], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(targets[t], GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  }
+  glActiveTexture(GL_TEXTURE0);
+};
+
+/**
+ * @brief Checks the context and creates the core backend's program and buffers.
+ * @param renderer The renderer being initialized.
+ * @return True if the context supports OpenGL 3.3 and the shaders were built.
+ *
+ * `renderer.bodyParams` must be filled before this function is called; it
+ * is uploaded to the body buffer here and never changes afterwards.
+ */
+bool initCoreBackend(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  int major = 0;
+  int minor = 0;
+  const char *version = (const char *)glGetString(GL_VERSION);
+  if (!version || sscanf(version, "%d.%d", &major, &minor) != 2 || major * 10 + minor < 33)
+  {
+    std::cerr << "The core renderer requires OpenGL 3.3, got " << (version ? version : "none") << std::endl;
+    return false;
+  }
+
+  core.program = loadShaderProgram(BODY_VERTEX_SHADER, BODY_FRAGMENT_SHADER);
+  if (!core.program)
+    return false;
+
+  core.compositeProgram = loadShaderProgram(COMPOSITE_VERTEX_SHADER, COMPOSITE_FRAGMENT_SHADER);
+  if (!core.compositeProgram)
+    return false;
+
+  GLuint frameBlock = glGetUniformBlockIndex(core.program, "Frame");
+  glUniformBlockBinding(core.program, frameBlock, FRAME_UNIFORM_BINDING);
+  GLuint shadowBlock = glGetUniformBlockIndex(core.program, "Shadows");
+  glUniformBlockBinding(core.program, shadowBlock, SHADOW_UNIFORM_BINDING);
+
+  glGenBuffers(1, &core.frameUniformBuffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, core.frameUniformBuffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, core.frameUniformBuffer);
+
+  glGenBuffers(1, &core.shadowUniformBuffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, core.shadowUniformBuffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(renderer.shadows), NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, SHADOW_UNIFORM_BINDING, core.shadowUniformBuffer);
+
+  glGenBuffers(1, &core.bodyBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, core.bodyBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, renderer.bodyParams.size() * sizeof(BodyParams), &renderer.bodyParams[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+  glGenTextures(1, &core.bodyBufferTexture);
+  glActiveTexture(GL_TEXTURE0 + BODY_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_BUFFER, core.bodyBufferTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, core.bodyBuffer);
+  glActiveTexture(GL_TEXTURE0);
+
+  glUseProgram(core.program);
+  glUniform1i(glGetUniformLocation(core.program, "surfaces"), 0);
+  glUniform1i(glGetUniformLocation(core.program, "bodies"), BODY_TEXTURE_UNIT);
+  core.weightedBlendedLocation = glGetUniformLocation(core.program, "weightedBlended");
+  initCoreAtmospheres(core);
+  glUseProgram(core.compositeProgram);
+  glUniform1i(glGetUniformLocation(core.compositeProgram, "accumulation"), TRANSPARENT_TEXTURE_UNIT);
+  glUniform1i(glGetUniformLocation(core.compositeProgram, "weights"), TRANSPARENT_TEXTURE_UNIT + 1);
+  glUseProgram(0);
+  glGenVertexArrays(1, &core.emptyVertexArray);
+
+  core.sceneFramebuffer = 0;
+  core.sceneRenderbuffers[0] = core.sceneRenderbuffers[1] = 0;
+  core.transparentFramebuffer = 0;
+  core.transparentTextures[0] = core.transparentTextures[1] = 0;
+  core.outputFramebuffer = 0;
+
+  glGenBuffers(1, &core.instanceBuffer);
+  core.multiDrawIndirect = supportsMultiDrawIndirect(major, minor);
+  core.indirectBuffer = 0;
+  if (core.multiDrawIndirect)
+    glGenBuffers(1, &core.indirectBuffer);
+  return true;
+};
+
+/**
+ * @brief Points the instanced attributes of the bound vertex array at an instance.
+ * @param offset Byte offset of the first instance in the instance buffer.
+ *
+ * The instance buffer must be bound to `GL_ARRAY_BUFFER`. Without
+ * multi-draw-indirect there is no base instance, so the fallback path moves
+ * these pointers before each instanced call.
+ */
+static void setInstanceAttributes(size_t offset)
+{
+  GLsizei stride = sizeof(CoreInstance);
+  for (int column = 0; column < 4; ++column)
+    glVertexAttribPointer(5 + column, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)(offset + offsetof(CoreInstance, model) + column * 4 * sizeof(float)));
+  glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)(offset + offsetof(CoreInstance, color)));
+  glVertexAttribIPointer(3, 1, GL_INT, stride, (const GLvoid *)(offset + offsetof(CoreInstance, body)));
+  glVertexAttribIPointer(4, 1, GL_INT, stride, (const GLvoid *)(offset + offsetof(CoreInstance, layer)));
+  glVertexAttribIPointer(10, 1, GL_INT, stride, (const GLvoid *)(offset + offsetof(CoreInstance, flags)));
+};
+
+/**
+ * @brief Moves every uploaded mesh into the shared pools.
+ * @param renderer The renderer whose meshes have been uploaded.
+ *
+ * The buffers of every mesh are copied on the GPU into the pool matching its
+ * vertex layout, its offsets in the pool are recorded, and its own buffers
+ * are deleted. Each pool gets a vertex array object that reads the mesh
+ * attributes from the pool and the instance attributes, advancing once per
+ * instance, from the instance buffer.
+ */
+void createCoreMeshPools(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  GLsizeiptr vertexBytes[MESH_POOL_COUNT] = {0, 0};
+  GLsizeiptr indexBytes = 0;
+  GLsizei strides[MESH_POOL_COUNT] = {MESH_VERTEX_FLOATS * sizeof(float), 3 * sizeof(float)};
+
+  std::vector<GLint> meshVertexBytes(renderer.meshes.size(), 0);
+  std::vector<GLint> meshIndexBytes(renderer.meshes.size(), 0);
+  for (size_t i = 0; i < renderer.meshes.size(); ++i)
+  {
+    GpuMesh &mesh = renderer.meshes[i];
+    MeshPool pool = mesh.indexBuffer ? MESH_POOL_SURFACES : MESH_POOL_LINES;
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &meshVertexBytes[i]);
+    mesh.baseVertex = (GLint)(vertexBytes[pool] / strides[pool]);
+    vertexBytes[pool] += meshVertexBytes[i];
+
+    if (mesh.indexBuffer)
+    {
+      glBindBuffer(GL_ARRAY_BUFFER, mesh.indexBuffer);
+      glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &meshIndexBytes[i]);
+      mesh.first = (GLuint)(indexBytes / sizeof(unsigned int));
+      indexBytes += meshIndexBytes[i];
+    }
+    else
+    {
+      mesh.first = (GLuint)mesh.baseVertex;
+    }
+  }
+
+  glGenBuffers(MESH_POOL_COUNT, core.vertexBuffers);
+  for (int pool = 0; pool < MESH_POOL_COUNT; ++pool)
+  {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, core.vertexBuffers[pool]);
+    glBufferData(GL_COPY_WRITE_BUFFER, vertexBytes[pool], NULL, GL_STATIC_DRAW);
+  }
+  glGenBuffers(1, &core.indexBuffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, core.indexBuffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, indexBytes, NULL, GL_STATIC_DRAW);
+
+  for (size_t i = 0; i < renderer.meshes.size(); ++i)
+  {
+    GpuMesh &mesh = renderer.meshes[i];
+    MeshPool pool = mesh.indexBuffer ? MESH_POOL_SURFACES : MESH_POOL_LINES;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, mesh.vertexBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, core.vertexBuffers[pool]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, (GLintptr)mesh.baseVertex * strides[pool], meshVertexBytes[i]);
+    glDeleteBuffers(1, &mesh.vertexBuffer);
+    mesh.vertexBuffer = 0;
+
+    if (mesh.indexBuffer)
+    {
+      glBindBuffer(GL_COPY_READ_BUFFER, mesh.indexBuffer);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, core.indexBuffer);
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, (GLintptr)mesh.first * sizeof(unsigned int), meshIndexBytes[i]);
+      glDeleteBuffers(1, &mesh.indexBuffer);
+      mesh.indexBuffer = 0;
+    }
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  glGenVertexArrays(MESH_POOL_COUNT, core.vertexArrays);
+  for (int pool = 0; pool < MESH_POOL_COUNT; ++pool)
+  {
+    glBindVertexArray(core.vertexArrays[pool]);
+    glBindBuffer(GL_ARRAY_BUFFER, core.vertexBuffers[pool]);
+    if (pool == MESH_POOL_SURFACES)
+    {
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, core.indexBuffer);
+      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strides[pool], (const GLvoid *)0);
+      glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, strides[pool], (const GLvoid *)(3 * sizeof(float)));
+      glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, strides[pool], (const GLvoid *)(6 * sizeof(float)));
+      glEnableVertexAttribArray(1);
+      glEnableVertexAttribArray(2);
+    }
+    else
+    {
+      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strides[pool], (const GLvoid *)0);
+    }
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, core.instanceBuffer);
+    setInstanceAttributes(0);
+    for (GLuint attribute = 3; attribute <= 10; ++attribute)
+    {
+      glEnableVertexAttribArray(attribute);
+      glVertexAttribDivisor(attribute, 1);
+    }
+  }
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+};
+
+/**
+ * @brief Turns the sorted render queue into instances, draw commands and batches.
+ * @param renderer The renderer.
+ *
+ * Consecutive commands of the same pass and mesh pool form a batch.
+ * Consecutive commands drawing the same mesh share one draw command with
+ * several instances; the order of the queue is preserved.
+ */
+static void buildCoreBatches(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  RenderQueue &queue = renderer.queue;
+  core.instances.clear();
+  core.elementDraws.clear();
+  core.arrayDraws.clear();
+  core.batches.clear();
+
+  unsigned int previousMesh = ~0u;
+  for (size_t i = 0; i < queue.order.size(); ++i)
+  {
+    const RenderCommand &command = queue.commands[queue.order[i]];
+    const GpuMesh &mesh = renderer.meshes[command.mesh];
+    RenderPass pass = renderKeyPass(queue.keys[i]);
+    MeshPool pool = mesh.mode == GL_TRIANGLES ? MESH_POOL_SURFACES : MESH_POOL_LINES;
+
+    GLuint instance = (GLuint)core.instances.size();
+    CoreInstance record;
+    record.model = command.model;
+    memcpy(record.color, command.color, sizeof(record.color));
+    record.body = command.body;
+    record.layer = (GLint)command.texture - 1;
+    record.flags = (GLint)command.flags;
+    core.instances.push_back(record);
+
+    bool newBatch = core.batches.empty() || core.batches.back().pass != pass || core.batches.back().pool != pool;
+    if (newBatch)
+    {
+      CoreBatch batch;
+      batch.pass = pass;
+      batch.pool = pool;
+      batch.first = (unsigned int)(pool == MESH_POOL_SURFACES ? core.elementDraws.size() : core.arrayDraws.size());
+      batch.count = 0;
+      core.batches.push_back(batch);
+    }
+    CoreBatch &batch = core.batches.back();
+
+    if (!newBatch && command.mesh == previousMesh)
+    {
+      if (pool == MESH_POOL_SURFACES)
+        ++core.elementDraws.back().instanceCount;
+      else
+        ++core.arrayDraws.back().instanceCount;
+      continue;
+    }
+
+    if (pool == MESH_POOL_SURFACES)
+    {
+      DrawElementsCommand draw = {(GLuint)mesh.count, 1, mesh.first, mesh.baseVertex, instance};
+      core.elementDraws.push_back(draw);
+    }
+    else
+    {
+      DrawArraysCommand draw = {(GLuint)mesh.count, 1, mesh.first, instance};
+      core.arrayDraws.push_back(draw);
+    }
+    ++batch.count;
+    previousMesh = command.mesh;
+  }
+};
+
+/**
+ * @brief Creates a texture for a transparency target.
+ * @param internalFormat Internal format of the texture.
+ * @param width Width of the texture, in pixels.
+ * @param height Height of the texture, in pixels.
+ * @return The OpenGL texture ID.
+ *
+ * The resolve reads the targets with `texelFetch`, so they have no mipmaps
+ * and are never filtered.
+ */
+static GLuint createTargetTexture(GLint internalFormat, GLsizei width, GLsizei height)
+{
+  GLuint texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  return texture;
+};
+
+/**
+ * @brief Deletes the scene and transparency targets.
+ * @param core The core backend.
+ */
+static void deleteCoreTargets(CoreBackend &core)
+{
+  glDeleteFramebuffers(1, &core.sceneFramebuffer);
+  glDeleteFramebuffers(1, &core.transparentFramebuffer);
+  glDeleteRenderbuffers(2, core.sceneRenderbuffers);
+  glDeleteTextures(2, core.transparentTextures);
+  core.sceneFramebuffer = 0;
+  core.sceneRenderbuffers[0] = core.sceneRenderbuffers[1] = 0;
+  core.transparentFramebuffer = 0;
+  core.transparentTextures[0] = core.transparentTextures[1] = 0;
+};
+
+/**
+ * @brief Creates the scene and transparency targets at the renderer's size.
+ * @param renderer The renderer, whose `width` and `height` have been set.
+ *
+ * The scene has an 8-bit color buffer and a depth buffer, which the
+ * transparency framebuffer shares so that opaque geometry hides transparent
+ * commands behind it. The accumulation target stores its sums as 16-bit
+ * floats; the weights of the depth function keep them well below the
+ * largest half-float.
+ */
+void resizeCoreTargets(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  GLint previousFramebuffer = 0;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+  deleteCoreTargets(core);
+
+  GLsizei width = (GLsizei)renderer.width;
+  GLsizei height = (GLsizei)renderer.height;
+  glGenRenderbuffers(2, core.sceneRenderbuffers);
+  glBindRenderbuffer(GL_RENDERBUFFER, core.sceneRenderbuffers[0]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, core.sceneRenderbuffers[1]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  core.transparentTextures[0] = createTargetTexture(GL_RGBA16F, width, height);
+  core.transparentTextures[1] = createTargetTexture(GL_R16F, width, height);
+
+  glGenFramebuffers(1, &core.sceneFramebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, core.sceneFramebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, core.sceneRenderbuffers[0]);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, core.sceneRenderbuffers[1]);
+  bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+  static const GLenum transparentBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+  glGenFramebuffers(1, &core.transparentFramebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, core.transparentFramebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, core.transparentTextures[0], 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, core.transparentTextures[1], 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, core.sceneRenderbuffers[1]);
+  glDrawBuffers(2, transparentBuffers);
+  complete = complete && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previousFramebuffer);
+  if (!complete)
+  {
+    std::cerr << "Transparency targets are not supported, transparent geometry will be blended in order" << std::endl;
+    deleteCoreTargets(core);
+  }
+};
+
+/**
+ * @brief Redirects the frame about to be drawn into the scene target.
+ * @param renderer The renderer.
+ */
+void beginCoreFrame(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  if (!core.sceneFramebuffer)
+    return;
+
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &core.outputFramebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, core.sceneFramebuffer);
+};
+
+/**
+ * @brief Copies the finished frame to the framebuffer bound by `beginCoreFrame`.
+ * @param renderer The renderer.
+ *
+ * The output framebuffer is left bound for both drawing and reading, so the
+ * caller can read the frame back or swap buffers.
+ */
+void presentCoreFrame(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  if (!core.sceneFramebuffer)
+    return;
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, core.sceneFramebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)core.outputFramebuffer);
+  glBlitFramebuffer(0, 0, renderer.width, renderer.height, 0, 0, renderer.width, renderer.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)core.outputFramebuffer);
+};
+
+/**
+ * @brief Starts accumulating transparent commands.
+ * @param core The core backend, whose body program is in use.
+ *
+ * The accumulation target is cleared to a revealage of 1 and the weights to
+ * 0. Colors and weights are added, while the revealage is multiplied by one
+ * minus the alpha of every fragment; depth is tested but not written, so
+ * every transparent layer in front of the opaque scene is counted.
+ */
+static void beginTransparentPass(CoreBackend &core)
+{
+  static const GLfloat clearAccumulation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  static const GLfloat clearWeights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, core.transparentFramebuffer);
+  glClearBufferfv(GL_COLOR, 0, clearAccumulation);
+  glClearBufferfv(GL_COLOR, 1, clearWeights);
+  glEnable(GL_BLEND);
+  glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+  glDepthMask(GL_FALSE);
+  glUniform1i(core.weightedBlendedLocation, 1);
+};
+
+/**
+ * @brief Blends the accumulated transparent commands over the scene.
+ * @param core The core backend.
+ */
+static void resolveTransparentPass(CoreBackend &core)
+{
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, core.sceneFramebuffer);
+  glDepthMask(GL_TRUE);
+  glDisable(GL_DEPTH_TEST);
+  glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+
+  glUseProgram(core.compositeProgram);
+  glActiveTexture(GL_TEXTURE0 + TRANSPARENT_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D, core.transparentTextures[0]);
+  glActiveTexture(GL_TEXTURE0 + TRANSPARENT_TEXTURE_UNIT + 1);
+  glBindTexture(GL_TEXTURE_2D, core.transparentTextures[1]);
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(core.emptyVertexArray);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+
+  glEnable(GL_DEPTH_TEST);
+};
+
+/**
+ * @brief Writes the camera matrices, the time and the body placement of a
+ *        frame to the uniform buffer.
+ * @param renderer The renderer, holding the projection, Sun position, shadow
+ *                 occluders, time and body placement of the frame.
+ * @param view The viewing matrix of the frame.
+ *
+ * With lighting disabled, the ambient light is 1, which leaves lit surfaces
+ * at their full color without a separate shader.
+ */
+void updateCoreFrame(Renderer &renderer, const Mat4 &view)
+{
+  FrameUniforms frame;
+  frame.view = view;
+  frame.projection = renderer.projection;
+  frame.sun[0] = renderer.sunPosition.x;
+  frame.sun[1] = renderer.sunPosition.y;
+  frame.sun[2] = renderer.sunPosition.z;
+  frame.sun[3] = renderer.lighting ? AMBIENT_LIGHT : 1.0f;
+  frame.time = renderer.time;
+  frame.logDepthNear = 1.0f / LOG_DEPTH_NEAR;
+  frame.logDepthScale = 1.0f / log2f(LOG_DEPTH_FAR / LOG_DEPTH_NEAR);
+  frame.padding = 0.0f;
+  for (int i = 0; i < BODY_COUNT; ++i)
+  {
+    frame.centers[i][0] = renderer.centers[i].x;
+    frame.centers[i][1] = renderer.centers[i].y;
+    frame.centers[i][2] = renderer.centers[i].z;
+    frame.centers[i][3] = BODIES[i].radius * renderer.scales[i];
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, renderer.core.frameUniformBuffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frame), &frame);
+  glBindBuffer(GL_UNIFORM_BUFFER, renderer.core.shadowUniformBuffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(renderer.shadows), renderer.shadows);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+};
+
+/**
+ * @brief Draws the sorted render queue with the core-profile pipeline.
+ * @param renderer The renderer.
+ *
+ * The instances and draw commands of the whole frame are uploaded at once.
+ * Blending is only switched between passes; the counters recorded in
+ * `renderer.stats` match those of the fixed-function executor and leave out
+ * the resolve of the transparent pass. Without transparency targets,
+ * transparent commands are alpha-blended in queue order.
+ */
+void executeCoreRenderQueue(Renderer &renderer)
+{
+  CoreBackend &core = renderer.core;
+  RenderStats &stats = renderer.stats;
+  stats.commands = (unsigned int)renderer.queue.order.size();
+  stats.textureBinds = 0;
+  stats.passChanges = 0;
+  stats.drawCalls = 0;
+
+  buildCoreBatches(renderer);
+
+  if (core.instances.empty())
+    return;
+
+  glBindBuffer(GL_ARRAY_BUFFER, core.instanceBuffer);
+  glBufferData(GL_ARRAY_BUFFER, core.instances.size() * sizeof(CoreInstance), &core.instances[0], GL_STREAM_DRAW);
+
+  size_t elementBytes = core.elementDraws.size() * sizeof(DrawElementsCommand);
+  size_t arrayBytes = core.arrayDraws.size() * sizeof(DrawArraysCommand);
+#ifdef SOLAR_HAVE_MULTI_DRAW_INDIRECT
+  if (core.multiDrawIndirect)
+  {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, core.indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, elementBytes + arrayBytes, NULL, GL_STREAM_DRAW);
+    if (elementBytes)
+      glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, elementBytes, &core.elementDraws[0]);
+    if (arrayBytes)
+      glBufferSubData(GL_DRAW_INDIRECT_BUFFER, elementBytes, arrayBytes, &core.arrayDraws[0]);
+  }
+#endif
+
+  glUseProgram(core.program);
+  glUniform1i(core.weightedBlendedLocation, 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, core.textureArray);
+  ++stats.textureBinds;
+
+  bool weightedBlended = core.transparentFramebuffer != 0;
+  bool transparent = false;
+
+  int currentPass = -1;
+  for (size_t b = 0; b < core.batches.size(); ++b)
+  {
+    const CoreBatch &batch = core.batches[b];
+    if ((int)batch.pass != currentPass)
+    {
+      if (batch.pass == RENDER_PASS_TRANSPARENT && weightedBlended)
+      {
+        beginTransparentPass(core);
+        transparent = true;
+      }
+      else if (batch.pass == RENDER_PASS_TRANSPARENT)
+      {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      }
+      else
+      {
+        glDisable(GL_BLEND);
+      }
+      currentPass = batch.pass;
+      ++stats.passChanges;
+    }
+
+    glBindVertexArray(core.vertexArrays[batch.pool]);
+
+#ifdef SOLAR_HAVE_MULTI_DRAW_INDIRECT
+    if (core.multiDrawIndirect)
+    {
+      if (batch.pool == MESH_POOL_SURFACES)
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const GLvoid *)(batch.first * sizeof(DrawElementsCommand)), batch.count, 0);
+      else
+        glMultiDrawArraysIndirect(GL_LINE_LOOP, (const GLvoid *)(elementBytes + batch.first * sizeof(DrawArraysCommand)), batch.count, 0);
+      ++stats.drawCalls;
+      continue;
+    }
+#endif
+
+    for (unsigned int d = batch.first; d < batch.first + batch.count; ++d)
+    {
+      if (batch.pool == MESH_POOL_SURFACES)
+      {
+        const DrawElementsCommand &draw = core.elementDraws[d];
+        setInstanceAttributes(draw.baseInstance * sizeof(CoreInstance));
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, draw.count, GL_UNSIGNED_INT, (const GLvoid *)(draw.firstIndex * sizeof(unsigned int)), draw.instanceCount, draw.baseVertex);
+      }
+      else
+      {
+        const DrawArraysCommand &draw = core.arrayDraws[d];
+        setInstanceAttributes(draw.baseInstance * sizeof(CoreInstance));
+        glDrawArraysInstanced(GL_LINE_LOOP, draw.first, draw.count, draw.instanceCount);
+      }
+      ++stats.drawCalls;
+    }
+  }
+
+  if (transparent)
+    resolveTransparentPass(core);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+#ifdef SOLAR_HAVE_MULTI_DRAW_INDIRECT
+  if (core.multiDrawIndirect)
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+#endif
+  glUseProgram(0);
+  glDisable(GL_BLEND);
+};
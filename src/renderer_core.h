@@ -0,0 +1,174 @@
+/**
+ * @file renderer_core.h
+ * @brief Declares the core-profile backend of the renderer.
+ *
+ * This header declares the state of the OpenGL 3.3 core-profile pipeline and
+ * the functions, internal to the renderer, that set it up and execute the
+ * sorted render queue with it. All meshes live in two shared buffer pools
+ * and every surface is sampled from one texture array, so consecutive
+ * commands of a pass are drawn together: with one multi-draw-indirect call
+ * when OpenGL 4.3 or `ARB_multi_draw_indirect` is available, and with one
+ * instanced call per mesh otherwise.
+ */
+
+#ifndef RENDERER_CORE_H
+#define RENDERER_CORE_H
+
+#include <vector>
+
+#include "opengl.h"
+#include "render_queue.h"
+
+struct Renderer;
+
+/**
+ * @enum MeshPool
+ * @brief Shared buffers the core backend stores meshes in, by vertex layout.
+ */
+enum MeshPool
+{
+  MESH_POOL_SURFACES = 0, ///< Indexed triangles with normals and texture coordinates.
+  MESH_POOL_LINES,        ///< Non-indexed line loops with positions only.
+  MESH_POOL_COUNT
+};
+
+/**
+ * @struct CoreInstance
+ * @brief Per-draw data read by the core vertex shader as instanced attributes.
+ */
+struct CoreInstance
+{
+  Mat4 model;     ///< Object transform, see `RenderCommand::model`.
+  float color[4]; ///< Color multiplied with the texture, alpha included.
+  GLint body;     ///< Body placing the draw, or -1.
+  GLint layer;    ///< Layer of the texture array, or -1 for untextured geometry.
+  GLint flags;    ///< Combination of `RenderFlag` values.
+};
+
+/**
+ * @struct DrawElementsCommand
+ * @brief Indexed indirect draw, laid out as `glMultiDrawElementsIndirect` reads it.
+ */
+struct DrawElementsCommand
+{
+  GLuint count;         ///< Number of indices.
+  GLuint instanceCount; ///< Number of instances.
+  GLuint firstIndex;    ///< First index in the pool's index buffer.
+  GLint baseVertex;     ///< Offset added to every index.
+  GLuint baseInstance;  ///< First instance in the instance buffer.
+};
+
+/**
+ * @struct DrawArraysCommand
+ * @brief Non-indexed indirect draw, laid out as `glMultiDrawArraysIndirect` reads it.
+ */
+struct DrawArraysCommand
+{
+  GLuint count;         ///< Number of vertices.
+  GLuint instanceCount; ///< Number of instances.
+  GLuint first;         ///< First vertex in the pool's vertex buffer.
+  GLuint baseInstance;  ///< First instance in the instance buffer.
+};
+
+/**
+ * @struct CoreBatch
+ * @brief Consecutive commands of one pass drawn from one mesh pool.
+ */
+struct CoreBatch
+{
+  RenderPass pass;    ///< Pass of the commands.
+  MeshPool pool;      ///< Pool of the meshes, selecting the draw command array.
+  unsigned int first; ///< First draw command of the batch.
+  unsigned int count; ///< Number of draw commands in the batch.
+};
+
+/**
+ * @struct CoreBackend
+ * @brief OpenGL objects and per-frame arrays of the core backend.
+ */
+struct CoreBackend
+{
+  GLuint program;                                ///< Shader program drawing every command.
+  GLint weightedBlendedLocation;                 ///< Location of the program's `weightedBlended` uniform.
+  GLuint compositeProgram;                       ///< Shader program resolving the transparent targets over the scene.
+  GLuint emptyVertexArray;                       ///< Vertex array object bound for the attribute-less full-screen triangle.
+  GLuint frameUniformBuffer;                     ///< Uniform buffer holding the camera matrices and the time.
+  GLuint shadowUniformBuffer;                    ///< Uniform buffer holding the shadow occluders of every body.
+  GLuint bodyBuffer;                             ///< Buffer holding the renderer's `bodyParams`.
+  GLuint bodyBufferTexture;                      ///< Buffer texture reading `bodyBuffer`.
+  GLuint textureArray;                           ///< Surface textures of all bodies, one layer per body.
+  GLuint atmosphereTextures[2];                  ///< Transmittance and scattering tables of every atmosphere, or 0 without atmospheres.
+  GLuint vertexArrays[MESH_POOL_COUNT];          ///< Vertex array object of every pool.
+  GLuint vertexBuffers[MESH_POOL_COUNT];         ///< Vertices of every pool.
+  GLuint indexBuffer;                            ///< Indices of the surface pool.
+  GLuint instanceBuffer;                         ///< Instances of the frame being rendered.
+  GLuint indirectBuffer;                         ///< Draw commands of the frame, or 0 without multi-draw-indirect.
+  bool multiDrawIndirect;                        ///< Whether batches are drawn with multi-draw-indirect calls.
+  GLuint sceneFramebuffer;                       ///< Framebuffer frames are drawn into, or 0 before the first resize.
+  GLuint sceneRenderbuffers[2];                  ///< Color and depth buffers of the scene framebuffer.
+  GLuint transparentFramebuffer;                 ///< Framebuffer accumulating transparent commands, sharing the scene's depth buffer.
+  GLuint transparentTextures[2];                 ///< Weighted color sum with the revealage in alpha, and weight sum.
+  GLint outputFramebuffer;                       ///< Framebuffer bound when the frame began, receiving the finished frame.
+  std::vector<CoreInstance> instances;           ///< Instances of the frame, in execution order.
+  std::vector<DrawElementsCommand> elementDraws; ///< Draws of surface pool batches.
+  std::vector<DrawArraysCommand> arrayDraws;     ///< Draws of line pool batches.
+  std::vector<CoreBatch> batches;                ///< Batches of the frame, in execution order.
+};
+
+/**
+ * @brief Checks the context and creates the core backend's program and buffers.
+ * @param renderer The renderer being initialized.
+ * @return True if the context supports OpenGL 3.3 and the shaders were built.
+ */
+bool initCoreBackend(Renderer &renderer);
+
+/**
+ * @brief Moves every uploaded mesh into the shared pools.
+ * @param renderer The renderer whose meshes have been uploaded.
+ */
+void createCoreMeshPools(Renderer &renderer);
+
+/**
+ * @brief Creates the scene and transparency targets at the renderer's size.
+ * @param renderer The renderer, whose `width` and `height` have been set.
+ *
+ * Previous targets are deleted. If the driver rejects the targets, they are
+ * left at 0 and frames are drawn directly into the caller's framebuffer, with
+ * transparent commands alpha-blended in queue order.
+ */
+void resizeCoreTargets(Renderer &renderer);
+
+/**
+ * @brief Redirects the frame about to be drawn into the scene target.
+ * @param renderer The renderer.
+ *
+ * The framebuffer bound when this is called receives the frame from
+ * `presentCoreFrame`.
+ */
+void beginCoreFrame(Renderer &renderer);
+
+/**
+ * @brief Copies the finished frame to the framebuffer bound by `beginCoreFrame`.
+ * @param renderer The renderer.
+ */
+void presentCoreFrame(Renderer &renderer);
+
+/**
+ * @brief Writes the camera matrices and the time of a frame to the uniform buffer.
+ * @param renderer The renderer, holding the projection, Sun position, shadow
+ *                 occluders, time and orbit scale of the frame.
+ * @param view The viewing matrix of the frame.
+ *
+ * Every program of the core backend reads the same `Frame` block, so this is
+ * called once per frame, before anything is drawn. The occluders are written
+ * to the `Shadows` block at the same time.
+ */
+void updateCoreFrame(Renderer &renderer, const Mat4 &view);
+
+/**
+ * @brief Draws the sorted render queue with the core-profile pipeline.
+ * @param renderer The renderer, whose frame uniforms are up to date.
+ */
+void executeCoreRenderQueue(Renderer &renderer);
+
+#endif // RENDERER_CORE_H
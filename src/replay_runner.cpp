@@ -0,0 +1,192 @@
+/**
+ * @file replay_runner.cpp
+ * @brief Implements the deterministic headless replay of input logs.
+ */
+
+#include "opengl.h"
+
+#include "replay_runner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "benchmark_runner.h"
+#include "hash.h"
+#include "headless_context.h"
+#include "input_handler.h"
+#include "input_log.h"
+
+/**
+ * @struct ReplayTarget
+ * @brief Offscreen framebuffer standing in for the window during a replay.
+ */
+struct ReplayTarget
+{
+  GLuint framebuffer; ///< Framebuffer object.
+  GLuint color;       ///< RGBA8 color renderbuffer.
+  GLuint depth;       ///< Depth and stencil renderbuffer.
+  int width;          ///< Width of the renderbuffers, in pixels.
+  int height;         ///< Height of the renderbuffers, in pixels.
+};
+
+/**
+ * @brief Allocates the renderbuffers of the replay target at a size.
+ * @param target The target.
+ * @param width New width, in pixels.
+ * @param height New height, in pixels.
+ */
+static void allocateReplayTarget(ReplayTarget &target, int width, int height)
+{
+  target.width = width > 1 ? width : 1;
+  target.height = height > 1 ? height : 1;
+  glBindRenderbuffer(GL_RENDERBUFFER, target.color);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, target.width, target.height);
+  glBindRenderbuffer(GL_RENDERBUFFER, target.depth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, target.width, target.height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+};
+
+/**
+ * @brief Creates and binds the replay target.
+ * @param target The target to create.
+ * @param width Width, in pixels.
+ * @param height Height, in pixels.
+ * @return True if the framebuffer is complete.
+ *
+ * The framebuffer stays bound for the whole replay, so both backends draw
+ * into it as they would into the window.
+ */
+static bool createReplayTarget(ReplayTarget &target, int width, int height)
+{
+  glGenFramebuffers(1, &target.framebuffer);
+  glGenRenderbuffers(1, &target.color);
+  glGenRenderbuffers(1, &target.depth);
+  allocateReplayTarget(target, width, height);
+  glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.color);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depth);
+  return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+};
+
+/**
+ * @brief Adds the pixels of the current frame to a checksum.
+ * @param target The target holding the frame.
+ * @param pixels Buffer the pixels are read into.
+ * @param checksum The running 64-bit FNV-1a hash.
+ */
+static void hashReplayFrame(const ReplayTarget &target, std::vector<unsigned char> &pixels, uint64_t &checksum)
+{
+  pixels.resize((size_t)target.width * target.height * 4);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, target.width, target.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+  checksum = fnv1a(&pixels[0], pixels.size(), checksum);
+};
+
+/**
+ * @brief Replays an input log without a window.
+ * @param logPath Path of the input log.
+ * @param reportPath Path of the JSON report written at the end of the replay.
+ * @return The process exit code.
+ *
+ * Each frame first feeds the events received up to its time, in order,
+ * then renders and times the frame, and finally advances the simulation
+ * and the camera flight by `REPLAY_STEP`, as the simulation timer does with
+ * the real elapsed time. The replay therefore renders the session's events
+ * on a fixed clock rather than at the wall-clock times of its frames, which
+ * is what makes it reproducible. Hashing the pixels is not timed.
+ */
+int runReplay(const char *logPath, const char *reportPath)
+{
+  InputLog log;
+  if (!readInputLog(logPath, log))
+  {
+    std::cerr << "Failed to read input log: " << logPath << std::endl;
+    return 1;
+  }
+
+  bool core = (log.flags & INPUT_LOG_CORE_RENDERER) != 0;
+  if (!createHeadlessContext(core ? 3 : 2, core ? 3 : 1, core))
+  {
+    std::cerr << "Failed to create a headless OpenGL context" << std::endl;
+    return 1;
+  }
+
+  ReplayTarget target;
+  if (!createReplayTarget(target, (int)log.width, (int)log.height) ||
+      !initRenderer(renderer, core ? RENDERER_CORE : RENDERER_LEGACY))
+  {
+    std::cerr << "Failed to initialize the renderer for the replay" << std::endl;
+    destroyHeadlessContext();
+    return 1;
+  }
+  renderer.lighting = (log.flags & INPUT_LOG_LIGHTING) != 0;
+  resizeRenderer(renderer, target.width, target.height);
+
+  std::cout << "Replaying " << logPath << ": " << log.records.size() << " events" << std::endl;
+
+  BenchmarkResult result = makeBenchmarkResult("replay");
+
+  InputQueue queue;
+  std::vector<unsigned char> pixels;
+  uint64_t checksum = FNV1A_OFFSET_BASIS;
+  size_t next = 0;
+  int tailFrames = 0;
+  bool quit = false;
+  for (unsigned long frame = 0; !quit && tailFrames < REPLAY_TAIL_FRAMES; ++frame)
+  {
+    double frameTime = frame * REPLAY_STEP * 1000.0;
+    for (; next < log.records.size() && log.records[next].time <= frameTime; ++next)
+    {
+      InputEvent event = inputRecordEvent(log.records[next]);
+      if (event.type == INPUT_RESIZE)
+      {
+        applyInputEvents(queue);
+        allocateReplayTarget(target, event.x, event.y);
+        resizeRenderer(renderer, target.width, target.height);
+      }
+      else if (event.type == INPUT_KEY && event.key == 27)
+      {
+        quit = true;
+        break;
+      }
+      else
+      {
+        pushInputEvent(queue, event);
+      }
+    }
+    applyInputEvents(queue);
+    if (quit)
+      break;
+    if (next == log.records.size())
+      ++tailFrames;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    renderScene(renderer, scene);
+    glFinish();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    result.frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    result.commands += renderer.stats.commands;
+    result.drawCalls += renderer.stats.drawCalls;
+    result.culled += renderer.stats.bodiesCulled + renderer.stats.ringsCulled + renderer.stats.orbitsCulled;
+    result.stars += renderer.stats.stars;
+    result.starfieldGpuMs += renderer.stats.starfieldGpuMs;
+    result.bodiesGpuMs += renderer.stats.bodiesGpuMs;
+    hashReplayFrame(target, pixels, checksum);
+
+    if (!scene.simulation.paused)
+      advanceSimulation(scene.simulation, REPLAY_STEP);
+    advanceCameraFlight(scene.flight, REPLAY_STEP);
+  }
+
+  char hash[17];
+  snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)checksum);
+  std::cout << "Replayed " << result.frameMs.size() << " frames, checksum " << hash << std::endl;
+
+  std::vector<BenchmarkResult> results(1, result);
+  bool written = writeBenchmarkReport(reportPath, results, 0, target.width, target.height);
+  destroyHeadlessContext();
+  return written ? 0 : 1;
+};
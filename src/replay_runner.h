@@ -0,0 +1,60 @@
+/**
+ * @file replay_runner.h
+ * @brief Deterministic headless replay of recorded input sessions.
+ *
+ * This file declares the replay mode, which plays an input log recorded
+ * with `--record` without a window: the events are fed back at the times
+ * they were received, on a fixed time step, and every frame is rendered
+ * into an offscreen framebuffer, timed and hashed. Two replays of the same
+ * log on the same driver render identical frames, so logs of sessions that
+ * showed a slowdown serve as regression benchmarks.
+ */
+
+#ifndef REPLAY_RUNNER_H
+#define REPLAY_RUNNER_H
+
+#include "renderer.h"
+#include "scene.h"
+
+/**
+ * @def REPLAY_STEP
+ * @brief Time, in seconds, the replay advances per frame.
+ */
+#define REPLAY_STEP (1.0 / 60.0)
+
+/**
+ * @def REPLAY_TAIL_FRAMES
+ * @brief Number of frames rendered after the last event of the log, so
+ *        that flights and animations it started are measured to the end.
+ */
+#define REPLAY_TAIL_FRAMES 240
+
+/**
+ * @var scene
+ * @brief State of the replayed scene.
+ */
+extern SceneState scene;
+
+/**
+ * @var renderer
+ * @brief Renderer drawing the replayed frames.
+ */
+extern Renderer renderer;
+
+/**
+ * @brief Replays an input log without a window.
+ * @param logPath Path of the input log.
+ * @param reportPath Path of the JSON report written at the end of the replay.
+ * @return The process exit code: 0 if the log was replayed and the report
+ *         written, 1 otherwise.
+ *
+ * The replay creates a headless context for the backend the log was
+ * recorded with, applies the recorded lighting and window size, then
+ * renders one frame every `REPLAY_STEP` seconds of log time until the log
+ * ends or replays the ESC key. The frame times go to a benchmark report
+ * with a single `replay` scene, and a checksum of all the rendered pixels
+ * is printed to compare runs.
+ */
+int runReplay(const char *logPath, const char *reportPath);
+
+#endif // REPLAY_RUNNER_H
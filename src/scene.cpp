@@ -0,0 +1,41 @@
+/**
+ * @file scene.cpp
+ * @brief Implements the scene state.
+ */
+
+#include "scene.h"
+
+/**
+ * @brief Returns the initial scene state.
+ * @return The whole solar system at the scene's scale, orbits hidden,
+ *         animation running, camera at rest.
+ */
+SceneState initialSceneState()
+{
+  SceneState scene;
+  scene.simulation = initialSimulationState();
+  scene.camera = initialCameraState();
+  scene.flight = CameraFlight();
+  scene.showOrbits = false;
+  scene.selectedElement = -1;
+  scene.trueScale = false;
+  return scene;
+};
+
+/**
+ * @brief Tells whether two scene states render the same frame.
+ * @param a The first scene state.
+ * @param b The second scene state.
+ * @return True if the simulation angle, the camera, its flight and the view
+ *         options are equal; the pause state does not change the frame.
+ *
+ * The angles are compared at the single precision the renderer uses, so a
+ * slow time scale does not redraw frames that cannot differ.
+ */
+bool sceneStatesEqual(const SceneState &a, const SceneState &b)
+{
+  return (float)a.simulation.rotationAngle == (float)b.simulation.rotationAngle && a.camera.distance == b.camera.distance &&
+         a.camera.angleX == b.camera.angleX && a.camera.angleY == b.camera.angleY &&
+         a.flight.active == b.flight.active && (!a.flight.active || a.flight.elapsed == b.flight.elapsed) &&
+         a.showOrbits == b.showOrbits && a.selectedElement == b.selectedElement && a.trueScale == b.trueScale;
+};
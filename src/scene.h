@@ -0,0 +1,46 @@
+/**
+ * @file scene.h
+ * @brief Declares the complete state of a rendered scene.
+ *
+ * This file groups the simulation, the camera and the view options into one
+ * object. The application owns a single instance; tools such as benchmarks
+ * can create their own without a window.
+ */
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "camera.h"
+#include "simulation.h"
+
+/**
+ * @struct SceneState
+ * @brief Everything needed to render one frame of the solar system.
+ */
+struct SceneState
+{
+  SimulationState simulation; ///< Animation state of the bodies.
+  CameraState camera;         ///< Camera looking at the scene, or where its flight ends.
+  CameraFlight flight;        ///< Flight of the camera towards the selected body.
+  bool showOrbits;            ///< Whether orbital paths are drawn.
+  int selectedElement;        ///< Index of the selected body, or -1 for the whole system.
+  bool trueScale;             ///< Whether bodies are drawn with their real sizes and distances.
+};
+
+/**
+ * @brief Returns the initial scene state.
+ * @return The whole solar system at the scene's scale, orbits hidden,
+ *         animation running, camera at rest.
+ */
+SceneState initialSceneState();
+
+/**
+ * @brief Tells whether two scene states render the same frame.
+ * @param a The first scene state.
+ * @param b The second scene state.
+ * @return True if the simulation angle, the camera, its flight and the view
+ *         options are equal; the pause state does not change the frame.
+ */
+bool sceneStatesEqual(const SceneState &a, const SceneState &b);
+
+#endif // SCENE_H
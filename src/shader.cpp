@@ -0,0 +1,119 @@
+/**
+ * @file shader.cpp
+ * @brief Implements GLSL shader loading.
+ */
+
+#include "shader.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+/**
+ * @brief Reads a whole text file into a string.
+ * @param filename Path to the file.
+ * @param text The string that receives the contents of the file.
+ * @return True if the file was read successfully.
+ */
+bool readTextFile(const char *filename, std::string &text)
+{
+  std::ifstream file(filename);
+  if (!file)
+    return false;
+
+  std::stringstream contents;
+  contents << file.rdbuf();
+  text = contents.str();
+  return true;
+};
+
+/**
+ * @brief Compiles one shader stage.
+ * @param type The stage, such as `GL_VERTEX_SHADER`.
+ * @param source GLSL source of the stage.
+ * @param name Name used to identify the shader in error messages.
+ * @return The OpenGL shader ID, or 0 on failure.
+ */
+static GLuint compileShader(GLenum type, const char *source, const char *name)
+{
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (compiled)
+    return shader;
+
+  GLint length = 0;
+  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length > 0 ? length : 1, '\0');
+  glGetShaderInfoLog(shader, (GLsizei)log.size(), NULL, &log[0]);
+  std::cerr << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
+            << " shader of " << name << ":\n" << &log[0] << std::endl;
+  glDeleteShader(shader);
+  return 0;
+};
+
+/**
+ * @brief Compiles and links a program from vertex and fragment sources.
+ * @param vertexSource GLSL source of the vertex shader.
+ * @param fragmentSource GLSL source of the fragment shader.
+ * @param name Name used to identify the program in error messages.
+ * @return The OpenGL program ID, or 0 on failure.
+ */
+GLuint buildShaderProgram(const char *vertexSource, const char *fragmentSource, const char *name)
+{
+  GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, name);
+  GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, name);
+  if (!vertexShader || !fragmentShader)
+  {
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return 0;
+  }
+
+  GLuint program = glCreateProgram();
+  glAttachShader(program, vertexShader);
+  glAttachShader(program, fragmentShader);
+  glLinkProgram(program);
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (linked)
+    return program;
+
+  GLint length = 0;
+  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length > 0 ? length : 1, '\0');
+  glGetProgramInfoLog(program, (GLsizei)log.size(), NULL, &log[0]);
+  std::cerr << "Failed to link shader program " << name << ":\n" << &log[0] << std::endl;
+  glDeleteProgram(program);
+  return 0;
+};
+
+/**
+ * @brief Loads, compiles and links a program from two shader files.
+ * @param vertexPath Path to the vertex shader source.
+ * @param fragmentPath Path to the fragment shader source.
+ * @return The OpenGL program ID, or 0 on failure.
+ */
+GLuint loadShaderProgram(const char *vertexPath, const char *fragmentPath)
+{
+  std::string vertexSource;
+  std::string fragmentSource;
+  if (!readTextFile(vertexPath, vertexSource))
+  {
+    std::cerr << "Failed to load shader: " << vertexPath << std::endl;
+    return 0;
+  }
+  if (!readTextFile(fragmentPath, fragmentSource))
+  {
+    std::cerr << "Failed to load shader: " << fragmentPath << std::endl;
+    return 0;
+  }
+  return buildShaderProgram(vertexSource.c_str(), fragmentSource.c_str(), vertexPath);
+};
@@ -0,0 +1,47 @@
+/**
+ * @file shader.h
+ * @brief Provides GLSL shader loading functionality.
+ *
+ * This file declares the functions that read GLSL sources from disk and
+ * compile and link them into OpenGL program objects.
+ */
+
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <string>
+
+#include "opengl.h"
+
+/**
+ * @brief Reads a whole text file into a string.
+ * @param filename Path to the file.
+ * @param text The string that receives the contents of the file.
+ * @return True if the file was read successfully.
+ */
+bool readTextFile(const char *filename, std::string &text);
+
+/**
+ * @brief Compiles and links a program from vertex and fragment sources.
+ * @param vertexSource GLSL source of the vertex shader.
+ * @param fragmentSource GLSL source of the fragment shader.
+ * @param name Name used to identify the program in error messages.
+ * @return The OpenGL program ID, or 0 on failure.
+ *
+ * Compilation and link errors are printed to `std::cerr` together with the
+ * driver's info log.
+ */
+GLuint buildShaderProgram(const char *vertexSource, const char *fragmentSource, const char *name);
+
+/**
+ * @brief Loads, compiles and links a program from two shader files.
+ * @param vertexPath Path to the vertex shader source.
+ * @param fragmentPath Path to the fragment shader source.
+ * @return The OpenGL program ID, or 0 on failure.
+ *
+ * If a file fails to load, an error message is printed to `std::cerr` and
+ * 0 is returned.
+ */
+GLuint loadShaderProgram(const char *vertexPath, const char *fragmentPath);
+
+#endif // SHADER_H
@@ -0,0 +1,48 @@
+/**
+ * @file shaders.h
+ * @brief Defines shader paths for the core-profile renderer.
+ *
+ * This file contains the file paths of the GLSL sources compiled by the
+ * core-profile renderer, relative to the `bin` directory like the textures.
+ */
+
+#ifndef SHADERS_H
+#define SHADERS_H
+
+/**
+ * @def BODY_VERTEX_SHADER
+ * @brief Path to the vertex shader of bodies, rings and orbits.
+ */
+#define BODY_VERTEX_SHADER "../assets/shaders/body.vert"
+
+/**
+ * @def BODY_FRAGMENT_SHADER
+ * @brief Path to the fragment shader of bodies, rings and orbits.
+ */
+#define BODY_FRAGMENT_SHADER "../assets/shaders/body.frag"
+
+/**
+ * @def STAR_VERTEX_SHADER
+ * @brief Path to the vertex shader of the starfield.
+ */
+#define STAR_VERTEX_SHADER "../assets/shaders/star.vert"
+
+/**
+ * @def STAR_FRAGMENT_SHADER
+ * @brief Path to the fragment shader of the starfield.
+ */
+#define STAR_FRAGMENT_SHADER "../assets/shaders/star.frag"
+
+/**
+ * @def COMPOSITE_VERTEX_SHADER
+ * @brief Path to the vertex shader of the full-screen transparency resolve.
+ */
+#define COMPOSITE_VERTEX_SHADER "../assets/shaders/composite.vert"
+
+/**
+ * @def COMPOSITE_FRAGMENT_SHADER
+ * @brief Path to the fragment shader of the full-screen transparency resolve.
+ */
+#define COMPOSITE_FRAGMENT_SHADER "../assets/shaders/composite.frag"
+
+#endif // SHADERS_H
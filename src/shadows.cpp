@@ -0,0 +1,149 @@
+/**
+ * @file shadows.cpp
+ * @brief Implements the occluder lists of the analytic shadows.
+ */
+
+#include "shadows.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Removes every occluder of a receiver.
+ * @param receiver The receiver to clear.
+ */
+void clearShadowReceiver(ShadowReceiver &receiver)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    receiver.ringPlane[i] = 0.0f;
+    receiver.ringCenter[i] = 0.0f;
+  }
+  receiver.sphereCount = 0;
+  receiver.padding[0] = receiver.padding[1] = receiver.padding[2] = 0;
+};
+
+/**
+ * @brief Tells whether a sphere may shadow a body.
+ * @param sun World-space center of the Sun.
+ * @param sunRadius Radius of the Sun.
+ * @param occluder Center of the occluding sphere.
+ * @param occluderRadius Radius of the occluding sphere.
+ * @param receiver Center of the receiving body.
+ * @param receiverRadius Radius of a sphere enclosing the receiving body and
+ *                       its ring.
+ * @return True if the receiver lies farther from the Sun than the occluder
+ *         and intersects its penumbra cone.
+ *
+ * The penumbra is bounded by the lines tangent to both the Sun and the
+ * occluder on opposite sides, so its radius grows by `sunRadius +
+ * occluderRadius` for every distance from the Sun to the occluder travelled
+ * past the occluder.
+ */
+bool castsShadow(const Vec3 &sun, float sunRadius, const Vec3 &occluder, float occluderRadius, const Vec3 &receiver, float receiverRadius)
+{
+  float ax = occluder.x - sun.x;
+  float ay = occluder.y - sun.y;
+  float az = occluder.z - sun.z;
+  float occluderDistance = sqrtf(ax * ax + ay * ay + az * az);
+  if (occluderDistance <= sunRadius + occluderRadius)
+    return false;
+  ax /= occluderDistance;
+  ay /= occluderDistance;
+  az /= occluderDistance;
+
+  float rx = receiver.x - sun.x;
+  float ry = receiver.y - sun.y;
+  float rz = receiver.z - sun.z;
+  float along = rx * ax + ry * ay + rz * az;
+  if (along <= occluderDistance)
+    return false;
+
+  float ox = rx - ax * along;
+  float oy = ry - ay * along;
+  float oz = rz - az * along;
+  float offAxis = sqrtf(ox * ox + oy * oy + oz * oz);
+  float penumbra = occluderRadius + (sunRadius + occluderRadius) * (along - occluderDistance) / occluderDistance;
+  return offAxis < penumbra + receiverRadius;
+};
+
+/**
+ * @brief Adds an occluding sphere to a receiver.
+ * @param receiver The receiver.
+ * @param center World-space center of the sphere.
+ * @param radius Radius of the sphere.
+ * @return False if the receiver is full.
+ */
+bool addShadowSphere(ShadowReceiver &receiver, const Vec3 &center, float radius)
+{
+  if (receiver.sphereCount >= SHADOW_MAX_OCCLUDERS)
+    return false;
+
+  float *sphere = receiver.spheres[receiver.sphereCount++];
+  sphere[0] = center.x;
+  sphere[1] = center.y;
+  sphere[2] = center.z;
+  sphere[3] = radius;
+  return true;
+};
+
+/**
+ * @brief Sets the ring whose plane shadows a receiver.
+ * @param receiver The receiver.
+ * @param center World-space center of the ring.
+ * @param normal Unit normal of the ring plane.
+ * @param innerRadius Inner radius of the ring.
+ * @param outerRadius Outer radius of the ring.
+ */
+void setShadowRing(ShadowReceiver &receiver, const Vec3 &center, const Vec3 &normal, float innerRadius, float outerRadius)
+{
+  receiver.ringPlane[0] = normal.x;
+  receiver.ringPlane[1] = normal.y;
+  receiver.ringPlane[2] = normal.z;
+  receiver.ringPlane[3] = innerRadius;
+  receiver.ringCenter[0] = center.x;
+  receiver.ringCenter[1] = center.y;
+  receiver.ringCenter[2] = center.z;
+  receiver.ringCenter[3] = outerRadius;
+};
+
+/**
+ * @brief Returns the fraction of the Sun visible from a point past a sphere.
+ * @param point The shadowed point.
+ * @param sun Center of the Sun.
+ * @param sunRadius Radius of the Sun.
+ * @param occluder Center of the occluding sphere.
+ * @param occluderRadius Radius of the occluding sphere.
+ * @return 1 in full light, 0 in the umbra, in between in the penumbra.
+ *
+ * Both disks are measured by their angular radii and the angle between
+ * their centers, and their overlap is the area of two circular segments.
+ */
+float sphereSunVisibility(const Vec3 &point, const Vec3 &sun, float sunRadius, const Vec3 &occluder, float occluderRadius)
+{
+  float sx = sun.x - point.x;
+  float sy = sun.y - point.y;
+  float sz = sun.z - point.z;
+  float sunDistance = sqrtf(sx * sx + sy * sy + sz * sz);
+  float ox = occluder.x - point.x;
+  float oy = occluder.y - point.y;
+  float oz = occluder.z - point.z;
+  float occluderDistance = sqrtf(ox * ox + oy * oy + oz * oz);
+  float facing = sx * ox + sy * oy + sz * oz;
+  if (facing <= 0.0f || occluderDistance >= sunDistance || occluderDistance <= occluderRadius)
+    return 1.0f;
+
+  float a = asinf(std::min(sunRadius / sunDistance, 1.0f));
+  float b = asinf(occluderRadius / occluderDistance);
+  float c = acosf(std::min(facing / (sunDistance * occluderDistance), 1.0f));
+  if (c >= a + b)
+    return 1.0f;
+  if (c <= fabsf(a - b))
+    return b >= a ? 0.0f : 1.0f - (b * b) / (a * a);
+
+  float alpha = acosf(std::max(std::min((c * c + a * a - b * b) / (2.0f * c * a), 1.0f), -1.0f));
+  float beta = acosf(std::max(std::min((c * c + b * b - a * a) / (2.0f * c * b), 1.0f), -1.0f));
+  float kite = (-c + a + b) * (c + a - b) * (c - a + b) * (c + a + b);
+  float overlap = a * a * alpha + b * b * beta - 0.5f * sqrtf(std::max(kite, 0.0f));
+  return std::max(1.0f - overlap / (3.14159265358979f * a * a), 0.0f);
+};
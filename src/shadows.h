@@ -0,0 +1,94 @@
+/**
+ * @file shadows.h
+ * @brief Declares the occluder lists of the analytic shadows.
+ *
+ * Shadows are not rendered into shadow maps. Every frame, each lit body
+ * receives a short list of the spheres that may hide part of the Sun from
+ * it, and ringed bodies receive the plane of their ring; the fragment shader
+ * then computes, for every pixel, how much of the Sun's disk these occluders
+ * cover. The cost of a pixel depends on the occluders near its body, not on
+ * the size of the scene, and penumbrae come out soft since the Sun is a disk
+ * rather than a point.
+ */
+
+#ifndef SHADOWS_H
+#define SHADOWS_H
+
+#include "transform.h"
+
+/**
+ * @def SHADOW_MAX_OCCLUDERS
+ * @brief Maximum number of spheres shadowing one body.
+ */
+#define SHADOW_MAX_OCCLUDERS 4
+
+/**
+ * @struct ShadowReceiver
+ * @brief Occluders of one body, laid out as an element of the `Shadows`
+ *        uniform block in std140 layout.
+ */
+struct ShadowReceiver
+{
+  float spheres[SHADOW_MAX_OCCLUDERS][4]; ///< World-space center and radius of every occluding sphere.
+  float ringPlane[4];                     ///< Unit normal of the body's ring plane and its inner radius; all 0 without a ring.
+  float ringCenter[4];                    ///< World-space center of the ring and its outer radius.
+  int sphereCount;                        ///< Number of occluding spheres.
+  int padding[3];                         ///< Pads the element to a multiple of 16 bytes.
+};
+
+/**
+ * @brief Removes every occluder of a receiver.
+ * @param receiver The receiver to clear.
+ */
+void clearShadowReceiver(ShadowReceiver &receiver);
+
+/**
+ * @brief Tells whether a sphere may shadow a body.
+ * @param sun World-space center of the Sun.
+ * @param sunRadius Radius of the Sun.
+ * @param occluder Center of the occluding sphere.
+ * @param occluderRadius Radius of the occluding sphere.
+ * @param receiver Center of the receiving body.
+ * @param receiverRadius Radius of a sphere enclosing the receiving body and
+ *                       its ring.
+ * @return True if the receiver lies farther from the Sun than the occluder
+ *         and intersects its penumbra cone.
+ */
+bool castsShadow(const Vec3 &sun, float sunRadius, const Vec3 &occluder, float occluderRadius, const Vec3 &receiver, float receiverRadius);
+
+/**
+ * @brief Adds an occluding sphere to a receiver.
+ * @param receiver The receiver.
+ * @param center World-space center of the sphere.
+ * @param radius Radius of the sphere.
+ * @return False if the receiver already has `SHADOW_MAX_OCCLUDERS` spheres,
+ *         in which case the sphere is dropped.
+ */
+bool addShadowSphere(ShadowReceiver &receiver, const Vec3 &center, float radius);
+
+/**
+ * @brief Sets the ring whose plane shadows a receiver.
+ * @param receiver The receiver.
+ * @param center World-space center of the ring.
+ * @param normal Unit normal of the ring plane.
+ * @param innerRadius Inner radius of the ring.
+ * @param outerRadius Outer radius of the ring.
+ */
+void setShadowRing(ShadowReceiver &receiver, const Vec3 &center, const Vec3 &normal, float innerRadius, float outerRadius);
+
+/**
+ * @brief Returns the fraction of the Sun visible from a point past a sphere.
+ * @param point The shadowed point.
+ * @param sun Center of the Sun.
+ * @param sunRadius Radius of the Sun.
+ * @param occluder Center of the occluding sphere.
+ * @param occluderRadius Radius of the occluding sphere.
+ * @return 1 in full light, 0 in the umbra, in between in the penumbra.
+ *
+ * This is the reference of the test run per pixel by the core fragment
+ * shader: the Sun and the occluder are treated as disks of their apparent
+ * sizes, and the overlap of the two disks is subtracted from the Sun's.
+ */
+float sphereSunVisibility(const Vec3 &point, const Vec3 &sun, float sunRadius, const Vec3 &occluder, float occluderRadius);
+
+#endif // SHADOWS_H
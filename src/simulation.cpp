@@ -0,0 +1,68 @@
+/**
+ * @file simulation.cpp
+ * @brief Implements the solar system simulation state.
+ */
+
+#include "simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "planet_speeds.h"
+
+/**
+ * @brief Returns the initial simulation state.
+ * @return A running simulation at angle 0 and the default time scale.
+ */
+SimulationState initialSimulationState()
+{
+  SimulationState simulation;
+  simulation.rotationAngle = 0.0;
+  simulation.timeScale = SIMULATION_DEFAULT_SCALE;
+  simulation.reversed = false;
+  simulation.paused = false;
+  return simulation;
+};
+
+/**
+ * @brief Advances the simulation by an amount of real time.
+ * @param simulation The simulation to advance.
+ * @param seconds Real time elapsed since the last advance, in seconds.
+ * @return The real time actually simulated, at most `SIMULATION_MAX_ADVANCE_SECONDS`.
+ */
+double advanceSimulation(SimulationState &simulation, double seconds)
+{
+  if (simulation.paused || seconds <= 0.0)
+    return 0.0;
+
+  seconds = std::min(seconds, SIMULATION_MAX_ADVANCE_SECONDS);
+  double degreesPerSecond = 360.0 / EARTH_SPEED / SIMULATION_YEAR_SECONDS;
+  double angle = seconds * simulation.timeScale * degreesPerSecond;
+  if (simulation.reversed)
+    angle = -angle;
+
+  simulation.rotationAngle = fmod(simulation.rotationAngle + angle, SIMULATION_PERIOD);
+  if (simulation.rotationAngle < 0.0)
+    simulation.rotationAngle += SIMULATION_PERIOD;
+  return seconds;
+};
+
+/**
+ * @brief Changes the time scale by a number of steps.
+ * @param simulation The simulation.
+ * @param steps Number of steps of the 1-2-5 sequence to go up, or down if negative.
+ */
+void warpSimulation(SimulationState &simulation, int steps)
+{
+  static const double mantissas[] = {1.0, 2.0, 5.0};
+
+  // Finds the step of the sequence closest to the current scale.
+  double decade = floor(log10(simulation.timeScale) + 1e-9);
+  double mantissa = simulation.timeScale / pow(10.0, decade);
+  int step = (int)decade * 3 + (mantissa < 1.5 ? 0 : mantissa < 3.5 ? 1 : 2) + steps;
+
+  int firstStep = (int)floor(log10(SIMULATION_MIN_SCALE) + 1e-9) * 3;
+  int lastStep = (int)floor(log10(SIMULATION_MAX_SCALE) + 1e-9) * 3;
+  step = std::max(firstStep, std::min(step, lastStep));
+  simulation.timeScale = mantissas[step % 3] * pow(10.0, step / 3);
+};
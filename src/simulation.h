@@ -0,0 +1,110 @@
+/**
+ * @file simulation.h
+ * @brief Declares the state of the solar system simulation.
+ *
+ * This file declares the state that drives the animation of the celestial
+ * bodies and the functions that advance it and control its speed.
+ *
+ * The bodies follow closed-form circular orbits, so the simulation is a
+ * single angle from which every position is computed, and advancing it by
+ * any amount costs the same. Time warp is therefore a matter of mapping
+ * real time to that angle: the time scale is relative to real time, one
+ * orbit of the Earth lasting a year at 1x, and the real time consumed by
+ * one advance is bounded so that a late frame slows the simulation down
+ * instead of making it jump.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+/**
+ * @def SIMULATION_STEP
+ * @brief Angle, in degrees, added to the simulation angle on every frame of
+ *        the benchmark, which does not depend on real time.
+ */
+#define SIMULATION_STEP 0.5f
+
+/**
+ * @def SIMULATION_PERIOD
+ * @brief Simulation angle after which every body is back where it started.
+ *
+ * Orbital speeds are multiples of 0.1, so every body completes a whole
+ * number of turns in 3600 degrees. The angle is kept within this period so
+ * that single-precision positions stay exact at any time scale.
+ */
+#define SIMULATION_PERIOD 3600.0
+
+/**
+ * @def SIMULATION_YEAR_SECONDS
+ * @brief Length of one orbit of the Earth at 1x, in seconds (a Julian year).
+ */
+#define SIMULATION_YEAR_SECONDS 31557600.0
+
+/**
+ * @def SIMULATION_MIN_SCALE
+ * @brief Slowest time scale, real time.
+ */
+#define SIMULATION_MIN_SCALE 1.0
+
+/**
+ * @def SIMULATION_MAX_SCALE
+ * @brief Fastest time scale, about one orbit of the Earth every 3 seconds.
+ */
+#define SIMULATION_MAX_SCALE 1e7
+
+/**
+ * @def SIMULATION_DEFAULT_SCALE
+ * @brief Time scale the simulation starts at, one orbit of the Earth every 6 seconds.
+ */
+#define SIMULATION_DEFAULT_SCALE 5e6
+
+/**
+ * @def SIMULATION_MAX_ADVANCE_SECONDS
+ * @brief Largest amount of real time, in seconds, one advance simulates.
+ *
+ * Longer gaps between two advances, such as slow frames or a stalled
+ * window, are cut to this budget: the simulation then runs slower than its
+ * time scale rather than falling behind and catching up in one jump.
+ */
+#define SIMULATION_MAX_ADVANCE_SECONDS 0.1
+
+/**
+ * @struct SimulationState
+ * @brief Animation state of the celestial bodies.
+ */
+struct SimulationState
+{
+  double rotationAngle; ///< Current simulation angle, in degrees, within `SIMULATION_PERIOD`.
+  double timeScale;     ///< Speed relative to real time, from `SIMULATION_MIN_SCALE` to `SIMULATION_MAX_SCALE`.
+  bool reversed;        ///< Whether time runs backwards.
+  bool paused;          ///< Whether the animation is paused.
+};
+
+/**
+ * @brief Returns the initial simulation state.
+ * @return A running simulation at angle 0 and the default time scale.
+ */
+SimulationState initialSimulationState();
+
+/**
+ * @brief Advances the simulation by an amount of real time.
+ * @param simulation The simulation to advance.
+ * @param seconds Real time elapsed since the last advance, in seconds.
+ * @return The real time actually simulated, at most `SIMULATION_MAX_ADVANCE_SECONDS`.
+ *
+ * The simulation angle moves by `seconds` times the time scale, backwards
+ * if the simulation is reversed, and does not move while it is paused.
+ */
+double advanceSimulation(SimulationState &simulation, double seconds);
+
+/**
+ * @brief Changes the time scale by a number of steps.
+ * @param simulation The simulation.
+ * @param steps Number of steps of the 1-2-5 sequence (1x, 2x, 5x, 10x...)
+ *              to go up, or down if negative.
+ *
+ * The scale is clamped to `SIMULATION_MIN_SCALE` and `SIMULATION_MAX_SCALE`.
+ */
+void warpSimulation(SimulationState &simulation, int steps);
+
+#endif // SIMULATION_H
@@ -0,0 +1,258 @@
+/**
+ * @file snapshot.cpp
+ * @brief Implements scene snapshots and snapshot files.
+ */
+
+#include "snapshot.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "bodies.h"
+#include "mapped_file.h"
+
+/**
+ * @var SNAPSHOT_MAGIC
+ * @brief First bytes of every snapshot file.
+ */
+static const char SNAPSHOT_MAGIC[4] = {'S', 'S', 'N', 'P'};
+
+/**
+ * @var SNAPSHOT_HEADER_SIZE
+ * @brief Size of the magic and header words, which keeps the records 8-byte aligned.
+ */
+static const size_t SNAPSHOT_HEADER_SIZE = 16;
+
+/**
+ * @var SNAPSHOT_WORDS
+ * @brief Number of 8-byte words in a snapshot, one bit each in a delta mask.
+ */
+static const size_t SNAPSHOT_WORDS = sizeof(SceneSnapshot) / sizeof(uint64_t);
+
+/**
+ * @brief Saves the state of a scene.
+ * @param scene The scene.
+ * @return The snapshot of its state.
+ */
+SceneSnapshot captureSceneSnapshot(const SceneState &scene)
+{
+  SceneSnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.rotationAngle = scene.simulation.rotationAngle;
+  snapshot.timeScale = scene.simulation.timeScale;
+  snapshot.flightOffset[0] = scene.flight.fromOffset.x;
+  snapshot.flightOffset[1] = scene.flight.fromOffset.y;
+  snapshot.flightOffset[2] = scene.flight.fromOffset.z;
+  snapshot.flightSeparation = scene.flight.separation;
+  snapshot.flightStartWidth = scene.flight.startWidth;
+  snapshot.flightEndWidth = scene.flight.endWidth;
+  snapshot.flightPathStart = scene.flight.pathStart;
+  snapshot.flightPathLength = scene.flight.pathLength;
+  snapshot.cameraDistance = scene.camera.distance;
+  snapshot.cameraAngleX = scene.camera.angleX;
+  snapshot.cameraAngleY = scene.camera.angleY;
+  snapshot.flightElapsed = scene.flight.elapsed;
+  snapshot.flightDuration = scene.flight.duration;
+  snapshot.flightFromDistance = scene.flight.fromDistance;
+  snapshot.flightToDistance = scene.flight.toDistance;
+  snapshot.flightAngleX = scene.flight.angleX;
+  snapshot.flightAngleY = scene.flight.angleY;
+  snapshot.selectedElement = scene.selectedElement;
+  snapshot.flightFromBody = scene.flight.fromBody;
+  snapshot.reversed = scene.simulation.reversed;
+  snapshot.paused = scene.simulation.paused;
+  snapshot.showOrbits = scene.showOrbits;
+  snapshot.trueScale = scene.trueScale;
+  snapshot.flightActive = scene.flight.active;
+  return snapshot;
+};
+
+/**
+ * @brief Restores a saved state into a scene.
+ * @param snapshot The snapshot.
+ * @param scene The scene.
+ */
+void restoreSceneSnapshot(const SceneSnapshot &snapshot, SceneState &scene)
+{
+  scene.simulation.rotationAngle = snapshot.rotationAngle;
+  scene.simulation.timeScale = snapshot.timeScale;
+  scene.simulation.reversed = snapshot.reversed != 0;
+  scene.simulation.paused = snapshot.paused != 0;
+  scene.camera.distance = snapshot.cameraDistance;
+  scene.camera.angleX = snapshot.cameraAngleX;
+  scene.camera.angleY = snapshot.cameraAngleY;
+  scene.flight.active = snapshot.flightActive != 0;
+  scene.flight.elapsed = snapshot.flightElapsed;
+  scene.flight.duration = snapshot.flightDuration;
+  scene.flight.fromBody = snapshot.flightFromBody;
+  scene.flight.fromOffset.x = snapshot.flightOffset[0];
+  scene.flight.fromOffset.y = snapshot.flightOffset[1];
+  scene.flight.fromOffset.z = snapshot.flightOffset[2];
+  scene.flight.fromDistance = snapshot.flightFromDistance;
+  scene.flight.toDistance = snapshot.flightToDistance;
+  scene.flight.angleX = snapshot.flightAngleX;
+  scene.flight.angleY = snapshot.flightAngleY;
+  scene.flight.separation = snapshot.flightSeparation;
+  scene.flight.startWidth = snapshot.flightStartWidth;
+  scene.flight.endWidth = snapshot.flightEndWidth;
+  scene.flight.pathStart = snapshot.flightPathStart;
+  scene.flight.pathLength = snapshot.flightPathLength;
+  scene.showOrbits = snapshot.showOrbits != 0;
+  scene.selectedElement = snapshot.selectedElement;
+  scene.trueScale = snapshot.trueScale != 0;
+};
+
+/**
+ * @brief Writes a snapshot file holding a single state.
+ * @param filename Path to the file, replaced if it exists.
+ * @param snapshot The state.
+ * @return True if the file was written successfully.
+ *
+ * The header and the record are assembled in memory and written at once.
+ */
+bool writeSnapshotFile(const char *filename, const SceneSnapshot &snapshot)
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  char buffer[SNAPSHOT_HEADER_SIZE + sizeof(SceneSnapshot)];
+  uint32_t header[3] = {SNAPSHOT_VERSION, (uint32_t)sizeof(SceneSnapshot), 0};
+  memcpy(buffer, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  memcpy(buffer + sizeof(SNAPSHOT_MAGIC), header, sizeof(header));
+  memcpy(buffer + SNAPSHOT_HEADER_SIZE, &snapshot, sizeof(snapshot));
+  file.write(buffer, sizeof(buffer));
+  return (bool)file;
+};
+
+/**
+ * @brief Appends a state to a snapshot file as a delta.
+ * @param filename Path to an existing snapshot file.
+ * @param previous The last state of the file.
+ * @param snapshot The state to append.
+ * @return True if the delta was appended successfully.
+ *
+ * Only the words that differ from @p previous are written, after their
+ * mask, in one write at the end of the file.
+ */
+bool appendSnapshotDelta(const char *filename, const SceneSnapshot &previous, const SceneSnapshot &snapshot)
+{
+  std::ofstream file(filename, std::ios::binary | std::ios::app);
+  if (!file)
+    return false;
+
+  uint64_t from[SNAPSHOT_WORDS];
+  uint64_t to[SNAPSHOT_WORDS];
+  memcpy(from, &previous, sizeof(from));
+  memcpy(to, &snapshot, sizeof(to));
+
+  uint32_t block[2 + 2 * SNAPSHOT_WORDS] = {0, 0};
+  size_t changed = 0;
+  for (size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+  {
+    if (from[i] == to[i])
+      continue;
+    block[0] |= 1u << i;
+    memcpy(&block[2 + 2 * changed++], &to[i], sizeof(uint64_t));
+  }
+  file.write((const char *)block, (std::streamsize)(sizeof(uint64_t) * (1 + changed)));
+  return (bool)file;
+};
+
+/**
+ * @brief Checks that a saved state can be restored.
+ * @param snapshot The state.
+ * @return True if its body indices are in range and its simulation speed and
+ *         camera are finite and within their limits.
+ *
+ * The body indices are used unchecked by the renderer, and the time scale
+ * feeds the logarithm of `warpSimulation`, so a corrupt or hand-edited file
+ * must not reach the scene.
+ */
+static bool checkSceneSnapshot(const SceneSnapshot &snapshot)
+{
+  return snapshot.selectedElement >= -1 && snapshot.selectedElement < BODY_COUNT && snapshot.flightFromBody >= 0 &&
+         snapshot.flightFromBody < BODY_COUNT && std::isfinite(snapshot.timeScale) &&
+         snapshot.timeScale >= SIMULATION_MIN_SCALE && snapshot.timeScale <= SIMULATION_MAX_SCALE &&
+         std::isfinite(snapshot.rotationAngle) && std::isfinite(snapshot.cameraDistance) &&
+         std::isfinite(snapshot.cameraAngleX) && std::isfinite(snapshot.cameraAngleY);
+};
+
+/**
+ * @brief Expands the contents of a snapshot file.
+ * @param bytes The contents of the file.
+ * @param size Size of the contents, in bytes.
+ * @param snapshots Receives the states.
+ * @return True if the header is valid and the contents hold whole records,
+ *         each passing `checkSceneSnapshot`.
+ */
+static bool parseSnapshotFile(const char *bytes, size_t size, std::vector<SceneSnapshot> &snapshots)
+{
+  snapshots.clear();
+  if (size < SNAPSHOT_HEADER_SIZE + sizeof(SceneSnapshot))
+    return false;
+  uint32_t header[3];
+  memcpy(header, bytes + sizeof(SNAPSHOT_MAGIC), sizeof(header));
+  if (memcmp(bytes, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header[0] != SNAPSHOT_VERSION ||
+      header[1] != sizeof(SceneSnapshot))
+    return false;
+
+  uint64_t words[SNAPSHOT_WORDS];
+  memcpy(words, bytes + SNAPSHOT_HEADER_SIZE, sizeof(words));
+  snapshots.resize(1);
+  memcpy(&snapshots[0], words, sizeof(words));
+  if (!checkSceneSnapshot(snapshots[0]))
+    return false;
+
+  size_t offset = SNAPSHOT_HEADER_SIZE + sizeof(SceneSnapshot);
+  while (offset < size)
+  {
+    uint32_t mask;
+    if (size - offset < sizeof(uint64_t))
+      return false;
+    memcpy(&mask, bytes + offset, sizeof(mask));
+    offset += sizeof(uint64_t);
+    if (mask >> SNAPSHOT_WORDS)
+      return false;
+    for (size_t i = 0; i < SNAPSHOT_WORDS; ++i)
+    {
+      if (!(mask & (1u << i)))
+        continue;
+      if (size - offset < sizeof(uint64_t))
+        return false;
+      memcpy(&words[i], bytes + offset, sizeof(uint64_t));
+      offset += sizeof(uint64_t);
+    }
+    snapshots.resize(snapshots.size() + 1);
+    memcpy(&snapshots.back(), words, sizeof(words));
+    if (!checkSceneSnapshot(snapshots.back()))
+      return false;
+  }
+  return true;
+};
+
+/**
+ * @brief Reads every state of a snapshot file.
+ * @param filename Path to the file.
+ * @param snapshots Receives the states, in the order they were saved.
+ * @return True if the file exists, has the current version and holds whole records.
+ *
+ * The file is opened with `openMappedFile` and the deltas are expanded
+ * straight from its contents, so that no copy of the file is made where it
+ * can be mapped. On failure @p snapshots is left empty.
+ */
+bool readSnapshotFile(const char *filename, std::vector<SceneSnapshot> &snapshots)
+{
+  MappedFile file;
+  if (!openMappedFile(filename, file))
+  {
+    snapshots.clear();
+    return false;
+  }
+  bool valid = parseSnapshotFile(file.data, file.size, snapshots);
+  closeMappedFile(file);
+  if (!valid)
+    snapshots.clear();
+  return valid;
+};
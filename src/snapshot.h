@@ -0,0 +1,112 @@
+/**
+ * @file snapshot.h
+ * @brief Declares scene snapshots, saved states of the simulation and the camera.
+ *
+ * A snapshot holds everything that `SceneState` needs to continue from
+ * where it was saved: the simulation angle, time scale and direction, the
+ * camera and its flight, the selection and the view options. Snapshots
+ * are fixed 136-byte records, so a whole state is restored with one copy.
+ *
+ * A snapshot file keeps a sequence of states, such as bookmarks taken
+ * during a long run. It starts with the 4-byte magic `SSNP`, followed by
+ * the version, the record size and a reserved word as 32-bit unsigned
+ * integers in little-endian order, and the first state as a full record.
+ * Every following state is a delta against the previous one: a 32-bit mask
+ * of the record's 8-byte words that changed, a reserved word, and the
+ * changed words. A bookmark taken while only the simulation advanced thus
+ * costs 16 bytes. Saving writes the file, or appends a delta to it, with a
+ * single write; loading maps the file and expands the deltas.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "scene.h"
+
+/**
+ * @def SNAPSHOT_VERSION
+ * @brief Version of the snapshot file format written by `writeSnapshotFile`.
+ */
+#define SNAPSHOT_VERSION 1
+
+/**
+ * @struct SceneSnapshot
+ * @brief Saved scene state, in its file layout.
+ *
+ * Fields are ordered by size so that the record has no implicit padding;
+ * the unused bytes are always 0, so equal states have equal records.
+ */
+struct SceneSnapshot
+{
+  double rotationAngle;     ///< Simulation angle, in degrees.
+  double timeScale;         ///< Simulation speed relative to real time.
+  double flightOffset[3];   ///< Start point of the flight relative to its body, in world units.
+  double flightSeparation;  ///< Distance from the start point to the flight's target, in world units.
+  double flightStartWidth;  ///< Camera distance at the start of the flight, in world units.
+  double flightEndWidth;    ///< Camera distance at the end of the flight, in world units.
+  double flightPathStart;   ///< Parameter of the flight's path at its start.
+  double flightPathLength;  ///< Length of the flight's path.
+  float cameraDistance;     ///< Distance of the camera from the target.
+  float cameraAngleX;       ///< Horizontal angle of the camera, in radians.
+  float cameraAngleY;       ///< Vertical angle of the camera, in radians.
+  float flightElapsed;      ///< Time since the flight started, in seconds.
+  float flightDuration;     ///< Time the flight lasts, in seconds.
+  float flightFromDistance; ///< Camera distance at the start of the flight, in render units.
+  float flightToDistance;   ///< Camera distance the flight was planned to end at, in render units.
+  float flightAngleX;       ///< Horizontal angle the flight turns, in radians.
+  float flightAngleY;       ///< Vertical angle the flight turns, in radians.
+  int32_t selectedElement;  ///< Selected body, or -1 for the whole system.
+  int32_t flightFromBody;   ///< Body the flight's start point moves with.
+  uint8_t reversed;         ///< Whether time runs backwards.
+  uint8_t paused;           ///< Whether the simulation is paused.
+  uint8_t showOrbits;       ///< Whether orbital paths are drawn.
+  uint8_t trueScale;        ///< Whether the true-scale mode is on.
+  uint8_t flightActive;     ///< Whether the camera is flying.
+  uint8_t unused[7];        ///< Padding to a whole number of 8-byte words, always 0.
+};
+
+/**
+ * @brief Saves the state of a scene.
+ * @param scene The scene.
+ * @return The snapshot of its state.
+ */
+SceneSnapshot captureSceneSnapshot(const SceneState &scene);
+
+/**
+ * @brief Restores a saved state into a scene.
+ * @param snapshot The snapshot.
+ * @param scene The scene, which continues from the saved state.
+ */
+void restoreSceneSnapshot(const SceneSnapshot &snapshot, SceneState &scene);
+
+/**
+ * @brief Writes a snapshot file holding a single state.
+ * @param filename Path to the file, replaced if it exists.
+ * @param snapshot The state.
+ * @return True if the file was written successfully.
+ */
+bool writeSnapshotFile(const char *filename, const SceneSnapshot &snapshot);
+
+/**
+ * @brief Appends a state to a snapshot file as a delta.
+ * @param filename Path to an existing snapshot file.
+ * @param previous The last state of the file.
+ * @param snapshot The state to append.
+ * @return True if the delta was appended successfully.
+ */
+bool appendSnapshotDelta(const char *filename, const SceneSnapshot &previous, const SceneSnapshot &snapshot);
+
+/**
+ * @brief Reads every state of a snapshot file.
+ * @param filename Path to the file.
+ * @param snapshots Receives the states, in the order they were saved.
+ * @return True if the file exists, has the current version and holds
+ *         whole records; a truncated last delta, or a state with a body
+ *         index or a camera or speed out of range, is rejected.
+ */
+bool readSnapshotFile(const char *filename, std::vector<SceneSnapshot> &snapshots);
+
+#endif // SNAPSHOT_H
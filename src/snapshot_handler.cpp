@@ -0,0 +1,119 @@
+/**
+ * @file snapshot_handler.cpp
+ * @brief Implements the bookmarks and the resumption of scene states.
+ */
+
+#include "snapshot_handler.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @var snapshotPath
+ * @brief Path of the open snapshot file, or empty if bookmarks are only kept in memory.
+ */
+static std::string snapshotPath;
+
+/**
+ * @var snapshots
+ * @brief Bookmarked states, in the order they were saved; the file's states first.
+ */
+static std::vector<SceneSnapshot> snapshots;
+
+/**
+ * @var snapshotIndex
+ * @brief Index of the bookmark restored last, or of the last one saved.
+ */
+static size_t snapshotIndex = 0;
+
+/**
+ * @brief Appends a state to the bookmarks and to the open snapshot file.
+ * @param snapshot The state.
+ * @return True unless the snapshot file could not be written.
+ *
+ * The first state of a file is written in full, the following ones as
+ * deltas against the last state.
+ */
+static bool appendSnapshot(const SceneSnapshot &snapshot)
+{
+  bool written = true;
+  if (!snapshotPath.empty())
+  {
+    if (snapshots.empty())
+      written = writeSnapshotFile(snapshotPath.c_str(), snapshot);
+    else
+      written = appendSnapshotDelta(snapshotPath.c_str(), snapshots.back(), snapshot);
+  }
+  if (!written)
+    std::cerr << "Failed to write snapshot file: " << snapshotPath << std::endl;
+
+  snapshots.push_back(snapshot);
+  snapshotIndex = snapshots.size() - 1;
+  return written;
+};
+
+/**
+ * @brief Appends the state at exit to the open snapshot file.
+ *
+ * This function is registered with `atexit`, since the application leaves
+ * its main loop through `exit`.
+ */
+static void saveSnapshotAtExit()
+{
+  if (appendSnapshot(captureSceneSnapshot(scene)))
+    std::cout << "Snapshot " << snapshots.size() << " saved to " << snapshotPath << std::endl;
+};
+
+/**
+ * @brief Opens a snapshot file and resumes from its last state.
+ * @param path Path of the snapshot file.
+ *
+ * A file that exists but cannot be read is left untouched: the bookmarks
+ * are then only kept in memory, since writing the first one would
+ * overwrite it.
+ */
+void openSnapshotFile(const char *path)
+{
+  if (readSnapshotFile(path, snapshots))
+  {
+    snapshotIndex = snapshots.size() - 1;
+    restoreSceneSnapshot(snapshots.back(), scene);
+    std::cout << "Resumed snapshot " << snapshots.size() << " of " << path << std::endl;
+  }
+  else
+  {
+    snapshots.clear();
+    if (std::ifstream(path, std::ios::binary).is_open())
+    {
+      std::cerr << "Failed to read snapshot file, bookmarks will not be saved: " << path << std::endl;
+      return;
+    }
+  }
+  snapshotPath = path;
+  atexit(saveSnapshotAtExit);
+};
+
+/**
+ * @brief Bookmarks the current state of the scene.
+ */
+void saveSnapshot()
+{
+  appendSnapshot(captureSceneSnapshot(scene));
+  std::cout << "Bookmark " << snapshots.size() << " saved" << std::endl;
+};
+
+/**
+ * @brief Restores the next bookmark, cycling back to the first one.
+ */
+void restoreNextSnapshot()
+{
+  if (snapshots.empty())
+    return;
+
+  snapshotIndex = (snapshotIndex + 1) % snapshots.size();
+  restoreSceneSnapshot(snapshots[snapshotIndex], scene);
+  std::cout << "Bookmark " << snapshotIndex + 1 << " of " << snapshots.size() << " restored" << std::endl;
+};
@@ -0,0 +1,48 @@
+/**
+ * @file snapshot_handler.h
+ * @brief Bookmarks and resumes scene states through a snapshot file.
+ *
+ * This file declares the front end of scene snapshots. Bookmarks are kept
+ * in memory and, when a snapshot file was given with `--snapshot`,
+ * appended to it as deltas as they are taken. Opening the file restores its
+ * last state and the state at exit is appended, so a long run resumes where
+ * it stopped. No GLUT function is called, so bookmark keys replay like the
+ * others.
+ */
+
+#ifndef SNAPSHOT_HANDLER_H
+#define SNAPSHOT_HANDLER_H
+
+#include "scene.h"
+#include "snapshot.h"
+
+/**
+ * @var scene
+ * @brief State of the displayed scene, saved and restored by snapshots.
+ */
+extern SceneState scene;
+
+/**
+ * @brief Opens a snapshot file and resumes from its last state.
+ * @param path Path of the snapshot file, created at the first bookmark if it
+ *             does not exist.
+ *
+ * The states of the file become the bookmarks, and the current state is
+ * appended to it when the application exits. A file that exists but cannot
+ * be read is reported and never written.
+ */
+void openSnapshotFile(const char *path);
+
+/**
+ * @brief Bookmarks the current state of the scene.
+ *
+ * The state is appended to the snapshot file, if one is open.
+ */
+void saveSnapshot();
+
+/**
+ * @brief Restores the next bookmark, cycling back to the first one.
+ */
+void restoreNextSnapshot();
+
+#endif // SNAPSHOT_HANDLER_H
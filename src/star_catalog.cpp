@@ -0,0 +1,539 @@
+/**
+ * @file star_catalog.cpp
+ * @brief Implements star catalogs.
+ */
+
+#include "star_catalog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <stdint.h>
+
+/**
+ * @var STAR_CATALOG_MAGIC
+ * @brief First bytes of every catalog file.
+ */
+static const char STAR_CATALOG_MAGIC[4] = {'S', 'S', 'T', 'C'};
+
+/**
+ * @var STAR_CATALOG_HEADER_SIZE
+ * @brief Size of the magic and header words, which keeps the records 16-byte aligned.
+ */
+static const size_t STAR_CATALOG_HEADER_SIZE = 16;
+
+/**
+ * @var OBLIQUITY
+ * @brief Obliquity of the ecliptic at J2000, in radians.
+ */
+static const double OBLIQUITY = 23.4392911 * 3.14159265358979 / 180.0;
+
+/**
+ * @var GALACTIC_TO_EQUATORIAL
+ * @brief Rotation from J2000 galactic to equatorial coordinates, row-major.
+ */
+static const double GALACTIC_TO_EQUATORIAL[3][3] = {
+    {-0.0548755604, 0.4941094279, -0.8676661490},
+    {-0.8734370902, -0.4448296300, -0.1980763734},
+    {-0.4838350155, 0.7469822445, 0.4559837762}};
+
+/**
+ * @brief Encodes a visual magnitude into a star record's byte.
+ * @param magnitude The visual magnitude.
+ * @return The encoded magnitude, clamped to the representable range.
+ */
+unsigned char encodeStarMagnitude(float magnitude)
+{
+  float value = floorf((magnitude - STAR_MAGNITUDE_MIN) / STAR_MAGNITUDE_STEP + 0.5f);
+  return (unsigned char)std::min(std::max(value, 0.0f), 255.0f);
+};
+
+/**
+ * @brief Decodes the visual magnitude of a star record.
+ * @param magnitude The encoded magnitude.
+ * @return The visual magnitude.
+ */
+float decodeStarMagnitude(unsigned char magnitude)
+{
+  return STAR_MAGNITUDE_MIN + magnitude * STAR_MAGNITUDE_STEP;
+};
+
+/**
+ * @brief Converts a B-V color index to an sRGB color.
+ * @param colorIndex The B-V color index.
+ * @param color The array that receives the red, green and blue components.
+ *
+ * The index is converted to an effective temperature (Ballesteros), whose
+ * black-body color is approximated by fitted curves.
+ */
+static void colorFromIndex(float colorIndex, unsigned char color[3])
+{
+  double bv = std::min(std::max((double)colorIndex, -0.4), 2.0);
+  double temperature = 4600.0 * (1.0 / (0.92 * bv + 1.7) + 1.0 / (0.92 * bv + 0.62));
+  double t = temperature / 100.0;
+
+  double rgb[3];
+  rgb[0] = t <= 66.0 ? 255.0 : 329.698727446 * pow(t - 60.0, -0.1332047592);
+  rgb[1] = t <= 66.0 ? 99.4708025861 * log(t) - 161.1195681661 : 288.1221695283 * pow(t - 60.0, -0.0755148492);
+  rgb[2] = t >= 66.0 ? 255.0 : (t <= 19.0 ? 0.0 : 138.5177312231 * log(t - 10.0) - 305.0447927307);
+  for (int i = 0; i < 3; ++i)
+    color[i] = (unsigned char)std::min(std::max(rgb[i], 0.0), 255.0);
+};
+
+/**
+ * @brief Builds the record of a star from its equatorial direction.
+ * @param equatorial Unit vector in J2000 equatorial coordinates.
+ * @param magnitude Visual magnitude.
+ * @param colorIndex B-V color index.
+ * @return The star record.
+ *
+ * The direction is rotated to ecliptic coordinates, then mapped to the scene,
+ * where the ecliptic is the XZ plane and bodies orbit counterclockwise seen
+ * from +Y: ecliptic `(x, y, z)` becomes `(x, z, -y)`.
+ */
+static Star starFromEquatorial(const double equatorial[3], float magnitude, float colorIndex)
+{
+  double c = cos(OBLIQUITY);
+  double s = sin(OBLIQUITY);
+  double x = equatorial[0];
+  double y = c * equatorial[1] + s * equatorial[2];
+  double z = -s * equatorial[1] + c * equatorial[2];
+
+  Star star;
+  star.direction[0] = (float)x;
+  star.direction[1] = (float)z;
+  star.direction[2] = (float)-y;
+  colorFromIndex(colorIndex, star.color);
+  star.magnitude = encodeStarMagnitude(magnitude);
+  return star;
+};
+
+/**
+ * @brief Builds the record of a star from its equatorial coordinates.
+ * @param rightAscension J2000 right ascension, in degrees.
+ * @param declination J2000 declination, in degrees.
+ * @param magnitude Visual magnitude.
+ * @param colorIndex B-V color index.
+ * @return The star record.
+ */
+Star makeStar(double rightAscension, double declination, float magnitude, float colorIndex)
+{
+  double ra = rightAscension * 3.14159265358979 / 180.0;
+  double dec = declination * 3.14159265358979 / 180.0;
+  double equatorial[3] = {cos(dec) * cos(ra), cos(dec) * sin(ra), sin(dec)};
+  return starFromEquatorial(equatorial, magnitude, colorIndex);
+};
+
+/**
+ * @brief Returns the number of cells at a level.
+ * @param level The cell level.
+ * @return `6 * 4^level`.
+ */
+unsigned int starCellCount(int level)
+{
+  return 6u << (2 * level);
+};
+
+/**
+ * @brief Spreads the bits of a cell coordinate to the even bit positions.
+ * @param value A coordinate of at most 16 bits.
+ * @return The value with a zero bit inserted after every bit.
+ */
+static unsigned int spreadBits(unsigned int value)
+{
+  value &= 0xffff;
+  value = (value | (value << 8)) & 0x00ff00ff;
+  value = (value | (value << 4)) & 0x0f0f0f0f;
+  value = (value | (value << 2)) & 0x33333333;
+  value = (value | (value << 1)) & 0x55555555;
+  return value;
+};
+
+/**
+ * @brief Returns the cell containing a direction.
+ * @param direction A nonzero vector, in scene coordinates.
+ * @param level The cell level.
+ * @return The index of the cell.
+ *
+ * The direction is projected on the cube face of its largest component; the
+ * face coordinates are then warped by `atan` and quantized, and the cell is
+ * the Z-order interleaving of the quantized coordinates after the face.
+ */
+unsigned int starCell(const float direction[3], int level)
+{
+  double x = direction[0];
+  double y = direction[1];
+  double z = direction[2];
+  double ax = fabs(x);
+  double ay = fabs(y);
+  double az = fabs(z);
+
+  unsigned int face;
+  double a, b;
+  if (ax >= ay && ax >= az)
+  {
+    face = x > 0.0 ? 0 : 1;
+    a = (x > 0.0 ? -z : z) / ax;
+    b = y / ax;
+  }
+  else if (ay >= az)
+  {
+    face = y > 0.0 ? 2 : 3;
+    a = x / ay;
+    b = (y > 0.0 ? -z : z) / ay;
+  }
+  else
+  {
+    face = z > 0.0 ? 4 : 5;
+    a = (z > 0.0 ? x : -x) / az;
+    b = y / az;
+  }
+
+  unsigned int size = 1u << level;
+  double s = atan(a) * (4.0 / 3.14159265358979);
+  double t = atan(b) * (4.0 / 3.14159265358979);
+  unsigned int i = std::min((unsigned int)((s + 1.0) * 0.5 * size), size - 1);
+  unsigned int j = std::min((unsigned int)((t + 1.0) * 0.5 * size), size - 1);
+  return (face << (2 * level)) + (spreadBits(i) | (spreadBits(j) << 1));
+};
+
+/**
+ * @brief Returns the direction of a point of a cube face.
+ * @param face The face, from 0 to 5.
+ * @param s Horizontal coordinate on the face, from -1 to 1.
+ * @param t Vertical coordinate on the face, from -1 to 1.
+ * @param direction The array that receives the unit direction.
+ *
+ * This is the inverse of the projection done by `starCell`.
+ */
+void starFaceDirection(int face, double s, double t, float direction[3])
+{
+  double a = tan(s * (3.14159265358979 / 4.0));
+  double b = tan(t * (3.14159265358979 / 4.0));
+  double v[3];
+  switch (face)
+  {
+  case 0:
+    v[0] = 1.0, v[1] = b, v[2] = -a;
+    break;
+  case 1:
+    v[0] = -1.0, v[1] = b, v[2] = a;
+    break;
+  case 2:
+    v[0] = a, v[1] = 1.0, v[2] = -b;
+    break;
+  case 3:
+    v[0] = a, v[1] = -1.0, v[2] = b;
+    break;
+  case 4:
+    v[0] = a, v[1] = b, v[2] = 1.0;
+    break;
+  default:
+    v[0] = -a, v[1] = b, v[2] = -1.0;
+    break;
+  }
+  double length = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  for (int i = 0; i < 3; ++i)
+    direction[i] = (float)(v[i] / length);
+};
+
+/**
+ * @brief Draws the next number of a deterministic random sequence.
+ * @param state The state of the sequence.
+ * @return A number uniformly distributed in (0, 1].
+ */
+static double nextRandom(uint32_t &state)
+{
+  state = state * 1664525u + 1013904223u;
+  return ((state >> 8) + 1) * (1.0 / 16777216.0);
+};
+
+/**
+ * @brief Generates a procedural sky with a Milky Way band.
+ * @param count Number of stars to generate.
+ * @param seed Seed of the random sequence; the same seed gives the same sky.
+ * @param stars The vector that receives the stars.
+ *
+ * A star is either a disk star, placed at a galactic latitude drawn from a
+ * Laplace distribution that widens towards the bulge, or a halo star spread
+ * evenly over the sky. The share of disk stars grows with the magnitude.
+ */
+void generateStarfield(size_t count, unsigned int seed, std::vector<Star> &stars)
+{
+  const double degrees = 3.14159265358979 / 180.0;
+  double limit = 9.0 + 2.0 * log10((double)std::max(count, (size_t)1) / 120000.0);
+  uint32_t state = seed;
+
+  stars.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    double magnitude = std::max(limit + 2.0 * log10(nextRandom(state)), -1.5);
+    double diskShare = std::min(std::max(0.05 * (magnitude + 2.0), 0.0), 0.7);
+
+    double galactic[3];
+    if (nextRandom(state) < diskShare)
+    {
+      double l;
+      do
+        l = 360.0 * nextRandom(state) - 180.0;
+      while (nextRandom(state) > 0.35 + 0.65 * exp(-(l / 50.0) * (l / 50.0)));
+      double scale = 2.5 + 5.0 * exp(-(l / 20.0) * (l / 20.0));
+      double b = -scale * log(nextRandom(state)) * (nextRandom(state) < 0.5 ? -1.0 : 1.0);
+      b = std::min(std::max(b, -90.0), 90.0);
+      galactic[0] = cos(b * degrees) * cos(l * degrees);
+      galactic[1] = cos(b * degrees) * sin(l * degrees);
+      galactic[2] = sin(b * degrees);
+    }
+    else
+    {
+      double z = 2.0 * nextRandom(state) - 1.0;
+      double phi = 2.0 * 3.14159265358979 * nextRandom(state);
+      double r = sqrt(std::max(1.0 - z * z, 0.0));
+      galactic[0] = r * cos(phi);
+      galactic[1] = r * sin(phi);
+      galactic[2] = z;
+    }
+
+    double equatorial[3];
+    for (int row = 0; row < 3; ++row)
+      equatorial[row] = GALACTIC_TO_EQUATORIAL[row][0] * galactic[0] + GALACTIC_TO_EQUATORIAL[row][1] * galactic[1] +
+                        GALACTIC_TO_EQUATORIAL[row][2] * galactic[2];
+
+    double colorIndex = 0.65 + 0.7 * (nextRandom(state) + nextRandom(state) + nextRandom(state) - 1.5);
+    stars[i] = starFromEquatorial(equatorial, (float)magnitude, (float)colorIndex);
+  }
+};
+
+/**
+ * @brief Returns the whole-magnitude bucket of a magnitude.
+ * @param magnitude The magnitude.
+ * @return The bucket, which may lie outside `[0, STAR_MAGNITUDE_BUCKETS)`.
+ *
+ * Records and limits use the same expression, so a record is in a bucket
+ * below the limit's exactly when it is brighter than the bucket's start.
+ */
+static int magnitudeBucket(float magnitude)
+{
+  return (int)floorf(magnitude - STAR_MAGNITUDE_MIN);
+};
+
+/**
+ * @brief Chooses the cell level of a catalog.
+ * @param count Number of stars in the catalog.
+ * @return The shallowest level with at most 1024 stars per cell on average,
+ *         capped to `STAR_CELL_MAX_LEVEL`.
+ */
+int defaultStarCellLevel(size_t count)
+{
+  int level = 0;
+  while (level < STAR_CELL_MAX_LEVEL && count > 1024 * (size_t)starCellCount(level))
+    ++level;
+  return level;
+};
+
+/**
+ * @brief Returns the size of a catalog's magnitude table, padding included.
+ * @param cellCount Number of cells of the catalog.
+ * @return The size, in bytes, a multiple of 16.
+ */
+static size_t magnitudeTableSize(unsigned int cellCount)
+{
+  size_t bytes = ((size_t)cellCount * STAR_MAGNITUDE_BUCKETS + 1) * sizeof(uint32_t);
+  return (bytes + 15) & ~(size_t)15;
+};
+
+/**
+ * @brief Sorts stars and writes them to a catalog file.
+ * @param filename Path to the catalog file.
+ * @param stars The stars to write; they are sorted by cell, then from
+ *              brightest to faintest.
+ * @param level The cell level, from 0 to `STAR_CELL_MAX_LEVEL`.
+ * @return True if the file was written successfully.
+ *
+ * Stars are sorted on a 64-bit key made of their cell, their encoded
+ * magnitude and their original index, so stars of equal magnitude keep the
+ * order of the input.
+ */
+bool writeStarCatalog(const char *filename, std::vector<Star> &stars, int level)
+{
+  if (level < 0 || level > STAR_CELL_MAX_LEVEL)
+    return false;
+  unsigned int cellCount = starCellCount(level);
+
+  std::vector<uint64_t> keys(stars.size());
+  std::vector<uint32_t> starts((size_t)cellCount * STAR_MAGNITUDE_BUCKETS + 1, 0);
+  for (size_t i = 0; i < stars.size(); ++i)
+  {
+    uint64_t cell = starCell(stars[i].direction, level);
+    keys[i] = (cell << 40) | ((uint64_t)stars[i].magnitude << 32) | i;
+    int bucket = std::min(magnitudeBucket(decodeStarMagnitude(stars[i].magnitude)), STAR_MAGNITUDE_BUCKETS - 1);
+    ++starts[cell * STAR_MAGNITUDE_BUCKETS + bucket + 1];
+  }
+  std::sort(keys.begin(), keys.end());
+  for (size_t i = 1; i < starts.size(); ++i)
+    starts[i] += starts[i - 1];
+
+  std::vector<Star> sorted(stars.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    sorted[i] = stars[keys[i] & 0xffffffffu];
+  stars.swap(sorted);
+
+  std::ofstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  uint32_t header[3] = {STAR_CATALOG_VERSION, (uint32_t)stars.size(), (uint32_t)level};
+  file.write(STAR_CATALOG_MAGIC, sizeof(STAR_CATALOG_MAGIC));
+  file.write((const char *)header, sizeof(header));
+  std::vector<char> table(magnitudeTableSize(cellCount), 0);
+  memcpy(&table[0], &starts[0], starts.size() * sizeof(uint32_t));
+  file.write(&table[0], table.size());
+  if (!stars.empty())
+    file.write((const char *)&stars[0], stars.size() * sizeof(Star));
+  return (bool)file;
+};
+
+/**
+ * @brief Checks a catalog header against the size of its file.
+ * @param header The first `STAR_CATALOG_HEADER_SIZE` bytes of the file.
+ * @param fileSize Size of the file, in bytes.
+ * @param count Receives the number of records.
+ * @param level Receives the cell level.
+ * @return True if the header is valid and the file holds exactly its table and records.
+ */
+static bool checkStarCatalogHeader(const char *header, uint64_t fileSize, size_t &count, int &level)
+{
+  uint32_t words[3];
+  memcpy(words, header + sizeof(STAR_CATALOG_MAGIC), sizeof(words));
+  if (memcmp(header, STAR_CATALOG_MAGIC, sizeof(STAR_CATALOG_MAGIC)) != 0 || words[0] != STAR_CATALOG_VERSION ||
+      words[2] > STAR_CELL_MAX_LEVEL)
+    return false;
+  count = words[1];
+  level = (int)words[2];
+  return fileSize == STAR_CATALOG_HEADER_SIZE + magnitudeTableSize(starCellCount(level)) + (uint64_t)count * sizeof(Star);
+};
+
+/**
+ * @brief Checks that a magnitude table only holds ranges of a catalog's records.
+ * @param starts The magnitude table.
+ * @param cellCount Number of cells.
+ * @param count Number of records.
+ * @return True if the table never decreases and ends at @p count.
+ *
+ * The cell and magnitude ranges drawn from the table index the records
+ * unchecked, so a corrupt table must not get past the opening of the file.
+ */
+static bool checkMagnitudeTable(const uint32_t *starts, unsigned int cellCount, size_t count)
+{
+  size_t last = (size_t)cellCount * STAR_MAGNITUDE_BUCKETS;
+  for (size_t i = 0; i < last; ++i)
+  {
+    if (starts[i] > starts[i + 1])
+      return false;
+  }
+  return starts[last] == count;
+};
+
+/**
+ * @brief Opens a catalog file.
+ * @param filename Path to the catalog file.
+ * @param catalog The catalog that receives the records.
+ * @return True if the file exists and is a valid catalog of the current version.
+ *
+ * The file is opened with `openMappedFile`; where it is mapped, its pages are
+ * only loaded as the records are read, so opening a catalog of millions of
+ * stars does not copy it. The header is validated against the file size, so a
+ * truncated catalog is rejected, and the magnitude table against the number
+ * of records, so that every range it gives lies within the records. An open
+ * catalog must be closed before it is opened again.
+ */
+bool openStarCatalog(const char *filename, StarCatalog &catalog)
+{
+  catalog.stars = NULL;
+  catalog.count = 0;
+  catalog.magnitudeStarts = NULL;
+  size_t count = 0;
+  int level = 0;
+
+  if (!openMappedFile(filename, catalog.file))
+    return false;
+  const char *bytes = catalog.file.data;
+  if (catalog.file.size < STAR_CATALOG_HEADER_SIZE || !checkStarCatalogHeader(bytes, catalog.file.size, count, level))
+  {
+    closeMappedFile(catalog.file);
+    return false;
+  }
+  catalog.magnitudeStarts = (const uint32_t *)(bytes + STAR_CATALOG_HEADER_SIZE);
+  catalog.stars = count ? (const Star *)(bytes + STAR_CATALOG_HEADER_SIZE + magnitudeTableSize(starCellCount(level))) : NULL;
+
+  catalog.count = count;
+  catalog.level = level;
+  catalog.cellCount = starCellCount(level);
+  if (!checkMagnitudeTable(catalog.magnitudeStarts, catalog.cellCount, count))
+  {
+    closeStarCatalog(catalog);
+    return false;
+  }
+  return true;
+};
+
+/**
+ * @brief Releases the records of a catalog.
+ * @param catalog The catalog to close; it is left empty.
+ */
+void closeStarCatalog(StarCatalog &catalog)
+{
+  closeMappedFile(catalog.file);
+  catalog.stars = NULL;
+  catalog.count = 0;
+  catalog.level = 0;
+  catalog.cellCount = 0;
+  catalog.magnitudeStarts = NULL;
+};
+
+/**
+ * @brief Tells whether a record is brighter than a magnitude limit.
+ * @param star The record.
+ * @param magnitude The limit.
+ * @return True if the star's magnitude is below the limit.
+ */
+static bool starBrighterThan(const Star &star, float magnitude)
+{
+  return decodeStarMagnitude(star.magnitude) < magnitude;
+};
+
+/**
+ * @brief Returns the first record of a cell.
+ * @param catalog The catalog.
+ * @param cell The cell.
+ * @return The index of the cell's brightest star.
+ */
+size_t starCellBegin(const StarCatalog &catalog, unsigned int cell)
+{
+  return catalog.magnitudeStarts[(size_t)cell * STAR_MAGNITUDE_BUCKETS];
+};
+
+/**
+ * @brief Returns the end of the stars of a cell brighter than a magnitude.
+ * @param catalog The catalog.
+ * @param cell The cell.
+ * @param magnitude The magnitude limit.
+ * @return The index following the cell's last star whose magnitude is below
+ *         the limit.
+ *
+ * The magnitude table gives the whole magnitude the limit falls in; only the
+ * records of that magnitude are binary-searched, which touches a page or two
+ * of a mapped catalog.
+ */
+size_t starCellEnd(const StarCatalog &catalog, unsigned int cell, float magnitude)
+{
+  const uint32_t *starts = catalog.magnitudeStarts + (size_t)cell * STAR_MAGNITUDE_BUCKETS;
+  int bucket = magnitudeBucket(magnitude);
+  if (bucket < 0)
+    return starts[0];
+  if (bucket >= STAR_MAGNITUDE_BUCKETS)
+    return starts[STAR_MAGNITUDE_BUCKETS];
+  return (size_t)(std::lower_bound(catalog.stars + starts[bucket], catalog.stars + starts[bucket + 1], magnitude, starBrighterThan) - catalog.stars);
+};
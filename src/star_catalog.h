@@ -0,0 +1,220 @@
+/**
+ * @file star_catalog.h
+ * @brief Declares star catalogs, the asset format of the starfield.
+ *
+ * A star catalog stores every star as a 16-byte record holding its
+ * direction in scene coordinates, its color and its visual magnitude, in
+ * exactly the layout the renderer uploads to a vertex buffer. Catalogs are
+ * converted offline from text catalogs (Hipparcos, Gaia subsets) or generated
+ * procedurally by the `make_star_catalog` tool, and are memory-mapped at
+ * startup, so opening one costs the same whatever its size.
+ *
+ * The sky is divided into cells by projecting it on the six faces of a cube
+ * and splitting every face into `2^level` by `2^level` cells. Within a face,
+ * cells are numbered in Z-order, so the cells of any quadtree node of the
+ * face are consecutive. Records are grouped by cell and sorted from the
+ * brightest to the faintest star within each cell, and the catalog stores
+ * where every whole magnitude starts in every cell; any part of the sky down
+ * to any magnitude is therefore a set of contiguous record ranges.
+ *
+ * A catalog file starts with the 4-byte magic `SSTC`, followed by the
+ * version, the star count and the cell level as 32-bit unsigned integers in
+ * little-endian order. Then come the magnitude table, `STAR_MAGNITUDE_BUCKETS`
+ * record indices per cell and the total star count, padded to a multiple of
+ * 16 bytes, and the records.
+ */
+
+#ifndef STAR_CATALOG_H
+#define STAR_CATALOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "mapped_file.h"
+
+/**
+ * @def STAR_CATALOG
+ * @brief Path to the star catalog drawn as the background of the scene.
+ *
+ * The catalog is generated by the `make_star_catalog` tool and is not part of
+ * the sources.
+ */
+#define STAR_CATALOG "../assets/catalogs/stars.catalog"
+
+/**
+ * @def STAR_CATALOG_VERSION
+ * @brief Version of the catalog file format written by `writeStarCatalog`.
+ */
+#define STAR_CATALOG_VERSION 2
+
+/**
+ * @def STAR_MAGNITUDE_MIN
+ * @brief Visual magnitude encoded as 0 in a star record.
+ */
+#define STAR_MAGNITUDE_MIN -2.0f
+
+/**
+ * @def STAR_MAGNITUDE_STEP
+ * @brief Magnitude difference between consecutive encoded values.
+ *
+ * With 8 bits, magnitudes from -2 to 23.5 are stored, which covers the
+ * faintest Gaia stars.
+ */
+#define STAR_MAGNITUDE_STEP 0.1f
+
+/**
+ * @def STAR_MAGNITUDE_BUCKETS
+ * @brief Number of whole magnitudes indexed in every cell, from `STAR_MAGNITUDE_MIN` on.
+ */
+#define STAR_MAGNITUDE_BUCKETS 26
+
+/**
+ * @def STAR_CELL_MAX_LEVEL
+ * @brief Deepest cell level a catalog can use.
+ */
+#define STAR_CELL_MAX_LEVEL 6
+
+/**
+ * @struct Star
+ * @brief A star record, as stored in catalog files and vertex buffers.
+ */
+struct Star
+{
+  float direction[3];      ///< Unit vector pointing at the star, in scene coordinates (Y is the ecliptic north pole).
+  unsigned char color[3];  ///< sRGB color derived from the B-V color index.
+  unsigned char magnitude; ///< Visual magnitude, encoded by `encodeStarMagnitude`.
+};
+
+/**
+ * @struct StarCatalog
+ * @brief A star catalog opened for reading.
+ *
+ * The records and the magnitude table point into the contents of the
+ * opened file.
+ */
+struct StarCatalog
+{
+  const Star *stars;                  ///< Records grouped by cell, brightest first in each, or NULL for an empty catalog.
+  size_t count;                       ///< Number of records.
+  int level;                          ///< Cell level; every cube face has `4^level` cells.
+  unsigned int cellCount;             ///< Number of cells, `6 * 4^level`.
+  const uint32_t *magnitudeStarts;    ///< First record of every whole magnitude of every cell, then `count`.
+  MappedFile file;                    ///< Contents of the catalog file.
+};
+
+/**
+ * @brief Encodes a visual magnitude into a star record's byte.
+ * @param magnitude The visual magnitude.
+ * @return The encoded magnitude, clamped to the representable range.
+ */
+unsigned char encodeStarMagnitude(float magnitude);
+
+/**
+ * @brief Decodes the visual magnitude of a star record.
+ * @param magnitude The encoded magnitude.
+ * @return The visual magnitude.
+ */
+float decodeStarMagnitude(unsigned char magnitude);
+
+/**
+ * @brief Builds the record of a star from its equatorial coordinates.
+ * @param rightAscension J2000 right ascension, in degrees.
+ * @param declination J2000 declination, in degrees.
+ * @param magnitude Visual magnitude.
+ * @param colorIndex B-V color index.
+ * @return The star record.
+ */
+Star makeStar(double rightAscension, double declination, float magnitude, float colorIndex);
+
+/**
+ * @brief Returns the number of cells at a level.
+ * @param level The cell level.
+ * @return `6 * 4^level`.
+ */
+unsigned int starCellCount(int level);
+
+/**
+ * @brief Returns the cell containing a direction.
+ * @param direction A nonzero vector, in scene coordinates.
+ * @param level The cell level.
+ * @return The index of the cell.
+ */
+unsigned int starCell(const float direction[3], int level);
+
+/**
+ * @brief Returns the direction of a point of a cube face.
+ * @param face The face, from 0 to 5.
+ * @param s Horizontal coordinate on the face, from -1 to 1.
+ * @param t Vertical coordinate on the face, from -1 to 1.
+ * @param direction The array that receives the unit direction.
+ *
+ * Face coordinates are warped so that cells of the same level cover similar
+ * areas of the sky.
+ */
+void starFaceDirection(int face, double s, double t, float direction[3]);
+
+/**
+ * @brief Generates a procedural sky with a Milky Way band.
+ * @param count Number of stars to generate.
+ * @param seed Seed of the random sequence; the same seed gives the same sky.
+ * @param stars The vector that receives the stars.
+ *
+ * Magnitudes follow the growth of real star counts, about a factor of three
+ * per magnitude, down to the limit a real catalog of the same size reaches.
+ * Fainter stars concentrate more and more in the galactic plane and towards
+ * the galactic center, which draws the Milky Way.
+ */
+void generateStarfield(size_t count, unsigned int seed, std::vector<Star> &stars);
+
+/**
+ * @brief Chooses the cell level of a catalog.
+ * @param count Number of stars in the catalog.
+ * @return The shallowest level with at most 1024 stars per cell on average,
+ *         capped to `STAR_CELL_MAX_LEVEL`.
+ */
+int defaultStarCellLevel(size_t count);
+
+/**
+ * @brief Sorts stars and writes them to a catalog file.
+ * @param filename Path to the catalog file.
+ * @param stars The stars to write; they are sorted by cell, then from
+ *              brightest to faintest.
+ * @param level The cell level, from 0 to `STAR_CELL_MAX_LEVEL`.
+ * @return True if the file was written successfully.
+ */
+bool writeStarCatalog(const char *filename, std::vector<Star> &stars, int level);
+
+/**
+ * @brief Opens a catalog file.
+ * @param filename Path to the catalog file.
+ * @param catalog The catalog that receives the records.
+ * @return True if the file exists and is a valid catalog of the current version.
+ */
+bool openStarCatalog(const char *filename, StarCatalog &catalog);
+
+/**
+ * @brief Releases the records of a catalog.
+ * @param catalog The catalog to close; it is left empty.
+ */
+void closeStarCatalog(StarCatalog &catalog);
+
+/**
+ * @brief Returns the first record of a cell.
+ * @param catalog The catalog.
+ * @param cell The cell.
+ * @return The index of the cell's brightest star.
+ */
+size_t starCellBegin(const StarCatalog &catalog, unsigned int cell);
+
+/**
+ * @brief Returns the end of the stars of a cell brighter than a magnitude.
+ * @param catalog The catalog.
+ * @param cell The cell.
+ * @param magnitude The magnitude limit.
+ * @return The index following the cell's last star whose magnitude is below
+ *         the limit.
+ */
+size_t starCellEnd(const StarCatalog &catalog, unsigned int cell, float magnitude);
+
+#endif // STAR_CATALOG_H
@@ -0,0 +1,120 @@
+/**
+ * @file star_index.cpp
+ * @brief Implements the spatial index over the cells of a star catalog.
+ */
+
+#include "star_index.h"
+
+#include <cmath>
+
+#include "star_catalog.h"
+
+/**
+ * @brief Gathers the even bits of a Z-order code.
+ * @param code The code.
+ * @return The coordinate stored in the even bits.
+ */
+static unsigned int compactBits(unsigned int code)
+{
+  code &= 0x55555555;
+  code = (code | (code >> 1)) & 0x33333333;
+  code = (code | (code >> 2)) & 0x0f0f0f0f;
+  code = (code | (code >> 4)) & 0x00ff00ff;
+  code = (code | (code >> 8)) & 0x0000ffff;
+  return code;
+};
+
+/**
+ * @brief Computes the bounds of every node down to a cell level.
+ * @param index The index to build.
+ * @param level The cell level of the catalog.
+ *
+ * Node edges are great circle arcs, so the farthest point of a node from
+ * its center is one of its corners.
+ */
+void buildStarIndex(StarIndex &index, int level)
+{
+  index.level = level;
+  index.centers.clear();
+  index.radii.clear();
+  index.levelStarts.clear();
+
+  for (int k = 0; k <= level; ++k)
+  {
+    index.levelStarts.push_back((unsigned int)index.centers.size());
+    unsigned int size = 1u << k;
+    unsigned int faceNodes = size * size;
+    for (unsigned int node = 0; node < 6 * faceNodes; ++node)
+    {
+      int face = (int)(node / faceNodes);
+      unsigned int i = compactBits(node % faceNodes);
+      unsigned int j = compactBits((node % faceNodes) >> 1);
+      double s0 = 2.0 * i / size - 1.0;
+      double t0 = 2.0 * j / size - 1.0;
+      double step = 2.0 / size;
+
+      float center[3];
+      starFaceDirection(face, s0 + 0.5 * step, t0 + 0.5 * step, center);
+      float radius = 0.0f;
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        float point[3];
+        starFaceDirection(face, s0 + (corner & 1) * step, t0 + (corner >> 1) * step, point);
+        float dx = point[0] - center[0];
+        float dy = point[1] - center[1];
+        float dz = point[2] - center[2];
+        radius = fmaxf(radius, sqrtf(dx * dx + dy * dy + dz * dz));
+      }
+
+      Vec3 direction = {center[0], center[1], center[2]};
+      index.centers.push_back(direction);
+      index.radii.push_back(radius);
+    }
+  }
+};
+
+/**
+ * @brief Finds the cells that intersect a frustum.
+ * @param index The index; `index.cells` receives the cells.
+ * @param frustum The frustum, centered on the camera.
+ * @param radius Distance from the camera at which the stars are drawn.
+ * @return The number of cells found.
+ *
+ * Nodes are visited depth first, children in Z-order, so the cells come out
+ * sorted and the record ranges of neighboring cells follow each other.
+ * Stack entries hold the level of a node in their top 4 bits.
+ */
+size_t queryStarIndex(StarIndex &index, const Frustum &frustum, float radius)
+{
+  index.cells.clear();
+  index.stack.clear();
+  for (unsigned int face = 6; face-- > 0;)
+    index.stack.push_back(face);
+
+  while (!index.stack.empty())
+  {
+    unsigned int entry = index.stack.back();
+    index.stack.pop_back();
+    int k = (int)(entry >> 28);
+    unsigned int node = entry & 0x0fffffffu;
+
+    unsigned int bounds = index.levelStarts[k] + node;
+    const Vec3 &direction = index.centers[bounds];
+    Vec3 center = {direction.x * radius, direction.y * radius, direction.z * radius};
+    FrustumTest test = testSphere(frustum, center, index.radii[bounds] * radius);
+    if (test == FRUSTUM_OUTSIDE)
+      continue;
+
+    int depth = 2 * (index.level - k);
+    if (test == FRUSTUM_INSIDE || k == index.level)
+    {
+      for (unsigned int cell = node << depth; cell < (node + 1) << depth; ++cell)
+        index.cells.push_back(cell);
+      continue;
+    }
+
+    for (unsigned int child = 4; child-- > 0;)
+      index.stack.push_back(((unsigned int)(k + 1) << 28) | (node * 4 + child));
+  }
+  return index.cells.size();
+};
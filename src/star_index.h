@@ -0,0 +1,53 @@
+/**
+ * @file star_index.h
+ * @brief Declares the spatial index over the cells of a star catalog.
+ *
+ * The index is the quadtree formed by the cells of every cube face: a node
+ * of level `k` covers four nodes of level `k + 1`, down to the cells of the
+ * catalog. Every node is bounded by a sphere around the camera, so a query
+ * descends from the six faces and only visits the children of nodes that
+ * straddle the frustum; nodes entirely inside are accepted with all their
+ * cells at once. The query cost depends on the part of the sky in view, not
+ * on the number of stars.
+ */
+
+#ifndef STAR_INDEX_H
+#define STAR_INDEX_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "frustum.h"
+#include "transform.h"
+
+/**
+ * @struct StarIndex
+ * @brief Bounds of the quadtree nodes over the cells of a catalog.
+ */
+struct StarIndex
+{
+  int level;                             ///< Level of the leaves, which are the catalog cells.
+  std::vector<Vec3> centers;             ///< Unit direction to the center of every node, level after level.
+  std::vector<float> radii;              ///< Distance from the center to the farthest corner of every node, on the unit sphere.
+  std::vector<unsigned int> levelStarts; ///< Index of the first node of every level in `centers` and `radii`.
+  std::vector<unsigned int> stack;       ///< Nodes left to visit, reused from query to query.
+  std::vector<unsigned int> cells;       ///< Cells found by the last query, in increasing order.
+};
+
+/**
+ * @brief Computes the bounds of every node down to a cell level.
+ * @param index The index to build.
+ * @param level The cell level of the catalog.
+ */
+void buildStarIndex(StarIndex &index, int level);
+
+/**
+ * @brief Finds the cells that intersect a frustum.
+ * @param index The index; `index.cells` receives the cells.
+ * @param frustum The frustum, centered on the camera.
+ * @param radius Distance from the camera at which the stars are drawn.
+ * @return The number of cells found.
+ */
+size_t queryStarIndex(StarIndex &index, const Frustum &frustum, float radius);
+
+#endif // STAR_INDEX_H
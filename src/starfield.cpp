@@ -0,0 +1,253 @@
+/**
+ * @file starfield.cpp
+ * @brief Implements the starfield drawn behind the scene.
+ *
+ * Stars are drawn at `STARFIELD_RADIUS` around the camera with the rotation
+ * of the viewing matrix only, so they never get closer however the camera
+ * moves. The stars of the visible cells are drawn by one `glMultiDrawArrays`
+ * call with the core backend and one per magnitude with the legacy one;
+ * neither the query nor the calls depend on the size of the catalog.
+ */
+
+#include "starfield.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+#include "camera.h"
+#include "renderer.h"
+#include "shader.h"
+#include "shaders.h"
+
+/**
+ * @brief Returns the point size of a star.
+ * @param magnitude The visual magnitude of the star.
+ * @return The diameter of its point, in pixels.
+ *
+ * The size shrinks with the square root of the flux, from 6 pixels for the
+ * brightest stars to 1 pixel from magnitude 4 on. The core vertex shader
+ * computes the same size.
+ */
+float starPointSize(float magnitude)
+{
+  return std::min(std::max(4.0f * powf(10.0f, -0.2f * (magnitude - 1.0f)), 1.0f), 6.0f);
+};
+
+/**
+ * @brief Returns the brightness of a star.
+ * @param magnitude The visual magnitude of the star.
+ * @return The factor applied to its color, between 0 and 1.
+ *
+ * Stars up to magnitude 3 are drawn at full intensity; fainter ones fade
+ * with the square root of the flux, so that the many faint stars of large
+ * catalogs add up to a glow rather than disappear. The core vertex shader
+ * computes the same brightness.
+ */
+float starBrightness(float magnitude)
+{
+  return std::min(powf(10.0f, -0.2f * (magnitude - 3.0f)), 1.0f);
+};
+
+/**
+ * @brief Returns the faintest magnitude drawn at a camera distance.
+ * @param cameraDistance Distance of the camera from its target.
+ * @param minDistance Closest the camera may get to its target.
+ * @return The magnitude limit.
+ *
+ * Zooming in narrows nothing, since stars are at infinity, but it reveals
+ * fainter stars as a telescope would: the Hipparcos limit at the initial
+ * distance, the faintest Gaia stars at the closest one. The closest
+ * distance depends on the backend and the target, so the zoom in between is
+ * measured as a fraction of its range in log space.
+ */
+float starMagnitudeLimit(float cameraDistance, float minDistance)
+{
+  float initial = initialCameraState().distance;
+  if (cameraDistance >= initial || minDistance >= initial)
+    return STARFIELD_MAGNITUDE_LIMIT - 2.5f * log2f(cameraDistance / initial);
+  float zoom = log2f(initial / std::max(cameraDistance, minDistance)) / log2f(initial / minDistance);
+  return STARFIELD_MAGNITUDE_LIMIT + zoom * (STARFIELD_FAINTEST_MAGNITUDE - STARFIELD_MAGNITUDE_LIMIT);
+};
+
+/**
+ * @brief Opens a star catalog and uploads it for drawing.
+ * @param renderer The renderer being initialized; its backend must be set.
+ * @param filename Path to the catalog file.
+ * @return True if the catalog was loaded.
+ *
+ * The mapped records are copied to the vertex buffer as they are, and the
+ * bounds of the index are computed for the catalog's cell level. The
+ * catalog stays open for its magnitude table and for the binary searches of
+ * every frame.
+ */
+bool initStarfield(Renderer &renderer, const char *filename)
+{
+  Starfield &starfield = renderer.starfield;
+  starfield.vertexBuffer = 0;
+  starfield.vertexArray = 0;
+  starfield.program = 0;
+  starfield.count = 0;
+
+  if (!openStarCatalog(filename, starfield.catalog))
+  {
+    std::cerr << "Star catalog " << filename << " not found, drawing no stars" << std::endl;
+    return false;
+  }
+  if (!starfield.catalog.count)
+    return true;
+
+  if (renderer.backend == RENDERER_CORE)
+  {
+    starfield.program = loadShaderProgram(STAR_VERTEX_SHADER, STAR_FRAGMENT_SHADER);
+    if (!starfield.program)
+    {
+      closeStarCatalog(starfield.catalog);
+      return false;
+    }
+    GLuint frameBlock = glGetUniformBlockIndex(starfield.program, "Frame");
+    glUniformBlockBinding(starfield.program, frameBlock, FRAME_UNIFORM_BINDING);
+  }
+
+  buildStarIndex(starfield.index, starfield.catalog.level);
+  starfield.count = (GLsizei)starfield.catalog.count;
+  glGenBuffers(1, &starfield.vertexBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, starfield.vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, starfield.catalog.count * sizeof(Star), starfield.catalog.stars, GL_STATIC_DRAW);
+
+  if (renderer.backend == RENDERER_CORE)
+  {
+    GLsizei stride = sizeof(Star);
+    glGenVertexArrays(1, &starfield.vertexArray);
+    glBindVertexArray(starfield.vertexArray);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid *)offsetof(Star, direction));
+    glVertexAttribPointer(1, 3, GL_UNSIGNED_BYTE, GL_TRUE, stride, (const GLvoid *)offsetof(Star, color));
+    glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, stride, (const GLvoid *)offsetof(Star, magnitude));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  return true;
+};
+
+/**
+ * @brief Appends the stars of the visible cells within a magnitude range.
+ * @param starfield The starfield, whose index holds the visible cells.
+ * @param brightest Brightest magnitude of the range.
+ * @param faintest Faintest magnitude of the range, excluded.
+ * @return The number of stars appended to `starfield.firsts` and `starfield.counts`.
+ *
+ * Ranges of neighboring cells that follow each other in the buffer are
+ * merged, which happens whenever whole cells are drawn.
+ */
+static size_t gatherStars(Starfield &starfield, float brightest, float faintest)
+{
+  starfield.firsts.clear();
+  starfield.counts.clear();
+  size_t total = 0;
+  const std::vector<unsigned int> &cells = starfield.index.cells;
+  for (size_t i = 0; i < cells.size(); ++i)
+  {
+    size_t first = brightest > STAR_MAGNITUDE_MIN ? starCellEnd(starfield.catalog, cells[i], brightest) : starCellBegin(starfield.catalog, cells[i]);
+    size_t end = starCellEnd(starfield.catalog, cells[i], faintest);
+    if (end <= first)
+      continue;
+
+    if (!starfield.firsts.empty() && (size_t)(starfield.firsts.back() + starfield.counts.back()) == first)
+    {
+      starfield.counts.back() += (GLsizei)(end - first);
+    }
+    else
+    {
+      starfield.firsts.push_back((GLint)first);
+      starfield.counts.push_back((GLsizei)(end - first));
+    }
+    total += end - first;
+  }
+  return total;
+};
+
+/**
+ * @brief Draws the stars in view.
+ * @param renderer The renderer; `renderer.stats.stars` receives the number
+ *                 of stars drawn.
+ * @param view The viewing matrix of the frame.
+ * @param magnitudeLimit Faintest magnitude to draw.
+ *
+ * The cells in view are found with the frustum of the rotation-only view.
+ * Stars are added to the cleared framebuffer, so overlapping stars sum up
+ * like light does. The fixed-function pipeline cannot scale colors per
+ * vertex, so each whole magnitude is drawn with its brightness as the
+ * constant blend color.
+ */
+void drawStarfield(Renderer &renderer, const Mat4 &view, float magnitudeLimit)
+{
+  Starfield &starfield = renderer.starfield;
+  renderer.stats.stars = 0;
+  if (!starfield.count)
+    return;
+
+  Mat4 rotation = view;
+  rotation.m[12] = rotation.m[13] = rotation.m[14] = 0.0f;
+  Frustum frustum = extractFrustum(mat4Multiply(renderer.projection, rotation));
+  if (!queryStarIndex(starfield.index, frustum, STARFIELD_RADIUS))
+    return;
+
+  glDisable(GL_DEPTH_TEST);
+  glDepthMask(GL_FALSE);
+  glEnable(GL_BLEND);
+
+  if (renderer.backend == RENDERER_CORE)
+  {
+    renderer.stats.stars = (unsigned int)gatherStars(starfield, STAR_MAGNITUDE_MIN, magnitudeLimit);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glUseProgram(starfield.program);
+    glBindVertexArray(starfield.vertexArray);
+    if (!starfield.firsts.empty())
+      glMultiDrawArrays(GL_POINTS, &starfield.firsts[0], &starfield.counts[0], (GLsizei)starfield.firsts.size());
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+  }
+  else
+  {
+    Mat4 modelView = mat4Multiply(rotation, mat4Scale(STARFIELD_RADIUS));
+    glLoadMatrixf(modelView.m);
+
+    glDisable(GL_TEXTURE_2D);
+    glBlendFunc(GL_CONSTANT_COLOR, GL_ONE);
+    glBindBuffer(GL_ARRAY_BUFFER, starfield.vertexBuffer);
+    glVertexPointer(3, GL_FLOAT, sizeof(Star), (const GLvoid *)offsetof(Star, direction));
+    glColorPointer(3, GL_UNSIGNED_BYTE, sizeof(Star), (const GLvoid *)offsetof(Star, color));
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    for (float magnitude = STAR_MAGNITUDE_MIN; magnitude < magnitudeLimit; magnitude += 1.0f)
+    {
+      size_t stars = gatherStars(starfield, magnitude, std::min(magnitude + 1.0f, magnitudeLimit));
+      if (!stars)
+        continue;
+      renderer.stats.stars += (unsigned int)stars;
+      float brightness = starBrightness(magnitude + 0.5f);
+      glPointSize(starPointSize(magnitude + 0.5f));
+      glBlendColor(brightness, brightness, brightness, 1.0f);
+      glMultiDrawArrays(GL_POINTS, &starfield.firsts[0], &starfield.counts[0], (GLsizei)starfield.firsts.size());
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glPointSize(1.0f);
+    glEnable(GL_TEXTURE_2D);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+  }
+
+  glDisable(GL_BLEND);
+  glDepthMask(GL_TRUE);
+  glEnable(GL_DEPTH_TEST);
+};
@@ -0,0 +1,112 @@
+/**
+ * @file starfield.h
+ * @brief Declares the starfield drawn behind the scene.
+ *
+ * The starfield draws the stars of a catalog as points from one vertex
+ * buffer, which receives the catalog records unchanged. Every frame, the
+ * spatial index selects the cells in view, and only their stars brighter
+ * than a limit that deepens as the camera zooms in are drawn, as contiguous
+ * ranges of the buffer. Points are sized and dimmed according to the
+ * magnitude of their star: the core backend computes both per vertex, while
+ * the fixed-function pipeline draws the ranges of each whole magnitude
+ * separately.
+ */
+
+#ifndef STARFIELD_H
+#define STARFIELD_H
+
+#include <vector>
+
+#include "opengl.h"
+#include "star_catalog.h"
+#include "star_index.h"
+#include "transform.h"
+
+struct Renderer;
+
+/**
+ * @def STARFIELD_RADIUS
+ * @brief Distance from the camera at which stars are drawn.
+ *
+ * Stars only follow the rotation of the camera; the distance just has to lie
+ * between the near and far clipping planes.
+ */
+#define STARFIELD_RADIUS 100.0f
+
+/**
+ * @def STARFIELD_MAGNITUDE_LIMIT
+ * @brief Faintest magnitude drawn at the initial camera distance.
+ */
+#define STARFIELD_MAGNITUDE_LIMIT 9.0f
+
+/**
+ * @def STARFIELD_FAINTEST_MAGNITUDE
+ * @brief Faintest magnitude drawn at the closest camera distance, the limit
+ *        of the Gaia catalog.
+ */
+#define STARFIELD_FAINTEST_MAGNITUDE 21.0f
+
+/**
+ * @struct Starfield
+ * @brief Star catalog and OpenGL objects of the starfield.
+ */
+struct Starfield
+{
+  StarCatalog catalog;         ///< Catalog the vertex buffer was filled from.
+  StarIndex index;             ///< Quadtree over the cells of the catalog.
+  GLuint vertexBuffer;         ///< Star records, or 0 when no catalog is loaded.
+  GLuint vertexArray;          ///< Vertex array object of the core backend, or 0.
+  GLuint program;              ///< Point sprite program of the core backend, or 0.
+  GLsizei count;               ///< Number of stars in the vertex buffer.
+  std::vector<GLint> firsts;   ///< First star of every range drawn by the current call.
+  std::vector<GLsizei> counts; ///< Number of stars of every range drawn by the current call.
+};
+
+/**
+ * @brief Returns the point size of a star.
+ * @param magnitude The visual magnitude of the star.
+ * @return The diameter of its point, in pixels.
+ */
+float starPointSize(float magnitude);
+
+/**
+ * @brief Returns the brightness of a star.
+ * @param magnitude The visual magnitude of the star.
+ * @return The factor applied to its color, between 0 and 1.
+ */
+float starBrightness(float magnitude);
+
+/**
+ * @brief Returns the faintest magnitude drawn at a camera distance.
+ * @param cameraDistance Distance of the camera from its target.
+ * @param minDistance Closest the camera may get to its target.
+ * @return `STARFIELD_MAGNITUDE_LIMIT` at the initial distance and
+ *         `STARFIELD_FAINTEST_MAGNITUDE` at @p minDistance, linear in the
+ *         logarithm of the distance; 2.5 magnitudes brighter every time the
+ *         distance doubles beyond the initial one.
+ */
+float starMagnitudeLimit(float cameraDistance, float minDistance);
+
+/**
+ * @brief Opens a star catalog and uploads it for drawing.
+ * @param renderer The renderer being initialized; its backend must be set.
+ * @param filename Path to the catalog file.
+ * @return True if the catalog was loaded. Otherwise an error message is
+ *         printed to `std::cerr` and the scene is drawn without stars.
+ */
+bool initStarfield(Renderer &renderer, const char *filename);
+
+/**
+ * @brief Draws the stars in view.
+ * @param renderer The renderer; `renderer.stats.stars` receives the number
+ *                 of stars drawn.
+ * @param view The viewing matrix of the frame.
+ * @param magnitudeLimit Faintest magnitude to draw.
+ *
+ * This function must be called first in a frame, right after clearing: stars
+ * are drawn without depth testing and everything else is drawn over them.
+ * With the core backend, the frame uniforms must already be up to date.
+ */
+void drawStarfield(Renderer &renderer, const Mat4 &view, float magnitudeLimit);
+
+#endif // STARFIELD_H
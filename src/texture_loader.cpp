@@ -4,42 +4,138 @@
  *
  * This file provides the implementation of the `loadTexture` function,
  * which loads a texture from a file and generates an OpenGL texture object.
+ * Decoding and uploading are also exposed separately, so they can be timed
+ * and reused on their own.
  */
 
+/**
+ * @def STB_IMAGE_IMPLEMENTATION
+ * @brief Defines implementation of the STB image library.
+ *
+ * This macro should be defined exactly once in the project to include
+ * the implementation of the STB image functions.
+ */
+#define STB_IMAGE_IMPLEMENTATION
+
 #include "texture_loader.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 /**
- * @brief Loads a texture from a file and creates an OpenGL texture object.
- * @param filename Path to the texture file.
- * @return The OpenGL texture ID.
+ * @brief Decodes an image file into memory.
+ * @param filename Path to the image file.
+ * @param image The image that receives the decoded pixels.
+ * @param channels Number of channels to convert the pixels to, or 0 to keep
+ *                 the file's own.
+ * @return True if the image was decoded successfully.
  *
- * This function uses the STB image library to load an image from the specified file,
- * creates an OpenGL texture object, and sets its parameters. If the image fails to load,
- * an error message is printed to `std::cerr`.
+ * This function uses the STB image library to decode the file. On failure the
+ * image is left empty.
  */
-GLuint loadTexture(const char *filename)
+bool decodeImage(const char *filename, Image &image, int channels)
 {
-  GLuint textureID;
-  int width, height, nrChannels;
-
-  // Load image using STB image library
-  unsigned char *data = stbi_load(filename, &width, &height, &nrChannels, 0);
-  if (data)
+  image.data = stbi_load(filename, &image.width, &image.height, &image.channels, channels);
+  if (!image.data)
   {
-    // Generate and bind texture
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    image.width = image.height = image.channels = 0;
+    return false;
+  }
+  if (channels)
+    image.channels = channels;
+  return true;
+};
 
-    // Set texture parameters and upload texture data
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+/**
+ * @brief Releases the pixels of a decoded image.
+ * @param image The image to release.
+ */
+void freeImage(Image &image)
+{
+  if (image.data)
+    stbi_image_free(image.data);
+  image.data = NULL;
+};
+
+/**
+ * @brief Resamples an image to a new size with bilinear filtering.
+ * @param image The image to resample.
+ * @param width The width of the resampled image, in pixels.
+ * @param height The height of the resampled image, in pixels.
+ * @param resized The image that receives the resampled pixels.
+ * @return True if the image was resampled successfully.
+ *
+ * Pixel centers are mapped onto each other, so that the borders of the
+ * image stay aligned. The pixels are allocated with `malloc`, as stb_image
+ * does, so that `freeImage` can release them.
+ */
+bool resizeImage(const Image &image, int width, int height, Image &resized)
+{
+  resized.width = resized.height = resized.channels = 0;
+  resized.data = NULL;
+  if (!image.data || width <= 0 || height <= 0)
+    return false;
+
+  int channels = image.channels;
+  resized.data = (unsigned char *)malloc((size_t)width * height * channels);
+  if (!resized.data)
+    return false;
+  resized.width = width;
+  resized.height = height;
+  resized.channels = channels;
+
+  float scaleX = (float)image.width / (float)width;
+  float scaleY = (float)image.height / (float)height;
+  for (int y = 0; y < height; ++y)
+  {
+    float sourceY = std::min(std::max((y + 0.5f) * scaleY - 0.5f, 0.0f), (float)(image.height - 1));
+    int y0 = (int)sourceY;
+    int y1 = std::min(y0 + 1, image.height - 1);
+    float fy = sourceY - y0;
+    for (int x = 0; x < width; ++x)
+    {
+      float sourceX = std::min(std::max((x + 0.5f) * scaleX - 0.5f, 0.0f), (float)(image.width - 1));
+      int x0 = (int)sourceX;
+      int x1 = std::min(x0 + 1, image.width - 1);
+      float fx = sourceX - x0;
 
-    // Free image data
-    stbi_image_free(data);
+      const unsigned char *p00 = image.data + ((size_t)y0 * image.width + x0) * channels;
+      const unsigned char *p01 = image.data + ((size_t)y0 * image.width + x1) * channels;
+      const unsigned char *p10 = image.data + ((size_t)y1 * image.width + x0) * channels;
+      const unsigned char *p11 = image.data + ((size_t)y1 * image.width + x1) * channels;
+      unsigned char *out = resized.data + ((size_t)y * width + x) * channels;
+      for (int c = 0; c < channels; ++c)
+      {
+        float top = p00[c] + (p01[c] - p00[c]) * fx;
+        float bottom = p10[c] + (p11[c] - p10[c]) * fx;
+        out[c] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+      }
+    }
   }
-  else
+  return true;
+};
+
+/**
+ * @brief Uploads a decoded image to a new OpenGL texture.
+ * @param image The image to upload.
+ * @return The OpenGL texture ID.
+ *
+ * This function creates an OpenGL texture object, uploads the pixels with a
+ * format matching the image's channel count, generates mipmaps and sets the
+ * wrapping and filtering parameters.
+ */
+GLuint uploadTexture(const Image &image)
+{
+  GLuint textureID;
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D, textureID);
+
+  if (image.data)
   {
-    std::cerr << "Failed to load texture: " << filename << std::endl;
+    GLenum format = image.channels == 4 ? GL_RGBA : image.channels == 1 ? GL_LUMINANCE : GL_RGB;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.data);
+    glGenerateMipmap(GL_TEXTURE_2D);
   }
 
   // Set texture wrapping and filtering parameters
@@ -50,3 +146,23 @@ GLuint loadTexture(const char *filename)
 
   return textureID;
 };
+
+/**
+ * @brief Loads a texture from a file and creates an OpenGL texture object.
+ * @param filename Path to the texture file.
+ * @return The OpenGL texture ID.
+ *
+ * This function decodes the image with `decodeImage` and uploads it with
+ * `uploadTexture`. If the image fails to load, an error message is printed
+ * to `std::cerr` and an empty texture is returned.
+ */
+GLuint loadTexture(const char *filename)
+{
+  Image image;
+  if (!decodeImage(filename, image))
+    std::cerr << "Failed to load texture: " << filename << std::endl;
+
+  GLuint textureID = uploadTexture(image);
+  freeImage(image);
+  return textureID;
+};
@@ -9,24 +9,61 @@
 #ifndef TEXTURE_LOADER_H
 #define TEXTURE_LOADER_H
 
+#include "stb_image.h"
+
+#include "opengl.h"
+
+#include <iostream>
+
 /**
- * @def STB_IMAGE_IMPLEMENTATION
- * @brief Defines implementation of the STB image library.
+ * @struct Image
+ * @brief Decoded image pixels kept in CPU memory.
+ */
+struct Image
+{
+  int width;           ///< Width of the image, in pixels.
+  int height;          ///< Height of the image, in pixels.
+  int channels;        ///< Number of 8-bit channels per pixel.
+  unsigned char *data; ///< Pixel rows, top row first; owned by the image.
+};
+
+/**
+ * @brief Decodes an image file into memory.
+ * @param filename Path to the image file.
+ * @param image The image that receives the decoded pixels.
+ * @param channels Number of channels to convert the pixels to, or 0 to keep
+ *                 the file's own.
+ * @return True if the image was decoded successfully.
  *
- * This macro should be defined exactly once in the project to include
- * the implementation of the STB image functions.
+ * The decoded pixels must be released with `freeImage`.
  */
-#define STB_IMAGE_IMPLEMENTATION
+bool decodeImage(const char *filename, Image &image, int channels = 0);
 
-#include "stb_image.h"
+/**
+ * @brief Releases the pixels of a decoded image.
+ * @param image The image to release.
+ */
+void freeImage(Image &image);
 
-#ifdef __APPLE__
-#include <GLUT/glut.h>
-#else
-#include <GL/glut.h>
-#endif
+/**
+ * @brief Resamples an image to a new size with bilinear filtering.
+ * @param image The image to resample.
+ * @param width The width of the resampled image, in pixels.
+ * @param height The height of the resampled image, in pixels.
+ * @param resized The image that receives the resampled pixels, with the same
+ *                channel count; it must be released with `freeImage`.
+ * @return True if the image was resampled successfully.
+ */
+bool resizeImage(const Image &image, int width, int height, Image &resized);
 
-#include <iostream>
+/**
+ * @brief Uploads a decoded image to a new OpenGL texture.
+ * @param image The image to upload.
+ * @return The OpenGL texture ID.
+ *
+ * A current OpenGL context is required. Mipmaps are generated after upload.
+ */
+GLuint uploadTexture(const Image &image);
 
 /**
  * @brief Loads a texture from a file.
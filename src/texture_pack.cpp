@@ -0,0 +1,160 @@
+/**
+ * @file texture_pack.cpp
+ * @brief Implements texture packs.
+ */
+
+#include "texture_pack.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <stdint.h>
+
+#include "texture_loader.h"
+
+/**
+ * @var TEXTURE_PACK_MAGIC
+ * @brief First bytes of every pack file.
+ */
+static const char TEXTURE_PACK_MAGIC[4] = {'S', 'T', 'X', 'P'};
+
+/**
+ * @brief Decodes and resamples images into a texture pack.
+ * @param filenames Paths to the image files, one per layer.
+ * @param count Number of layers.
+ * @param width Width of every layer, in pixels.
+ * @param height Height of every layer, in pixels.
+ * @param pack The pack that receives the layers.
+ * @return True if every image was decoded.
+ */
+bool buildTexturePack(const char *const *filenames, int count, int width, int height, TexturePack &pack)
+{
+  int channels = 1;
+  for (int layer = 0; layer < count; ++layer)
+  {
+    int imageWidth, imageHeight, imageChannels;
+    if (stbi_info(filenames[layer], &imageWidth, &imageHeight, &imageChannels) && imageChannels > channels)
+      channels = imageChannels;
+  }
+
+  pack.width = width;
+  pack.height = height;
+  pack.layers = count;
+  pack.channels = channels;
+  size_t layerBytes = (size_t)width * height * channels;
+  pack.pixels.assign(layerBytes * count, 0);
+
+  bool complete = true;
+  for (int layer = 0; layer < count; ++layer)
+  {
+    Image image;
+    if (!decodeImage(filenames[layer], image, channels))
+    {
+      std::cerr << "Failed to load texture: " << filenames[layer] << std::endl;
+      complete = false;
+      continue;
+    }
+
+    Image resized = {0, 0, 0, NULL};
+    const Image *pixels = &image;
+    if ((image.width != width || image.height != height) && resizeImage(image, width, height, resized))
+      pixels = &resized;
+
+    if (pixels->width == width && pixels->height == height)
+      memcpy(&pack.pixels[layerBytes * layer], pixels->data, layerBytes);
+    else
+      complete = false;
+
+    freeImage(resized);
+    freeImage(image);
+  }
+  return complete;
+};
+
+/**
+ * @brief Writes a texture pack to a file.
+ * @param filename Path to the pack file.
+ * @param pack The pack to write.
+ * @return True if the file was written successfully.
+ */
+bool writeTexturePack(const char *filename, const TexturePack &pack)
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file)
+    return false;
+
+  uint32_t header[5] = {TEXTURE_PACK_VERSION, (uint32_t)pack.width, (uint32_t)pack.height, (uint32_t)pack.layers, (uint32_t)pack.channels};
+  file.write(TEXTURE_PACK_MAGIC, sizeof(TEXTURE_PACK_MAGIC));
+  file.write((const char *)header, sizeof(header));
+  if (!pack.pixels.empty())
+    file.write((const char *)&pack.pixels[0], pack.pixels.size());
+  return (bool)file;
+};
+
+/**
+ * @brief Reads a texture pack from a file.
+ * @param filename Path to the pack file.
+ * @param pack The pack that receives the layers.
+ * @return True if the file exists and is a valid pack of the current version.
+ *
+ * The header is validated against the file size before the pixels are read,
+ * so a truncated pack is rejected rather than uploaded partially.
+ */
+bool readTexturePack(const char *filename, TexturePack &pack)
+{
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file)
+    return false;
+  std::streamoff fileSize = file.tellg();
+  file.seekg(0);
+
+  char magic[4];
+  uint32_t header[5];
+  file.read(magic, sizeof(magic));
+  file.read((char *)header, sizeof(header));
+  if (!file || memcmp(magic, TEXTURE_PACK_MAGIC, sizeof(magic)) != 0 || header[0] != TEXTURE_PACK_VERSION)
+    return false;
+
+  uint64_t pixelBytes = (uint64_t)header[1] * header[2] * header[3] * header[4];
+  if (header[4] < 1 || header[4] > 4 || (uint64_t)fileSize != sizeof(magic) + sizeof(header) + pixelBytes)
+    return false;
+
+  pack.width = (int)header[1];
+  pack.height = (int)header[2];
+  pack.layers = (int)header[3];
+  pack.channels = (int)header[4];
+  pack.pixels.resize((size_t)pixelBytes);
+  if (pixelBytes)
+    file.read((char *)&pack.pixels[0], (std::streamsize)pixelBytes);
+  return (bool)file;
+};
+
+/**
+ * @brief Uploads a texture pack to a new array texture.
+ * @param pack The pack to upload.
+ * @return The OpenGL texture ID of the `GL_TEXTURE_2D_ARRAY`.
+ *
+ * Filtering and wrapping match `uploadTexture`; the layers are not
+ * mipmapped, as the minification filter does not use mipmaps.
+ */
+GLuint uploadTexturePack(const TexturePack &pack)
+{
+  static const GLenum formats[4] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+  static const GLenum internalFormats[4] = {GL_R8, GL_RG8, GL_RGB8, GL_RGBA8};
+
+  GLuint textureID;
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormats[pack.channels - 1], pack.width, pack.height, pack.layers, 0,
+               formats[pack.channels - 1], GL_UNSIGNED_BYTE, pack.pixels.empty() ? NULL : &pack.pixels[0]);
+
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+
+  return textureID;
+};
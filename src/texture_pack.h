@@ -0,0 +1,83 @@
+/**
+ * @file texture_pack.h
+ * @brief Declares texture packs, the asset format of texture arrays.
+ *
+ * A texture pack holds images resampled to one common size and channel
+ * count, stored one after the other so that the whole pack can be uploaded
+ * as the layers of a `GL_TEXTURE_2D_ARRAY` in a single call. Packs are built
+ * offline by the `pack_textures` tool; building one at startup is the
+ * fallback when no pack file is available.
+ *
+ * A pack file starts with the 4-byte magic `STXP`, followed by the version,
+ * width, height, layer count and channel count as 32-bit unsigned integers
+ * in little-endian order, then the pixel rows of every layer.
+ */
+
+#ifndef TEXTURE_PACK_H
+#define TEXTURE_PACK_H
+
+#include <vector>
+
+#include "opengl.h"
+
+/**
+ * @def TEXTURE_PACK_VERSION
+ * @brief Version of the pack file format written by `writeTexturePack`.
+ */
+#define TEXTURE_PACK_VERSION 1
+
+/**
+ * @struct TexturePack
+ * @brief Pixels of all layers of a texture array, kept in CPU memory.
+ */
+struct TexturePack
+{
+  int width;                         ///< Width of every layer, in pixels.
+  int height;                        ///< Height of every layer, in pixels.
+  int layers;                        ///< Number of layers.
+  int channels;                      ///< Number of 8-bit channels per pixel.
+  std::vector<unsigned char> pixels; ///< Pixel rows of every layer, top row first, layer after layer.
+};
+
+/**
+ * @brief Decodes and resamples images into a texture pack.
+ * @param filenames Paths to the image files, one per layer.
+ * @param count Number of layers.
+ * @param width Width of every layer, in pixels.
+ * @param height Height of every layer, in pixels.
+ * @param pack The pack that receives the layers.
+ * @return True if every image was decoded.
+ *
+ * The channel count of the pack is the largest one among the images; images
+ * with fewer channels are expanded when decoded. Layers whose image fails to
+ * load are left black and an error message is printed to `std::cerr`.
+ */
+bool buildTexturePack(const char *const *filenames, int count, int width, int height, TexturePack &pack);
+
+/**
+ * @brief Writes a texture pack to a file.
+ * @param filename Path to the pack file.
+ * @param pack The pack to write.
+ * @return True if the file was written successfully.
+ */
+bool writeTexturePack(const char *filename, const TexturePack &pack);
+
+/**
+ * @brief Reads a texture pack from a file.
+ * @param filename Path to the pack file.
+ * @param pack The pack that receives the layers.
+ * @return True if the file exists and is a valid pack of the current version.
+ */
+bool readTexturePack(const char *filename, TexturePack &pack);
+
+/**
+ * @brief Uploads a texture pack to a new array texture.
+ * @param pack The pack to upload.
+ * @return The OpenGL texture ID of the `GL_TEXTURE_2D_ARRAY`.
+ *
+ * All layers are uploaded by one `glTexImage3D` call. An OpenGL 3.0 context
+ * is required.
+ */
+GLuint uploadTexturePack(const TexturePack &pack);
+
+#endif // TEXTURE_PACK_H
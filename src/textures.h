@@ -69,4 +69,13 @@
  */
 #define NEPTUNE_TEXTURE "../assets/textures/neptune.jpg"
 
+/**
+ * @def BODY_TEXTURE_PACK
+ * @brief Path to the texture pack holding the surface of every body.
+ *
+ * The pack is generated from the textures above by the `pack_textures` tool
+ * and is not part of the sources.
+ */
+#define BODY_TEXTURE_PACK "../assets/packs/bodies.pack"
+
 #endif // TEXTURES_H
@@ -0,0 +1,203 @@
+/**
+ * @file transform.cpp
+ * @brief Implements vector and matrix math for scene transforms.
+ *
+ * This file provides the matrix builders declared in transform.h. Each one
+ * produces exactly the matrix its fixed-function counterpart would multiply
+ * onto the current OpenGL matrix stack.
+ */
+
+#include "transform.h"
+
+#include <cmath>
+
+/**
+ * @brief Returns the identity matrix.
+ * @return The 4x4 identity matrix.
+ */
+Mat4 mat4Identity()
+{
+  Mat4 r;
+  for (int i = 0; i < 16; ++i)
+    r.m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+  return r;
+};
+
+/**
+ * @brief Multiplies two matrices.
+ * @param a The left-hand matrix.
+ * @param b The right-hand matrix.
+ * @return The product `a * b`.
+ */
+Mat4 mat4Multiply(const Mat4 &a, const Mat4 &b)
+{
+  Mat4 r;
+  for (int col = 0; col < 4; ++col)
+  {
+    for (int row = 0; row < 4; ++row)
+    {
+      r.m[col * 4 + row] = a.m[0 * 4 + row] * b.m[col * 4 + 0] +
+                           a.m[1 * 4 + row] * b.m[col * 4 + 1] +
+                           a.m[2 * 4 + row] * b.m[col * 4 + 2] +
+                           a.m[3 * 4 + row] * b.m[col * 4 + 3];
+    }
+  }
+  return r;
+};
+
+/**
+ * @brief Builds a translation matrix.
+ * @param x, y, z The translation vector.
+ * @return The translation matrix.
+ */
+Mat4 mat4Translate(float x, float y, float z)
+{
+  Mat4 r = mat4Identity();
+  r.m[12] = x;
+  r.m[13] = y;
+  r.m[14] = z;
+  return r;
+};
+
+/**
+ * @brief Builds a uniform scale matrix.
+ * @param s The scale factor.
+ * @return The scale matrix.
+ */
+Mat4 mat4Scale(float s)
+{
+  return mat4Scale(s, s, s);
+};
+
+/**
+ * @brief Builds a non-uniform scale matrix.
+ * @param x, y, z The scale factor along each axis.
+ * @return The scale matrix.
+ */
+Mat4 mat4Scale(float x, float y, float z)
+{
+  Mat4 r = mat4Identity();
+  r.m[0] = x;
+  r.m[5] = y;
+  r.m[10] = z;
+  return r;
+};
+
+/**
+ * @brief Builds a rotation matrix.
+ * @param angle The rotation angle, in degrees.
+ * @param x, y, z The rotation axis.
+ * @return The rotation matrix, or the identity for a zero-length axis.
+ */
+Mat4 mat4Rotate(float angle, float x, float y, float z)
+{
+  Mat4 r = mat4Identity();
+  float length = sqrtf(x * x + y * y + z * z);
+  if (length == 0.0f)
+    return r;
+
+  x /= length;
+  y /= length;
+  z /= length;
+
+  float radians = angle * 3.14159265358979f / 180.0f;
+  float c = cosf(radians);
+  float s = sinf(radians);
+  float t = 1.0f - c;
+
+  r.m[0] = x * x * t + c;
+  r.m[1] = y * x * t + z * s;
+  r.m[2] = x * z * t - y * s;
+  r.m[4] = x * y * t - z * s;
+  r.m[5] = y * y * t + c;
+  r.m[6] = y * z * t + x * s;
+  r.m[8] = x * z * t + y * s;
+  r.m[9] = y * z * t - x * s;
+  r.m[10] = z * z * t + c;
+  return r;
+};
+
+/**
+ * @brief Builds a viewing matrix.
+ * @param eye The position of the camera.
+ * @param center The point the camera looks at.
+ * @param up The up direction of the camera.
+ * @return The viewing matrix.
+ */
+Mat4 mat4LookAt(const Vec3 &eye, const Vec3 &center, const Vec3 &up)
+{
+  float fx = center.x - eye.x;
+  float fy = center.y - eye.y;
+  float fz = center.z - eye.z;
+  float fl = sqrtf(fx * fx + fy * fy + fz * fz);
+  fx /= fl;
+  fy /= fl;
+  fz /= fl;
+
+  // side = forward x up
+  float sx = fy * up.z - fz * up.y;
+  float sy = fz * up.x - fx * up.z;
+  float sz = fx * up.y - fy * up.x;
+  float sl = sqrtf(sx * sx + sy * sy + sz * sz);
+  sx /= sl;
+  sy /= sl;
+  sz /= sl;
+
+  // recomputed up = side x forward
+  float ux = sy * fz - sz * fy;
+  float uy = sz * fx - sx * fz;
+  float uz = sx * fy - sy * fx;
+
+  Mat4 r = mat4Identity();
+  r.m[0] = sx;
+  r.m[4] = sy;
+  r.m[8] = sz;
+  r.m[1] = ux;
+  r.m[5] = uy;
+  r.m[9] = uz;
+  r.m[2] = -fx;
+  r.m[6] = -fy;
+  r.m[10] = -fz;
+  r.m[12] = -(sx * eye.x + sy * eye.y + sz * eye.z);
+  r.m[13] = -(ux * eye.x + uy * eye.y + uz * eye.z);
+  r.m[14] = fx * eye.x + fy * eye.y + fz * eye.z;
+  return r;
+};
+
+/**
+ * @brief Builds a perspective projection matrix.
+ * @param fovy The vertical field of view, in degrees.
+ * @param aspect The aspect ratio of the viewport.
+ * @param zNear Distance to the near clipping plane.
+ * @param zFar Distance to the far clipping plane.
+ * @return The projection matrix.
+ */
+Mat4 mat4Perspective(float fovy, float aspect, float zNear, float zFar)
+{
+  float f = 1.0f / tanf(fovy * 3.14159265358979f / 360.0f);
+
+  Mat4 r;
+  for (int i = 0; i < 16; ++i)
+    r.m[i] = 0.0f;
+  r.m[0] = f / aspect;
+  r.m[5] = f;
+  r.m[10] = (zFar + zNear) / (zNear - zFar);
+  r.m[11] = -1.0f;
+  r.m[14] = 2.0f * zFar * zNear / (zNear - zFar);
+  return r;
+};
+
+/**
+ * @brief Transforms a point by a matrix.
+ * @param m The transform matrix.
+ * @param p The point to transform.
+ * @return The transformed point, without perspective division.
+ */
+Vec3 mat4TransformPoint(const Mat4 &m, const Vec3 &p)
+{
+  Vec3 r;
+  r.x = m.m[0] * p.x + m.m[4] * p.y + m.m[8] * p.z + m.m[12];
+  r.y = m.m[1] * p.x + m.m[5] * p.y + m.m[9] * p.z + m.m[13];
+  r.z = m.m[2] * p.x + m.m[6] * p.y + m.m[10] * p.z + m.m[14];
+  return r;
+};
@@ -0,0 +1,116 @@
+/**
+ * @file transform.h
+ * @brief Provides vector and matrix math for scene transforms.
+ *
+ * This file declares a small column-major 4x4 matrix type and the functions
+ * that mirror the fixed-function transform calls (`glRotatef`,
+ * `glTranslatef`, `gluLookAt`, `gluPerspective`), so that transforms can be
+ * computed on the CPU and handed to OpenGL with a single `glLoadMatrixf`.
+ */
+
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+/**
+ * @struct Vec3
+ * @brief Three-component vector.
+ */
+struct Vec3
+{
+  float x; ///< X component.
+  float y; ///< Y component.
+  float z; ///< Z component.
+};
+
+/**
+ * @struct DVec3
+ * @brief Three-component vector in double precision, for world positions
+ *        that single precision cannot resolve.
+ */
+struct DVec3
+{
+  double x; ///< X component.
+  double y; ///< Y component.
+  double z; ///< Z component.
+};
+
+/**
+ * @struct Mat4
+ * @brief 4x4 matrix stored in column-major order, as expected by OpenGL.
+ */
+struct Mat4
+{
+  float m[16]; ///< Matrix elements, column-major.
+};
+
+/**
+ * @brief Returns the identity matrix.
+ * @return The 4x4 identity matrix.
+ */
+Mat4 mat4Identity();
+
+/**
+ * @brief Multiplies two matrices.
+ * @param a The left-hand matrix.
+ * @param b The right-hand matrix.
+ * @return The product `a * b`, which applies @p b first and then @p a.
+ */
+Mat4 mat4Multiply(const Mat4 &a, const Mat4 &b);
+
+/**
+ * @brief Builds a translation matrix.
+ * @param x, y, z The translation vector.
+ * @return The matrix produced by `glTranslatef(x, y, z)`.
+ */
+Mat4 mat4Translate(float x, float y, float z);
+
+/**
+ * @brief Builds a uniform scale matrix.
+ * @param s The scale factor.
+ * @return The matrix produced by `glScalef(s, s, s)`.
+ */
+Mat4 mat4Scale(float s);
+
+/**
+ * @brief Builds a non-uniform scale matrix.
+ * @param x, y, z The scale factor along each axis.
+ * @return The matrix produced by `glScalef(x, y, z)`.
+ */
+Mat4 mat4Scale(float x, float y, float z);
+
+/**
+ * @brief Builds a rotation matrix.
+ * @param angle The rotation angle, in degrees.
+ * @param x, y, z The rotation axis; it does not need to be normalized.
+ * @return The matrix produced by `glRotatef(angle, x, y, z)`.
+ */
+Mat4 mat4Rotate(float angle, float x, float y, float z);
+
+/**
+ * @brief Builds a viewing matrix.
+ * @param eye The position of the camera.
+ * @param center The point the camera looks at.
+ * @param up The up direction of the camera.
+ * @return The matrix produced by `gluLookAt`.
+ */
+Mat4 mat4LookAt(const Vec3 &eye, const Vec3 &center, const Vec3 &up);
+
+/**
+ * @brief Builds a perspective projection matrix.
+ * @param fovy The vertical field of view, in degrees.
+ * @param aspect The aspect ratio of the viewport (width / height).
+ * @param zNear Distance to the near clipping plane.
+ * @param zFar Distance to the far clipping plane.
+ * @return The matrix produced by `gluPerspective`.
+ */
+Mat4 mat4Perspective(float fovy, float aspect, float zNear, float zFar);
+
+/**
+ * @brief Transforms a point by a matrix.
+ * @param m The transform matrix.
+ * @param p The point to transform (with an implicit W of 1).
+ * @return The transformed point, without perspective division.
+ */
+Vec3 mat4TransformPoint(const Mat4 &m, const Vec3 &p);
+
+#endif // TRANSFORM_H
@@ -0,0 +1,138 @@
+/**
+ * @file make_star_catalog.cpp
+ * @brief Offline tool that converts or generates the star catalog.
+ *
+ * The tool either converts a text catalog to the binary catalog format read
+ * by the renderer, or generates a procedural sky with a Milky Way band when
+ * no text catalog is given.
+ *
+ * Usage: `make_star_catalog [output] [--csv file] [--stars count] [--seed seed] [--level level]`.
+ * The output defaults to `STAR_CATALOG`. A text catalog has one star per
+ * line with the J2000 right ascension and declination in degrees, the visual
+ * magnitude and the B-V color index, separated by commas; lines that do not
+ * start with a number, such as headers, are skipped, and a missing color
+ * index defaults to that of the Sun. This is the layout of a Hipparcos
+ * (I/239) or Gaia subset exported from VizieR with the columns `RAdeg`,
+ * `DEdeg`, `Vmag` and `B-V`. Without `--csv`, `--stars` procedural stars
+ * are generated, 120000 by default, which is the size of Hipparcos. The cell
+ * level of the spatial index defaults to `defaultStarCellLevel`.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "star_catalog.h"
+
+/**
+ * @brief Reads the stars of a text catalog.
+ * @param filename Path to the text catalog.
+ * @param stars The vector that receives the stars.
+ * @return True if the file was read.
+ */
+static bool readCsvCatalog(const char *filename, std::vector<Star> &stars)
+{
+  FILE *file = fopen(filename, "r");
+  if (!file)
+    return false;
+
+  char line[1024];
+  while (fgets(line, sizeof(line), file))
+  {
+    double values[4] = {0.0, 0.0, 0.0, 0.65};
+    int parsed = 0;
+    char *cursor = line;
+    while (parsed < 4)
+    {
+      char *end;
+      double value = strtod(cursor, &end);
+      if (end == cursor)
+        break;
+      values[parsed++] = value;
+      cursor = end;
+      while (*cursor == ' ' || *cursor == '\t')
+        ++cursor;
+      if (*cursor != ',' && *cursor != ';')
+        break;
+      ++cursor;
+    }
+    if (parsed >= 3)
+      stars.push_back(makeStar(values[0], values[1], (float)values[2], (float)values[3]));
+  }
+
+  fclose(file);
+  return true;
+};
+
+/**
+ * @brief Entry point of the star catalog tool.
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments.
+ * @return 0 if the catalog was written, 1 otherwise.
+ */
+int main(int argc, char **argv)
+{
+  const char *output = STAR_CATALOG;
+  const char *csv = NULL;
+  long count = 120000;
+  unsigned int seed = 1;
+  int level = -1;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+      csv = argv[++i];
+    else if (strcmp(argv[i], "--stars") == 0 && i + 1 < argc)
+      count = atol(argv[++i]);
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+      seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+      level = atoi(argv[++i]);
+    else if (argv[i][0] != '-')
+      output = argv[i];
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [output] [--csv file] [--stars count] [--seed seed] [--level level]" << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<Star> stars;
+  if (csv)
+  {
+    if (!readCsvCatalog(csv, stars))
+    {
+      std::cerr << "Failed to read star catalog: " << csv << std::endl;
+      return 1;
+    }
+  }
+  else
+  {
+    if (count < 0)
+    {
+      std::cerr << "Invalid star count " << count << std::endl;
+      return 1;
+    }
+    generateStarfield((size_t)count, seed, stars);
+  }
+
+  if (level < 0)
+    level = defaultStarCellLevel(stars.size());
+  if (level > STAR_CELL_MAX_LEVEL)
+  {
+    std::cerr << "Invalid cell level " << level << ", the deepest is " << STAR_CELL_MAX_LEVEL << std::endl;
+    return 1;
+  }
+
+  if (!writeStarCatalog(output, stars, level))
+  {
+    std::cerr << "Failed to write star catalog: " << output << std::endl;
+    return 1;
+  }
+
+  std::cout << "Wrote " << stars.size() << (csv ? " catalog" : " procedural") << " stars in "
+            << starCellCount(level) << " cells into " << output << std::endl;
+  return 0;
+};
@@ -0,0 +1,58 @@
+/**
+ * @file pack_textures.cpp
+ * @brief Offline tool that packs the body textures into a texture pack.
+ *
+ * The tool decodes the surface texture of every body in the `BODIES` table,
+ * resamples it to the layer size of the core renderer's texture array and
+ * writes the result as a texture pack, so that the renderer uploads every
+ * surface with one call instead of decoding and resampling at startup.
+ *
+ * Usage: `pack_textures [output] [width height]`. The output defaults to
+ * `BODY_TEXTURE_PACK` and the size to `BODY_TEXTURE_WIDTH` by
+ * `BODY_TEXTURE_HEIGHT`. Like the application, the tool resolves texture
+ * paths relative to the bin directory.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "bodies.h"
+#include "renderer.h"
+#include "texture_pack.h"
+#include "textures.h"
+
+/**
+ * @brief Entry point of the texture packing tool.
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments.
+ * @return 0 if the pack was written, 1 otherwise.
+ */
+int main(int argc, char **argv)
+{
+  const char *output = argc > 1 ? argv[1] : BODY_TEXTURE_PACK;
+  int width = argc > 3 ? atoi(argv[2]) : BODY_TEXTURE_WIDTH;
+  int height = argc > 3 ? atoi(argv[3]) : BODY_TEXTURE_HEIGHT;
+  if (width <= 0 || height <= 0)
+  {
+    std::cerr << "Invalid layer size " << width << "x" << height << std::endl;
+    return 1;
+  }
+
+  const char *paths[BODY_COUNT];
+  for (int i = 0; i < BODY_COUNT; ++i)
+    paths[i] = BODIES[i].texturePath;
+
+  TexturePack pack;
+  if (!buildTexturePack(paths, BODY_COUNT, width, height, pack))
+    return 1;
+
+  if (!writeTexturePack(output, pack))
+  {
+    std::cerr << "Failed to write texture pack: " << output << std::endl;
+    return 1;
+  }
+
+  std::cout << "Packed " << pack.layers << " textures of " << width << "x" << height
+            << " with " << pack.channels << " channels into " << output << std::endl;
+  return 0;
+};